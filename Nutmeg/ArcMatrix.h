@@ -0,0 +1,321 @@
+#ifndef NUTMEG_ARCMATRIX_H
+#define NUTMEG_ARCMATRIX_H
+
+#include "Matrix.h"
+#include <utility>
+
+// Range of consecutive indices
+class IndexRange
+{
+    size_t _begin{0};
+    size_t _end{0};
+
+  public:
+    class Iterator
+    {
+        size_t _idx;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = size_t;
+
+        explicit Iterator(const size_t idx) : _idx(idx) {}
+        inline size_t operator*() const { return _idx; }
+        inline Iterator& operator++() { ++_idx; return *this; }
+        inline Iterator operator++(int) { auto it = *this; ++_idx; return it; }
+        inline bool operator==(const Iterator& other) const { return _idx == other._idx; }
+        inline bool operator!=(const Iterator& other) const { return _idx != other._idx; }
+    };
+
+    // Constructors
+    IndexRange() = default;
+    IndexRange(const size_t begin, const size_t end) : _begin(begin), _end(end) {}
+
+    // Getters
+    inline size_t size() const { return _end - _begin; }
+    inline bool empty() const { return _begin == _end; }
+    inline size_t operator[](const size_t k) const { return _begin + k; }
+    inline Iterator begin() const { return Iterator(_begin); }
+    inline Iterator end() const { return Iterator(_end); }
+};
+
+// Arcs of a sparse directed graph in compressed sparse row form. The arcs are numbered in order of their
+// tail and then their head, so the outgoing arcs of a node are a contiguous range of arc indices. The
+// incoming arcs of a node are listed in order of their tail through a reverse index.
+class ArcSet
+{
+  public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  protected:
+    size_t _nb_nodes{0};
+    std::vector<size_t> _out_begin{0};
+    std::vector<size_t> _tail{};
+    std::vector<size_t> _head{};
+    std::vector<size_t> _in_begin{0};
+    std::vector<size_t> _in_arcs{};
+    std::vector<size_t> _in_tails{};
+
+  public:
+    // Constructors and destructors
+    ArcSet() = default;
+    ArcSet(const size_t nb_nodes, std::vector<std::pair<size_t, size_t>> arcs)
+    {
+        // Sort the arcs and remove duplicates.
+        std::sort(arcs.begin(), arcs.end());
+        arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+        // Create the forward adjacency.
+        _nb_nodes = nb_nodes;
+        _out_begin.assign(nb_nodes + 1, 0);
+        _tail.reserve(arcs.size());
+        _head.reserve(arcs.size());
+        for (const auto& [i, j] : arcs)
+        {
+            check_node(i);
+            check_node(j);
+            ++_out_begin[i + 1];
+            _tail.push_back(i);
+            _head.push_back(j);
+        }
+        for (size_t i = 0; i < nb_nodes; ++i)
+            _out_begin[i + 1] += _out_begin[i];
+
+        // Create the reverse adjacency.
+        make_reverse_index();
+    }
+    explicit ArcSet(const Matrix<bool>& is_arc)
+    {
+        // Check.
+        if (is_arc.rows() != is_arc.cols())
+        {
+            printf("Cannot create arcs from a %lux%lu matrix\n", is_arc.rows(), is_arc.cols());
+            std::abort();
+        }
+
+        // Create the forward adjacency.
+        _nb_nodes = is_arc.rows();
+        _out_begin.assign(_nb_nodes + 1, 0);
+        const auto nb_arcs = is_arc.count();
+        _tail.reserve(nb_arcs);
+        _head.reserve(nb_arcs);
+        for (size_t i = 0; i < _nb_nodes; ++i)
+        {
+            for (const auto j : is_arc.row_bits(i))
+            {
+                _tail.push_back(i);
+                _head.push_back(j);
+            }
+            _out_begin[i + 1] = _head.size();
+        }
+
+        // Create the reverse adjacency.
+        make_reverse_index();
+    }
+    ArcSet(const ArcSet& other) = default;
+    ArcSet(ArcSet&& other) = default;
+    ~ArcSet() = default;
+
+    // Assignment
+    ArcSet& operator=(const ArcSet& other) = default;
+    ArcSet& operator=(ArcSet&& other) = default;
+
+    // Getters
+    inline size_t nb_nodes() const { return _nb_nodes; }
+    inline size_t nb_arcs() const { return _head.size(); }
+    inline size_t tail(const size_t a) const { check_arc(a); return _tail[a]; }
+    inline size_t head(const size_t a) const { check_arc(a); return _head[a]; }
+
+    // Outgoing arcs of a node
+    inline IndexRange out_arcs(const size_t i) const
+    {
+        check_node(i);
+        return {_out_begin[i], _out_begin[i + 1]};
+    }
+    inline RowSpan<const size_t> out_heads(const size_t i) const
+    {
+        check_node(i);
+        return {_head.data() + _out_begin[i], _out_begin[i + 1] - _out_begin[i]};
+    }
+    inline size_t out_degree(const size_t i) const { return out_arcs(i).size(); }
+
+    // Incoming arcs of a node
+    inline RowSpan<const size_t> in_arcs(const size_t j) const
+    {
+        check_node(j);
+        return {_in_arcs.data() + _in_begin[j], _in_begin[j + 1] - _in_begin[j]};
+    }
+    inline RowSpan<const size_t> in_tails(const size_t j) const
+    {
+        check_node(j);
+        return {_in_tails.data() + _in_begin[j], _in_begin[j + 1] - _in_begin[j]};
+    }
+    inline size_t in_degree(const size_t j) const { return in_arcs(j).size(); }
+
+    // Find the index of an arc or npos if the arc does not exist
+    inline size_t find(const size_t i, const size_t j) const
+    {
+        const auto heads = out_heads(i);
+        const auto it = std::lower_bound(heads.begin(), heads.end(), j);
+        return it != heads.end() && *it == j ? _out_begin[i] + (it - heads.begin()) : npos;
+    }
+    inline bool contains(const size_t i, const size_t j) const { return find(i, j) != npos; }
+
+    // Comparison
+    inline bool operator==(const ArcSet& other) const
+    {
+        return _nb_nodes == other._nb_nodes && _out_begin == other._out_begin && _head == other._head;
+    }
+
+    // Memory usage in bytes
+    inline size_t memory() const
+    {
+        return sizeof(size_t) * (_out_begin.capacity() +
+                                 _tail.capacity() +
+                                 _head.capacity() +
+                                 _in_begin.capacity() +
+                                 _in_arcs.capacity() +
+                                 _in_tails.capacity());
+    }
+
+  private:
+    void make_reverse_index()
+    {
+        // Count the incoming arcs.
+        _in_begin.assign(_nb_nodes + 1, 0);
+        for (const auto j : _head)
+            ++_in_begin[j + 1];
+        for (size_t j = 0; j < _nb_nodes; ++j)
+            _in_begin[j + 1] += _in_begin[j];
+
+        // Place the arcs in order of their tail, which is the order of the arc indices.
+        _in_arcs.resize(_head.size());
+        _in_tails.resize(_head.size());
+        std::vector<size_t> next(_in_begin.begin(), _in_begin.end() - 1);
+        for (size_t a = 0; a < _head.size(); ++a)
+        {
+            const auto pos = next[_head[a]]++;
+            _in_arcs[pos] = a;
+            _in_tails[pos] = _tail[a];
+        }
+    }
+
+    inline void check_node(const size_t i) const
+    {
+#ifndef NDEBUG
+        if (i >= _nb_nodes)
+        {
+            printf("Node %lu is out of bounds\n", i);
+            std::abort();
+        }
+#else
+        static_cast<void>(i);
+#endif
+    }
+    inline void check_arc(const size_t a) const
+    {
+#ifndef NDEBUG
+        if (a >= nb_arcs())
+        {
+            printf("Arc %lu is out of bounds\n", a);
+            std::abort();
+        }
+#else
+        static_cast<void>(a);
+#endif
+    }
+};
+
+// Values indexed by the arcs of a sparse directed graph, which only stores one value per arc instead of
+// one per pair of nodes
+template<typename T>
+class ArcMatrix
+{
+  protected:
+    const ArcSet* _arcs{nullptr};
+    std::vector<T> _data{};
+
+  public:
+    // Constructors and destructors
+    // The matrix keeps a pointer to the arc set, which must outlive it
+    explicit ArcMatrix(const ArcSet& arcs, const T& value = T()) : _arcs(&arcs), _data(arcs.nb_arcs(), value) {}
+    explicit ArcMatrix(ArcSet&& arcs, const T& value = T()) = delete;
+    ArcMatrix() = default;
+    ArcMatrix(const ArcMatrix<T>& other) = default;
+    ArcMatrix(ArcMatrix<T>&& other) = default;
+    ~ArcMatrix() = default;
+
+    // Assignment
+    ArcMatrix<T>& operator=(const ArcMatrix<T>& other) = default;
+    ArcMatrix<T>& operator=(ArcMatrix<T>&& other) = default;
+
+    // Modifiers
+    void clear_and_resize(const ArcSet& arcs, const T& value = T())
+    {
+        _arcs = &arcs;
+        _data.assign(arcs.nb_arcs(), value);
+    }
+    void clear_and_resize(ArcSet&& arcs, const T& value = T()) = delete;
+
+    // Getters
+    inline const ArcSet& arcs() const { return *_arcs; }
+    inline size_t size() const { return _data.size(); }
+    inline T* data() { return _data.data(); }
+    inline const T* data() const { return _data.data(); }
+    inline T* begin() { return _data.data(); }
+    inline const T* begin() const { return _data.data(); }
+    inline T* end() { return _data.data() + _data.size(); }
+    inline const T* end() const { return _data.data() + _data.size(); }
+
+    // Value of an arc by index
+    inline T& operator[](const size_t a) { check_arc(a); return _data[a]; }
+    inline const T& operator[](const size_t a) const { check_arc(a); return _data[a]; }
+
+    // Value of an arc by its tail and head, which must exist
+    inline T& operator()(const size_t i, const size_t j) { return _data[find(i, j)]; }
+    inline const T& operator()(const size_t i, const size_t j) const { return _data[find(i, j)]; }
+
+    // Values of the outgoing arcs of a node
+    inline RowSpan<T> out(const size_t i)
+    {
+        const auto range = _arcs->out_arcs(i);
+        return {_data.data() + range[0], range.size()};
+    }
+    inline RowSpan<const T> out(const size_t i) const
+    {
+        const auto range = _arcs->out_arcs(i);
+        return {_data.data() + range[0], range.size()};
+    }
+
+    // Memory usage in bytes
+    inline size_t memory() const { return sizeof(T) * _data.capacity(); }
+
+  private:
+    inline size_t find(const size_t i, const size_t j) const
+    {
+        const auto a = _arcs->find(i, j);
+        if (a == ArcSet::npos)
+        {
+            printf("Arc (%lu,%lu) does not exist\n", i, j);
+            std::abort();
+        }
+        return a;
+    }
+    inline void check_arc(const size_t a) const
+    {
+#ifndef NDEBUG
+        if (a >= _data.size())
+        {
+            printf("Arc %lu is out of bounds\n", a);
+            std::abort();
+        }
+#else
+        static_cast<void>(a);
+#endif
+    }
+};
+
+#endif
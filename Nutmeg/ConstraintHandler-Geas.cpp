@@ -2,6 +2,8 @@
 
 #include "ConstraintHandler-Geas.h"
 #include "ProblemData.h"
+#include "Model.h"
+#include "Tracer.h"
 #include "scip/clock.h"
 #include "scip/cons_linear.h"
 #include "scip/cons_logicor.h"
@@ -11,6 +13,7 @@
 #define MAX_FRACTIONAL_CHECK_CONFLICTS                 300
 #define MAX_CUT_MINIMIZATION_DURATION                  0.3
 #define MAX_CUT_MINIMIZATION_CONFLICTS                 300
+#define NOGOOD_POOL_MAX_SIZE                       1000000 // most nogoods kept in the pool
 
 #define CONSHDLR_NAME                               "geas"
 #define CONSHDLR_DESC                      "CP subproblem"
@@ -150,6 +153,7 @@ bool make_bool_assumptions(
         {
             debugln("      {} (bool var {})", probdata.bool_vars_name_[idx], idx);
             const auto& cp_var = probdata.cp_bool_vars_[idx];
+            probdata.trace_.add_assumption({idx, false, SCIP_BOUNDTYPE_LOWER, 1});
             const auto success = cp.assume(cp_var);
             if (!success)
                 return false;
@@ -158,6 +162,7 @@ bool make_bool_assumptions(
         {
             debugln("      ~{} (bool var {})", probdata.bool_vars_name_[idx], idx);
             const auto& cp_var = probdata.cp_bool_vars_[idx];
+            probdata.trace_.add_assumption({idx, false, SCIP_BOUNDTYPE_UPPER, 0});
             const auto success = cp.assume(~cp_var);
             if (!success)
                 return false;
@@ -202,12 +207,14 @@ bool make_int_assumptions(
             const auto& cp_var = probdata.cp_int_vars_[idx];
             {
                 debugln("      [{} >= {}] (int var {})", probdata.int_vars_name_[idx], val_down, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_LOWER, static_cast<Int>(val_down)});
                 const auto success = cp.assume(cp_var >= val_down);
                 if (!success)
                     return false;
             }
             {
                 debugln("      [{} <= {}] (int var {})", probdata.int_vars_name_[idx], val_up, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_UPPER, static_cast<Int>(val_up)});
                 const auto success = cp.assume(cp_var <= val_up);
                 if (!success)
                     return false;
@@ -249,12 +256,14 @@ bool make_obj_assumptions(
             const auto& cp_var = probdata.cp_int_vars_[idx];
             {
                 debugln("      [{} >= {}] (int var {})", probdata.int_vars_name_[idx], val_down, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_LOWER, static_cast<Int>(val_down)});
                 const auto success = cp.assume(cp_var >= val_down);
                 if (!success)
                     return false;
             }
             {
                 debugln("      [{} <= {}] (int var {})", probdata.int_vars_name_[idx], val_up, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_UPPER, static_cast<Int>(val_up)});
                 const auto success = cp.assume(cp_var <= val_up);
                 if (!success)
                     return false;
@@ -266,7 +275,6 @@ bool make_obj_assumptions(
     return true;
 }
 
-static
 bool make_bounds_assumptions(
     SCIP* scip,               // SCIP
     ProblemData& probdata,    // Problem data
@@ -287,6 +295,7 @@ bool make_bounds_assumptions(
         {
             debugln("      {} (bool var {})", probdata.bool_vars_name_[idx], idx);
             const auto& cp_var = probdata.cp_bool_vars_[idx];
+            probdata.trace_.add_assumption({idx, false, SCIP_BOUNDTYPE_LOWER, 1});
             const auto success = cp.assume(cp_var);
             if (!success)
                 return false;
@@ -295,6 +304,7 @@ bool make_bounds_assumptions(
         {
             debugln("      ~{} (bool var {})", probdata.bool_vars_name_[idx], idx);
             const auto& cp_var = probdata.cp_bool_vars_[idx];
+            probdata.trace_.add_assumption({idx, false, SCIP_BOUNDTYPE_UPPER, 0});
             const auto success = cp.assume(~cp_var);
             if (!success)
                 return false;
@@ -315,6 +325,7 @@ bool make_bounds_assumptions(
             {
                 debugln("      [{} >= {}] (int var {})",
                         probdata.int_vars_name_[idx], lb, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_LOWER, static_cast<Int>(lb)});
                 const auto success = cp.assume(cp_var >= lb);
                 if (!success)
                     return false;
@@ -322,6 +333,7 @@ bool make_bounds_assumptions(
             {
                 debugln("      [{} <= {}] (int var {})",
                         probdata.int_vars_name_[idx], ub, idx);
+                probdata.trace_.add_assumption({idx, true, SCIP_BOUNDTYPE_UPPER, static_cast<Int>(ub)});
                 const auto success = cp.assume(cp_var <= ub);
                 if (!success)
                     return false;
@@ -373,6 +385,7 @@ NogoodData get_nogood(
                 nogood.vars.push_back(mip_var);
                 nogood.signs.push_back(SCIP_BOUNDTYPE_LOWER);
                 nogood.bounds.push_back(1);
+                nogood.literals.push_back({idx, false, SCIP_BOUNDTYPE_LOWER, 1});
 
                 goto NEXT_LITERAL;
             }
@@ -382,6 +395,7 @@ NogoodData get_nogood(
                 nogood.vars.push_back(mip_var);
                 nogood.signs.push_back(SCIP_BOUNDTYPE_UPPER);
                 nogood.bounds.push_back(0);
+                nogood.literals.push_back({idx, false, SCIP_BOUNDTYPE_UPPER, 0});
 
                 goto NEXT_LITERAL;
             }
@@ -401,6 +415,7 @@ NogoodData get_nogood(
                     nogood.vars.push_back(mip_var);
                     nogood.signs.push_back(SCIP_BOUNDTYPE_LOWER);
                     nogood.bounds.push_back(val);
+                    nogood.literals.push_back({idx, true, SCIP_BOUNDTYPE_LOWER, static_cast<Int>(val)});
 
                     nogood.all_binary = false;
                     goto NEXT_LITERAL;
@@ -417,6 +432,7 @@ NogoodData get_nogood(
                             nogood.vars.push_back(mip_var);
                             nogood.signs.push_back(SCIP_BOUNDTYPE_LOWER);
                             nogood.bounds.push_back(1);
+                            nogood.literals.push_back({ind_vars[val_idx], false, SCIP_BOUNDTYPE_LOWER, 1});
                         }
                     }
                     goto NEXT_LITERAL;
@@ -432,6 +448,7 @@ NogoodData get_nogood(
                     nogood.vars.push_back(mip_var);
                     nogood.signs.push_back(SCIP_BOUNDTYPE_UPPER);
                     nogood.bounds.push_back(val);
+                    nogood.literals.push_back({idx, true, SCIP_BOUNDTYPE_UPPER, static_cast<Int>(val)});
 
                     nogood.all_binary = false;
                     goto NEXT_LITERAL;
@@ -447,6 +464,7 @@ NogoodData get_nogood(
                             nogood.vars.push_back(mip_var);
                             nogood.signs.push_back(SCIP_BOUNDTYPE_LOWER);
                             nogood.bounds.push_back(1);
+                            nogood.literals.push_back({ind_vars[val_idx], false, SCIP_BOUNDTYPE_LOWER, 1});
                         }
                     }
                     goto NEXT_LITERAL;
@@ -477,7 +495,45 @@ Float get_time_remaining(
     return time_remaining;
 }
 
+// Record a call to the CP subproblem in the statistics, the trace and the tracer
+static
+void record_cp_call(
+    ProblemData& probdata,                   // Problem data
+    CallStatistics& stats,                   // Statistics of the callback
+    const TraceCallKind kind,                // Kind of call
+    const geas::solver::result cp_result,    // Result of the call
+    const Float time_limit,                  // Time limit of the call
+    const Int conflict_limit,                // Conflict limit of the call
+    const Float cp_time                      // Run time of the call
+)
+{
+    stats.add_cp_call(cp_result, cp_time);
+    probdata.trace_.set_result(get_trace_result(cp_result), time_limit, conflict_limit, cp_time);
+    Tracer::record(TracerEvent::CPCall,
+                   static_cast<uint8_t>(kind),
+                   static_cast<Int>(get_trace_result(cp_result)),
+                   cp_time);
+}
+
+// Solve the CP subproblem under the current assumptions and record the call
 static
+geas::solver::result solve_cp(
+    ProblemData& probdata,       // Problem data
+    CallStatistics& stats,       // Statistics of the callback
+    const TraceCallKind kind,    // Kind of call
+    const Float time_limit,      // Time limit
+    const Int conflict_limit     // Conflict limit, or 0 for no limit
+)
+{
+    debugln("   Calling Geas");
+    const auto start_time = clock();
+    const auto cp_result = probdata.cp_.solve(limits{.time = time_limit, .conflicts = conflict_limit});
+    const auto cp_time = get_elapsed_time(start_time);
+    record_cp_call(probdata, stats, kind, cp_result, time_limit, conflict_limit, cp_time);
+    debugln("   Geas run time = {:.3f}", cp_time);
+    return cp_result;
+}
+
 void store_cp_solution(
     ProblemData& probdata,    // Problem data
     geas::solver& cp          // CP solver
@@ -550,7 +606,6 @@ void inject_solution(
 }
 #endif
 
-static
 bool sol_is_fractional(
     SCIP* scip,              // SCIP
     SCIP_SOL* sol,           // Solution
@@ -608,6 +663,7 @@ void store_solution(
 #ifdef CHECK_AT_LP
         if (sol_is_fractional(scip, sol, probdata))
         {
+            probdata.timeline_.add_primal_bound(new_obj, BoundSource::CPHeuristic);
             inject_solution(scip, sol, probdata);
         }
 #endif
@@ -733,9 +789,13 @@ void minimize_cut(
 {
     // Make space to store result.
     geas::solver::result cp_result;
-#ifdef PRINT_DEBUG
     clock_t start_time;
-#endif
+
+    // Start timer.
+    auto& stats = probdata.stats_.minimize_cut;
+    ++stats.nb_calls;
+    const auto minimize_start_time = clock();
+    const auto original_size = conflict.size();
 
     // Determine which atoms are Boolean variables.
     Vector<bool> atom_is_bool_var(conflict.size());
@@ -770,15 +830,11 @@ void minimize_cut(
                 }
 
             // Solve.
-#ifdef PRINT_DEBUG
             start_time = clock();
-#endif
             cp_result = cp.solve(limits{.time = MAX_CUT_MINIMIZATION_DURATION,
                                         .conflicts = MAX_CUT_MINIMIZATION_CONFLICTS});
-#ifdef PRINT_DEBUG
-            debugln("      Cut minimization run time = {:.3f}",
-                    static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
+            stats.add_cp_call(cp_result, get_elapsed_time(start_time));
+            debugln("      Cut minimization run time = {:.3f}", get_elapsed_time(start_time));
 
             // Remove the literal.
             if (cp_result == geas::solver::UNSAT)
@@ -816,15 +872,11 @@ void minimize_cut(
                 }
 
             // Solve.
-#ifdef PRINT_DEBUG
             start_time = clock();
-#endif
             cp_result = cp.solve(limits{.time = MAX_CUT_MINIMIZATION_DURATION,
                                         .conflicts = MAX_CUT_MINIMIZATION_CONFLICTS});
-#ifdef PRINT_DEBUG
-            debugln("      Cut minimization run time = {:.3f}",
-                    static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
+            stats.add_cp_call(cp_result, get_elapsed_time(start_time));
+            debugln("      Cut minimization run time = {:.3f}", get_elapsed_time(start_time));
 
             // Remove the literal.
             if (cp_result == geas::solver::UNSAT)
@@ -844,6 +896,10 @@ void minimize_cut(
 #endif
             }
         }
+
+    // Stop timer.
+    stats.time += get_elapsed_time(minimize_start_time);
+    probdata.stats_.nb_minimized_literals += original_size - conflict.size();
 }
 #endif
 
@@ -888,10 +944,12 @@ SCIP_RETCODE geas_check(
     // Make assumptions.
     debugln("   Assumptions:");
     cp.clear_assumptions();
+    probdata.trace_.begin(TraceCallKind::Check);
     if (!make_bool_assumptions(scip, sol, probdata, cp) ||
         !make_int_assumptions(scip, sol, probdata, cp))
     {
         debugln("   Assumptions infeasible");
+        probdata.trace_.end();
         *result = SCIP_INFEASIBLE;
         return SCIP_OKAY;
     }
@@ -907,17 +965,8 @@ SCIP_RETCODE geas_check(
     }
 
     // Solve.
-    {
-#ifdef PRINT_DEBUG
-        debugln("   Calling Geas");
-        const auto start_time = clock();
-#endif
-        cp_result = cp.solve(limits{.time = time_remaining, .conflicts = 0});
-#ifdef PRINT_DEBUG
-        debugln("   Geas run time = {:.3f}",
-                static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
-    }
+    cp_result = solve_cp(probdata, probdata.stats_.check, TraceCallKind::Check, time_remaining, 0);
+    probdata.trace_.end();
 
     // Store solution or report infeasible (or timed out).
     if (cp_result == geas::solver::SAT)
@@ -977,6 +1026,7 @@ SCIP_RETCODE geas_separate(
         // Make assumptions.
         debugln("   Assumptions:");
         cp.clear_assumptions();
+        probdata.trace_.begin(TraceCallKind::SeparateBool);
         if (!make_bool_assumptions(scip, sol, probdata, cp))
         {
             debugln("   Assumptions infeasible");
@@ -1001,18 +1051,14 @@ SCIP_RETCODE geas_separate(
         }
 
         // Solve.
+        cp_result = solve_cp(probdata,
+                             probdata.stats_.separate_stages[0],
+                             TraceCallKind::SeparateBool,
+                             time_remaining,
+                             is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0);
+        if (cp_result != geas::solver::UNSAT)
         {
-#ifdef PRINT_DEBUG
-            debugln("   Calling Geas");
-            const auto start_time = clock();
-#endif
-            cp_result = cp.solve(
-                limits{.time = time_remaining,
-                       .conflicts = is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0});
-#ifdef PRINT_DEBUG
-            debugln("   Geas run time = {:.3f}",
-                    static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
+            probdata.trace_.end();
         }
     }
 
@@ -1022,6 +1068,7 @@ SCIP_RETCODE geas_separate(
         // Make additional assumptions.
         debugln("   Assumptions:");
         cp.clear_assumptions();
+        probdata.trace_.begin(TraceCallKind::SeparateObj);
         if (!make_bool_assumptions(scip, sol, probdata, cp) ||
             !make_obj_assumptions(scip, sol, probdata, cp))
         {
@@ -1047,18 +1094,14 @@ SCIP_RETCODE geas_separate(
         }
 
         // Solve.
+        cp_result = solve_cp(probdata,
+                             probdata.stats_.separate_stages[1],
+                             TraceCallKind::SeparateObj,
+                             time_remaining,
+                             is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0);
+        if (cp_result != geas::solver::UNSAT)
         {
-#ifdef PRINT_DEBUG
-            debugln("   Calling Geas");
-            const auto start_time = clock();
-#endif
-            cp_result = cp.solve(
-                limits{.time = time_remaining,
-                       .conflicts = is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0});
-#ifdef PRINT_DEBUG
-            debugln("   Geas run time = {:.3f}",
-                    static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
+            probdata.trace_.end();
         }
     }
 
@@ -1068,6 +1111,7 @@ SCIP_RETCODE geas_separate(
         // Make additional assumptions.
         debugln("   Assumptions:");
         cp.clear_assumptions();
+        probdata.trace_.begin(TraceCallKind::SeparateInt);
         if (!make_bool_assumptions(scip, sol, probdata, cp) ||
             !make_int_assumptions(scip, sol, probdata, cp))
         {
@@ -1093,18 +1137,14 @@ SCIP_RETCODE geas_separate(
         }
 
         // Solve.
+        cp_result = solve_cp(probdata,
+                             probdata.stats_.separate_stages[2],
+                             TraceCallKind::SeparateInt,
+                             time_remaining,
+                             is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0);
+        if (cp_result != geas::solver::UNSAT)
         {
-#ifdef PRINT_DEBUG
-            debugln("   Calling Geas");
-            const auto start_time = clock();
-#endif
-            cp_result = cp.solve(
-                limits{.time = time_remaining,
-                       .conflicts = is_fractional ? MAX_FRACTIONAL_CHECK_CONFLICTS : 0});
-#ifdef PRINT_DEBUG
-            debugln("   Geas run time = {:.3f}",
-                    static_cast<double>(clock() - start_time) / CLOCKS_PER_SEC);
-#endif
+            probdata.trace_.end();
         }
     }
 
@@ -1115,15 +1155,46 @@ SCIP_RETCODE geas_separate(
 
         // Make nogood.
         auto nogood = get_nogood(cp, probdata);
+        probdata.stats_.add_nogood_length(nogood.vars.size());
+        probdata.trace_.end(&nogood.literals);
 
         // If there is zero literals, the problem is infeasible.
         if (nogood.vars.size() == 0)
         {
+            ++probdata.stats_.nb_cutoffs;
+            Tracer::record(TracerEvent::Cutoff, 0, 0, probdata.cp_dual_bound_);
             scip_assert(SCIPinterruptSolve(scip));
             *result = SCIP_CUTOFF;
             return SCIP_OKAY;
         }
 
+        // Under memory pressure, create new cuts as dynamic and removable so that SCIP ages them out.
+        if (!probdata.memory_pressure_ && SCIPgetMemUsed(scip) > probdata.memory_soft_limit_)
+        {
+            println("Memory usage is approaching the limit, creating removable nogoods");
+            probdata.memory_pressure_ = true;
+        }
+
+        // Stop if the whole model, including the nogood pool and Geas, is over the memory limit.
+        if (!probdata.model_.check_memory_limit(probdata.memory_pressure_))
+        {
+            scip_assert(SCIPinterruptSolve(scip));
+        }
+
+        // Keep a copy of the nogood in terms of Nutmeg variables if a checkpoint, an export of cuts or dichotomic
+        // search reads the pool. Drop the oldest half of the pool when it is full.
+        if (probdata.record_nogoods_)
+        {
+            auto& pool = probdata.nogood_pool_;
+            if (pool.size() >= NOGOOD_POOL_MAX_SIZE)
+            {
+                const auto nb_dropped = pool.size() / 2;
+                pool.erase(pool.begin(), pool.begin() + nb_dropped);
+                probdata.stats_.nb_dropped_nogoods += nb_dropped;
+            }
+            pool.push_back(nogood.literals);
+        }
+
         // If there is one literal, enforce the bound change globally.
         if (nogood.vars.size() == 1)
         {
@@ -1143,7 +1214,9 @@ SCIP_RETCODE geas_separate(
                 {
                     if (SCIPisGT(scip, bound, SCIPvarGetUbLocal(var)))
                     {
+                        ++probdata.stats_.nb_cutoffs;
                         probdata.cp_dual_bound_ = bound;
+                        Tracer::record(TracerEvent::Cutoff, 0, 0, bound);
                         *result = SCIP_CUTOFF;
                         return SCIP_OKAY;
                     }
@@ -1159,6 +1232,13 @@ SCIP_RETCODE geas_separate(
             }
 
             // Reduced domain.
+            ++probdata.stats_.nb_bound_changes;
+            const auto& literal = nogood.literals[0];
+            Tracer::record(TracerEvent::BoundChange,
+                           literal.is_int_var,
+                           literal.var_idx,
+                           literal.sign == SCIP_BOUNDTYPE_UPPER,
+                           literal.bound);
             *result = SCIP_REDUCEDDOM;
             return SCIP_OKAY;
         }
@@ -1181,19 +1261,32 @@ SCIP_RETCODE geas_separate(
 
             // Add constraint.
             SCIP_CONS* cons = nullptr;
-            scip_assert(SCIPcreateConsBasicLogicor(scip,
-                                                   &cons,
+            scip_assert(SCIPcreateConsLogicor(scip,
+                                              &cons,
 #ifndef NDEBUG
-                                                   nogood.name.c_str(),
+                                              nogood.name.c_str(),
 #else
-                                                   "",
+                                              "",
 #endif
-                                                   nogood.vars.size(),
-                                                   nogood.vars.data()));
+                                              nogood.vars.size(),
+                                              nogood.vars.data(),
+                                              TRUE,
+                                              TRUE,
+                                              TRUE,
+                                              TRUE,
+                                              TRUE,
+                                              FALSE,
+                                              FALSE,
+                                              probdata.memory_pressure_,
+                                              probdata.memory_pressure_,
+                                              FALSE));
             debug_assert(cons);
             scip_assert(SCIPaddCons(scip, cons));
             scip_assert(SCIPreleaseCons(scip, &cons));
             debugln("   Adding nogood with only binary variables");
+            ++probdata.stats_.nb_logicor_cuts;
+            probdata.stats_.nb_removable_nogoods += probdata.memory_pressure_;
+            Tracer::record(TracerEvent::Nogood, 0, 0, 0, nogood.vars.size());
 
             // Created constraint.
             *result = SCIP_CONSADDED;
@@ -1203,21 +1296,34 @@ SCIP_RETCODE geas_separate(
         {
             // Add constraint.
             SCIP_CONS* cons = nullptr;
-            scip_assert(SCIPcreateConsBasicBounddisjunction(scip,
-                                                            &cons,
+            scip_assert(SCIPcreateConsBounddisjunction(scip,
+                                                       &cons,
 #ifndef NDEBUG
-                                                            nogood.name.c_str(),
+                                                       nogood.name.c_str(),
 #else
-                                                            "",
+                                                       "",
 #endif
-                                                            nogood.vars.size(),
-                                                            nogood.vars.data(),
-                                                            nogood.signs.data(),
-                                                            nogood.bounds.data()));
+                                                       nogood.vars.size(),
+                                                       nogood.vars.data(),
+                                                       nogood.signs.data(),
+                                                       nogood.bounds.data(),
+                                                       TRUE,
+                                                       TRUE,
+                                                       TRUE,
+                                                       TRUE,
+                                                       TRUE,
+                                                       FALSE,
+                                                       FALSE,
+                                                       probdata.memory_pressure_,
+                                                       probdata.memory_pressure_,
+                                                       FALSE));
             debug_assert(cons);
             scip_assert(SCIPaddCons(scip, cons));
             scip_assert(SCIPreleaseCons(scip, &cons));
             debugln("   Adding nogood with integer variables");
+            ++probdata.stats_.nb_bounddisjunction_cuts;
+            probdata.stats_.nb_removable_nogoods += probdata.memory_pressure_;
+            Tracer::record(TracerEvent::Nogood, 1, 0, 0, nogood.vars.size());
 
             // Created constraint.
             *result = SCIP_INFEASIBLE; // Stuck in infinite loop if returning CONSADDED
@@ -1277,20 +1383,35 @@ SCIP_RETCODE geas_propagate(
     int_vars_monitor.reset();
     debugln("   Assumptions:");
     cp.clear_assumptions();
+    probdata.trace_.begin(TraceCallKind::Propagate);
     if (!make_bounds_assumptions(scip, probdata, cp))
     {
         debugln("   Assumptions infeasible");
+        probdata.trace_.end();
         *result = SCIP_CUTOFF;
         return SCIP_OKAY;
     }
     debugln("   Assumptions completed");
 
     // Propagate.
-    if (!cp.is_consistent())
     {
-        debugln("   Propagation infeasible");
-        *result = SCIP_CUTOFF;
-        return SCIP_OKAY;
+        const auto start_time = clock();
+        const auto is_consistent = cp.is_consistent();
+        const auto cp_time = get_elapsed_time(start_time);
+        record_cp_call(probdata,
+                       probdata.stats_.propagate,
+                       TraceCallKind::Propagate,
+                       is_consistent ? geas::solver::SAT : geas::solver::UNSAT,
+                       0,
+                       0,
+                       cp_time);
+        probdata.trace_.end();
+        if (!is_consistent)
+        {
+            debugln("   Propagation infeasible");
+            *result = SCIP_CUTOFF;
+            return SCIP_OKAY;
+        }
     }
 
     // Propagate CP domain changes in the MIP.
@@ -1307,6 +1428,8 @@ SCIP_RETCODE geas_propagate(
         {
             debugln("   {} >= {}", probdata.bool_vars_name_[idx], bound);
             scip_assert(SCIPchgVarLb(scip, mip_var, bound));
+            ++probdata.stats_.propagate.nb_reductions;
+            Tracer::record(TracerEvent::BoundChange, 0, idx, 0, bound);
             *result = SCIP_REDUCEDDOM;
         }
     }
@@ -1322,6 +1445,8 @@ SCIP_RETCODE geas_propagate(
         {
             debugln("   {} <= {}", probdata.bool_vars_name_[idx], bound);
             scip_assert(SCIPchgVarUb(scip, mip_var, bound));
+            ++probdata.stats_.propagate.nb_reductions;
+            Tracer::record(TracerEvent::BoundChange, 0, idx, 1, bound);
             *result = SCIP_REDUCEDDOM;
         }
     }
@@ -1337,6 +1462,8 @@ SCIP_RETCODE geas_propagate(
         {
             debugln("   {} >= {}", probdata.int_vars_name_[idx], bound);
             scip_assert(SCIPchgVarLb(scip, mip_var, bound));
+            ++probdata.stats_.propagate.nb_reductions;
+            Tracer::record(TracerEvent::BoundChange, 1, idx, 0, bound);
             *result = SCIP_REDUCEDDOM;
         }
     }
@@ -1352,6 +1479,8 @@ SCIP_RETCODE geas_propagate(
         {
             debugln("   {} <= {}", probdata.int_vars_name_[idx], bound);
             scip_assert(SCIPchgVarUb(scip, mip_var, bound));
+            ++probdata.stats_.propagate.nb_reductions;
+            Tracer::record(TracerEvent::BoundChange, 1, idx, 1, bound);
             *result = SCIP_REDUCEDDOM;
         }
     }
@@ -1428,7 +1557,11 @@ SCIP_DECL_CONSCHECK(consCheckGeas)
 
     // Start checker.
     debug_assert(sol);
+    auto& stats = reinterpret_cast<ProblemData*>(SCIPgetProbData(scip))->stats_.check;
+    const auto start_time = clock();
     SCIP_CALL(geas_check(scip, sol, result));
+    ++stats.nb_calls;
+    stats.time += get_elapsed_time(start_time);
 
     // Done.
     return SCIP_OKAY;
@@ -1450,7 +1583,10 @@ SCIP_DECL_CONSENFOLP(consEnfolpGeas)
 
     // Start separator.
     auto& probdata = *reinterpret_cast<ProblemData*>(SCIPgetProbData(scip));
+    const auto start_time = clock();
     SCIP_CALL(geas_separate(scip, probdata, result));
+    ++probdata.stats_.separate.nb_calls;
+    probdata.stats_.separate.time += get_elapsed_time(start_time);
 
     // Done.
     return SCIP_OKAY;
@@ -1471,7 +1607,11 @@ SCIP_DECL_CONSENFOPS(consEnfopsGeas)
     *result = SCIP_FEASIBLE;
 
     // Start checker.
+    auto& stats = reinterpret_cast<ProblemData*>(SCIPgetProbData(scip))->stats_.check;
+    const auto start_time = clock();
     SCIP_CALL(geas_check(scip, nullptr, result));
+    ++stats.nb_calls;
+    stats.time += get_elapsed_time(start_time);
 
     // Done.
     return SCIP_OKAY;
@@ -1492,7 +1632,11 @@ SCIP_DECL_CONSPROP(consPropGeas)
     *result = SCIP_DIDNOTFIND;
 
     // Start propagator.
+    auto& stats = reinterpret_cast<ProblemData*>(SCIPgetProbData(scip))->stats_.propagate;
+    const auto start_time = clock();
     SCIP_CALL(geas_propagate(scip, result));
+    ++stats.nb_calls;
+    stats.time += get_elapsed_time(start_time);
 
     // Done.
     return SCIP_OKAY;
@@ -15,6 +15,7 @@ struct NogoodData
     Vector<SCIP_VAR*> vars;
     Vector<SCIP_BOUNDTYPE> signs;
     Vector<SCIP_Real> bounds;
+    Nogood literals;
     bool all_binary{true};
 #ifndef NDEBUG
     String name;
@@ -75,6 +76,23 @@ bool make_obj_assumptions(
     geas::solver& cp                  // CP solver
 );
 
+bool make_bounds_assumptions(
+    SCIP* scip,                       // SCIP
+    Nutmeg::ProblemData& probdata,    // Problem data
+    geas::solver& cp                  // CP solver
+);
+
+void store_cp_solution(
+    Nutmeg::ProblemData& probdata,    // Problem data
+    geas::solver& cp                  // CP solver
+);
+
+bool sol_is_fractional(
+    SCIP* scip,                       // SCIP
+    SCIP_SOL* sol,                    // Solution
+    Nutmeg::ProblemData& probdata     // Problem data
+);
+
 Nutmeg::NogoodData get_nogood(
     geas::solver& cp,                // CP solver
     Nutmeg::ProblemData& probdata    // Problem data
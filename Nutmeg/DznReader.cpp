@@ -0,0 +1,208 @@
+#include "DznReader.h"
+#include <algorithm>
+
+namespace Nutmeg
+{
+
+static inline
+bool is_identifier_start(
+    const char c    // Character
+)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline
+bool is_identifier_char(
+    const char c    // Character
+)
+{
+    return is_identifier_start(c) || (c >= '0' && c <= '9');
+}
+
+// Remove whitespace and comments at the end of a value
+static
+std::string_view trim_value(
+    std::string_view value    // Text of the value
+)
+{
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t' ||
+                              value.back() == '\n' || value.back() == '\r'))
+    {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+DznReader::DznReader(const String& path) :
+    path_(path),
+    file_(path),
+    values_()
+{
+    // Index the assignments.
+    auto p = file_.begin();
+    const auto end = file_.end();
+    while ((p = dzn_skip_whitespace(p, end)) != end)
+    {
+        // Read name.
+        const auto name_begin = p;
+        if (!is_identifier_start(*p))
+        {
+            parse_error("", p, "Expected the name of a parameter");
+        }
+        while (p != end && is_identifier_char(*p))
+        {
+            ++p;
+        }
+        const std::string_view name(name_begin, p - name_begin);
+
+        // Read equals sign.
+        p = dzn_skip_whitespace(p, end);
+        if (p == end || *p != '=')
+        {
+            parse_error(name, p, "Expected =");
+        }
+        p = dzn_skip_whitespace(p + 1, end);
+
+        // Find the end of the value, skipping semicolons inside strings and comments.
+        const auto value_begin = p;
+        while (p != end && *p != ';')
+        {
+            if (*p == '"')
+            {
+                ++p;
+                while (p != end && *p != '"')
+                {
+                    p += (*p == '\\' && p + 1 != end) ? 2 : 1;
+                }
+                if (p == end)
+                {
+                    parse_error(name, value_begin, "Unterminated string");
+                }
+                ++p;
+            }
+            else if (*p == '%')
+            {
+                p = dzn_skip_whitespace(p, end);
+            }
+            else
+            {
+                ++p;
+            }
+        }
+        if (p == end)
+        {
+            parse_error(name, value_begin, "Expected ;");
+        }
+        const auto value = trim_value(std::string_view(value_begin, p - value_begin));
+        ++p;
+
+        // Store.
+        const auto [it, inserted] = values_.emplace(name, value);
+        if (!inserted)
+        {
+            parse_error(name, name_begin, "Parameter is assigned twice");
+        }
+    }
+}
+
+bool DznReader::contains(const std::string_view name) const
+{
+    return values_.find(name) != values_.end();
+}
+
+std::string_view DznReader::get_value(const std::string_view name) const
+{
+    const auto it = values_.find(name);
+    release_assert(it != values_.end(), "Parameter {} is missing in {}", name, path_);
+    return it->second;
+}
+
+std::string_view DznReader::get_elements(const std::string_view name) const
+{
+    // Find the list of elements, skipping the index sets of array1d and array2d.
+    const auto value = get_value(name);
+    const auto begin = value.find('[');
+    const auto end = value.rfind(']');
+    if (begin == std::string_view::npos || end == std::string_view::npos || end < begin)
+    {
+        parse_error(name, value.data(), "Expected an array");
+    }
+    return value.substr(begin + 1, end - begin - 1);
+}
+
+Pair<size_t, size_t> DznReader::get_matrix_dimensions(const std::string_view name) const
+{
+    const auto value = get_value(name);
+    if (value.substr(0, 7) == "array2d")
+    {
+        // Read the dimensions from the index sets, as in array2d(1..m, 1..n, [...]).
+        Int bounds[4];
+        auto p = value.data() + 7;
+        const auto end = value.data() + value.size();
+        for (Int idx = 0; idx < 4; ++idx)
+        {
+            while (p != end && (*p < '0' || *p > '9') && *p != '-' && *p != '[')
+            {
+                ++p;
+            }
+            p = p != end && *p != '[' ? dzn_parse_element(p, end, bounds[idx]) : nullptr;
+            if (!p)
+            {
+                parse_error(name, value.data(), "Invalid index sets of array2d");
+            }
+        }
+        return {std::max(bounds[1] - bounds[0] + 1, 0), std::max(bounds[3] - bounds[2] + 1, 0)};
+    }
+    else
+    {
+        // Count the rows between bars and the elements, as in [| 1, 2 | 3, 4 |].
+        const auto elements = get_elements(name);
+        auto p = elements.data();
+        const auto end = p + elements.size();
+        size_t nb_bars = 0;
+        size_t nb_elements = 0;
+        while ((p = dzn_skip_whitespace(p, end)) != end)
+        {
+            if (*p == '|')
+            {
+                ++nb_bars;
+                ++p;
+            }
+            else if (*p == ',')
+            {
+                ++p;
+            }
+            else
+            {
+                ++nb_elements;
+                while (p != end && *p != ',' && *p != '|' && *p != '%' &&
+                       *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+                {
+                    ++p;
+                }
+            }
+        }
+        const auto rows = nb_bars >= 2 ? nb_bars - 1 : 0;
+        if (rows == 0 ? nb_elements != 0 : nb_elements % rows != 0)
+        {
+            parse_error(name, elements.data(), "Rows of the matrix have different lengths");
+        }
+        return {rows, rows == 0 ? 0 : nb_elements / rows};
+    }
+}
+
+void DznReader::parse_error(const std::string_view name, const char* position, const char* message) const
+{
+    const auto line = 1 + std::count(file_.begin(), std::min(position, file_.end()), '\n');
+    if (name.empty())
+    {
+        err("{} at line {} of {}", message, line, path_);
+    }
+    else
+    {
+        err("{} in parameter {} at line {} of {}", message, name, line, path_);
+    }
+}
+
+}
@@ -0,0 +1,226 @@
+#ifndef NUTMEG_DZNREADER_H
+#define NUTMEG_DZNREADER_H
+
+#include "Includes.h"
+#include "Matrix.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <string_view>
+
+namespace Nutmeg
+{
+
+// Reader of MiniZinc data files (.dzn). The file is memory-mapped and its assignments are indexed in
+// one pass. Values are parsed on request directly from the mapping into scalars, vectors and matrices
+// without creating intermediate strings. Supported values are integers, floats and Booleans, arrays
+// written as [...] or array1d(...) and matrices written as [|...|] or array2d(...).
+class DznReader
+{
+    String path_;
+    MappedFile file_;
+    HashTable<std::string_view, std::string_view> values_;
+
+  public:
+    // Constructors and destructors
+    explicit DznReader(const String& path);
+    DznReader(const DznReader&) = delete;
+    DznReader(DznReader&&) = delete;
+    DznReader& operator=(const DznReader&) = delete;
+    DznReader& operator=(DznReader&&) = delete;
+    ~DznReader() = default;
+
+    // Check if a parameter is assigned
+    bool contains(const std::string_view name) const;
+
+    // Read a scalar
+    template<class T>
+    T read_scalar(const std::string_view name) const;
+
+    // Read an array, optionally checking its size
+    template<class T>
+    Vector<T> read_array(const std::string_view name) const;
+    template<class T>
+    Vector<T> read_array(const std::string_view name, const size_t size) const;
+
+    // Read a matrix, optionally checking its dimensions
+    template<class T>
+    Matrix<T> read_matrix(const std::string_view name) const;
+    template<class T>
+    Matrix<T> read_matrix(const std::string_view name, const size_t rows, const size_t cols) const;
+
+  private:
+    // Get the text of a value
+    std::string_view get_value(const std::string_view name) const;
+    std::string_view get_elements(const std::string_view name) const;
+
+    // Get the dimensions of a matrix from its text
+    Pair<size_t, size_t> get_matrix_dimensions(const std::string_view name) const;
+
+    // Parse the elements of an array
+    template<class T, class Callback>
+    size_t parse_elements(const std::string_view name, Callback&& callback) const;
+
+    // Print an error with the line of the position and abort
+    [[noreturn]] void parse_error(const std::string_view name, const char* position, const char* message) const;
+};
+
+// Skip whitespace and comments
+inline const char* dzn_skip_whitespace(const char* p, const char* const end)
+{
+    while (p != end)
+    {
+        if (*p == '%')
+        {
+            while (p != end && *p != '\n')
+            {
+                ++p;
+            }
+        }
+        else if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+        {
+            ++p;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return p;
+}
+
+// Parse an element, returning the position after it or nullptr if the text is not a valid element
+template<class T>
+inline const char* dzn_parse_element(const char* p, const char* const end, T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        constexpr std::string_view true_str("true");
+        constexpr std::string_view false_str("false");
+        const std::string_view text(p, end - p);
+        if (text.substr(0, true_str.size()) == true_str)
+        {
+            value = true;
+            return p + true_str.size();
+        }
+        else if (text.substr(0, false_str.size()) == false_str)
+        {
+            value = false;
+            return p + false_str.size();
+        }
+        return nullptr;
+    }
+    else
+    {
+        if (p != end && *p == '+')
+        {
+            ++p;
+        }
+        const auto [ptr, ec] = std::from_chars(p, end, value);
+        return ec == std::errc() ? ptr : nullptr;
+    }
+}
+
+template<class T>
+T DznReader::read_scalar(const std::string_view name) const
+{
+    const auto value = get_value(name);
+    const auto end = value.data() + value.size();
+    T result{};
+    const auto p = dzn_parse_element(value.data(), end, result);
+    if (!p || dzn_skip_whitespace(p, end) != end)
+    {
+        parse_error(name, value.data(), "Invalid scalar");
+    }
+    return result;
+}
+
+template<class T, class Callback>
+size_t DznReader::parse_elements(const std::string_view name, Callback&& callback) const
+{
+    const auto elements = get_elements(name);
+    auto p = elements.data();
+    const auto end = p + elements.size();
+    size_t nb_elements = 0;
+    while (true)
+    {
+        // Skip separators.
+        while ((p = dzn_skip_whitespace(p, end)) != end && (*p == ',' || *p == '|'))
+        {
+            ++p;
+        }
+        if (p == end)
+        {
+            break;
+        }
+
+        // Parse element.
+        T value{};
+        const auto next = dzn_parse_element(p, end, value);
+        if (!next)
+        {
+            parse_error(name, p, "Invalid element");
+        }
+        callback(nb_elements, value);
+        ++nb_elements;
+        p = next;
+    }
+    return nb_elements;
+}
+
+template<class T>
+Vector<T> DznReader::read_array(const std::string_view name) const
+{
+    Vector<T> array;
+    parse_elements<T>(name, [&array](const size_t, const T value) { array.push_back(value); });
+    return array;
+}
+
+template<class T>
+Vector<T> DznReader::read_array(const std::string_view name, const size_t size) const
+{
+    Vector<T> array(size);
+    const auto nb_elements = parse_elements<T>(name, [&array, size](const size_t idx, const T value)
+    {
+        if (idx < size)
+        {
+            array[idx] = value;
+        }
+    });
+    release_assert(nb_elements == size,
+                   "Array {} in {} has {} elements instead of {}", name, path_, nb_elements, size);
+    return array;
+}
+
+template<class T>
+Matrix<T> DznReader::read_matrix(const std::string_view name) const
+{
+    const auto [rows, cols] = get_matrix_dimensions(name);
+    return read_matrix<T>(name, rows, cols);
+}
+
+template<class T>
+Matrix<T> DznReader::read_matrix(const std::string_view name, const size_t rows, const size_t cols) const
+{
+    Matrix<T> matrix(rows, cols);
+    size_t i = 0;
+    size_t j = 0;
+    const auto nb_elements = parse_elements<T>(name, [&](const size_t, const T value)
+    {
+        if (i < rows && cols > 0)
+        {
+            matrix(i, j) = value;
+            if (++j == cols)
+            {
+                j = 0;
+                ++i;
+            }
+        }
+    });
+    release_assert(nb_elements == rows * cols,
+                   "Matrix {} in {} has {} elements instead of {}x{}", name, path_, nb_elements, rows, cols);
+    return matrix;
+}
+
+}
+
+#endif
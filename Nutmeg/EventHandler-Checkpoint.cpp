@@ -0,0 +1,83 @@
+//#define PRINT_DEBUG
+
+#include "EventHandler-Checkpoint.h"
+#include "Model.h"
+
+#define EVENTHDLR_NAME         "checkpoint"
+#define EVENTHDLR_DESC         "event handler for periodically writing checkpoints"
+
+// Initialization method of event handler (called after problem was transformed)
+static
+SCIP_DECL_EVENTINIT(eventInitCheckpoint)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+
+    // Notify SCIP that your event handler wants to react on the event type node solved.
+    scip_assert(SCIPcatchEvent(scip, SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, NULL));
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Clean-up method of event handler (called before transformed problem is freed)
+static
+SCIP_DECL_EVENTEXIT(eventExitCheckpoint)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+
+    // Notify SCIP that your event handler wants to drop the event type node solved.
+    scip_assert(SCIPdropEvent(scip, SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, -1));
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Execution method of event handler
+static
+SCIP_DECL_EVENTEXEC(eventExecCheckpoint)
+{
+    // Check.
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+    debug_assert(event);
+    debug_assert(scip);
+    debug_assert(SCIPeventGetType(event) & SCIP_EVENTTYPE_NODESOLVED);
+
+    // Write checkpoint if the interval has elapsed.
+    auto model = reinterpret_cast<Nutmeg::Model*>(SCIPeventhdlrGetData(eventhdlr));
+    debug_assert(model);
+    if (model->checkpoint_is_due())
+    {
+        model->write_checkpoint();
+    }
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Include event handler for writing checkpoints
+SCIP_RETCODE Nutmeg::includeEventHdlrCheckpoint(SCIP* scip, Model* model)
+{
+    // Create event handler.
+    SCIP_EVENTHDLR* eventhdlr = nullptr;
+    scip_assert(SCIPincludeEventhdlrBasic(scip,
+                                          &eventhdlr,
+                                          EVENTHDLR_NAME,
+                                          EVENTHDLR_DESC,
+                                          eventExecCheckpoint,
+                                          reinterpret_cast<SCIP_EVENTHDLRDATA*>(model)));
+    debug_assert(eventhdlr);
+
+    /// Attach initialisation and clean-up functions.
+    scip_assert(SCIPsetEventhdlrInit(scip, eventhdlr, eventInitCheckpoint));
+    scip_assert(SCIPsetEventhdlrExit(scip, eventhdlr, eventExitCheckpoint));
+
+    // Exit.
+    return SCIP_OKAY;
+}
@@ -0,0 +1,16 @@
+#ifndef NUTMEG_EVENTHANDLER_CHECKPOINT_H
+#define NUTMEG_EVENTHANDLER_CHECKPOINT_H
+
+#include "Includes.h"
+#include "ProblemData.h"
+
+namespace Nutmeg
+{
+
+class Model;
+
+SCIP_RETCODE includeEventHdlrCheckpoint(SCIP* scip, Model* model);
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+//#define PRINT_DEBUG
+
+#include "EventHandler-Timeline.h"
+#include "Model.h"
+
+#define EVENTHDLR_NAME         "timeline"
+#define EVENTHDLR_DESC         "event handler for recording improvements to the primal and dual bounds"
+
+#define EVENTHDLR_EVENTTYPE    (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED)
+
+// Initialization method of event handler (called after problem was transformed)
+static
+SCIP_DECL_EVENTINIT(eventInitTimeline)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+
+    // Notify SCIP that your event handler wants to react on the event types best solution found and
+    // node solved.
+    scip_assert(SCIPcatchEvent(scip, EVENTHDLR_EVENTTYPE, eventhdlr, NULL, NULL));
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Clean-up method of event handler (called before transformed problem is freed)
+static
+SCIP_DECL_EVENTEXIT(eventExitTimeline)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+
+    // Notify SCIP that your event handler wants to drop the event types best solution found and node
+    // solved.
+    scip_assert(SCIPdropEvent(scip, EVENTHDLR_EVENTTYPE, eventhdlr, NULL, -1));
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Execution method of event handler
+static
+SCIP_DECL_EVENTEXEC(eventExecTimeline)
+{
+    // Check.
+    debug_assert(eventhdlr);
+    debug_assert(strcmp(SCIPeventhdlrGetName(eventhdlr), EVENTHDLR_NAME) == 0);
+    debug_assert(event);
+    debug_assert(scip);
+    debug_assert(SCIPeventGetType(event) & EVENTHDLR_EVENTTYPE);
+
+    // Get timeline.
+    auto model = reinterpret_cast<Nutmeg::Model*>(SCIPeventhdlrGetData(eventhdlr));
+    debug_assert(model);
+    auto& timeline = model->timeline();
+
+    // Record the new solution. Solutions injected by the CP checker are recorded by the constraint
+    // handler before SCIP reports them.
+    if (SCIPeventGetType(event) & SCIP_EVENTTYPE_BESTSOLFOUND)
+    {
+        auto sol = SCIPeventGetSol(event);
+        debug_assert(sol);
+        timeline.add_primal_bound(SCIPround(scip, SCIPgetSolOrigObj(scip, sol)),
+                                  SCIPsolGetHeur(sol) ?
+                                  Nutmeg::BoundSource::SCIPHeuristic :
+                                  Nutmeg::BoundSource::LPCheck);
+    }
+
+    // Record the dual bound.
+    const auto dual_bound = SCIPgetDualbound(scip);
+    if (!SCIPisInfinity(scip, std::abs(dual_bound)))
+    {
+        timeline.add_dual_bound(SCIPceil(scip, dual_bound), Nutmeg::BoundSource::Relaxation);
+    }
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Include event handler for recording the bounds
+SCIP_RETCODE Nutmeg::includeEventHdlrTimeline(SCIP* scip, Model* model)
+{
+    // Create event handler.
+    SCIP_EVENTHDLR* eventhdlr = nullptr;
+    scip_assert(SCIPincludeEventhdlrBasic(scip,
+                                          &eventhdlr,
+                                          EVENTHDLR_NAME,
+                                          EVENTHDLR_DESC,
+                                          eventExecTimeline,
+                                          reinterpret_cast<SCIP_EVENTHDLRDATA*>(model)));
+    debug_assert(eventhdlr);
+
+    /// Attach initialisation and clean-up functions.
+    scip_assert(SCIPsetEventhdlrInit(scip, eventhdlr, eventInitTimeline));
+    scip_assert(SCIPsetEventhdlrExit(scip, eventhdlr, eventExitTimeline));
+
+    // Exit.
+    return SCIP_OKAY;
+}
@@ -0,0 +1,16 @@
+#ifndef NUTMEG_EVENTHANDLER_TIMELINE_H
+#define NUTMEG_EVENTHANDLER_TIMELINE_H
+
+#include "Includes.h"
+#include "ProblemData.h"
+
+namespace Nutmeg
+{
+
+class Model;
+
+SCIP_RETCODE includeEventHdlrTimeline(SCIP* scip, Model* model);
+
+}
+
+#endif
@@ -0,0 +1,1373 @@
+//#define PRINT_DEBUG
+
+#include "FlatZinc.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <charconv>
+
+#define UNBOUNDED_INT_VAR_LB                     -1000000 // lower bound of an integer variable declared without bounds
+#define UNBOUNDED_INT_VAR_UB                      1000000 // upper bound of an integer variable declared without bounds
+
+namespace Nutmeg
+{
+
+// Type of a FlatZinc token
+enum class FlatZincToken : uint8_t
+{
+    End,
+    Identifier,
+    Int,
+    Float,
+    String,
+    Symbol
+};
+
+// Tokenizer reading a memory-mapped FlatZinc file one token at a time
+class FlatZincLexer
+{
+    const MappedFile& file_;
+    const String& path_;
+    const char* p_;
+
+  public:
+    // Current token
+    FlatZincToken type;
+    std::string_view text;
+    int64_t int_value;
+
+  public:
+    // Constructors and destructors
+    FlatZincLexer(const MappedFile& file, const String& path) :
+        file_(file),
+        path_(path),
+        p_(file.begin()),
+        type(FlatZincToken::End),
+        text(),
+        int_value(0)
+    {
+        next();
+    }
+
+    // Move to the next token
+    void next()
+    {
+        // Skip whitespace and comments.
+        const auto end = file_.end();
+        while (p_ != end)
+        {
+            if (*p_ == '%')
+            {
+                while (p_ != end && *p_ != '\n')
+                    ++p_;
+            }
+            else if (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')
+            {
+                ++p_;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        // Read token.
+        const auto begin = p_;
+        if (p_ == end)
+        {
+            type = FlatZincToken::End;
+            text = std::string_view();
+            return;
+        }
+        else if (is_identifier_start(*p_))
+        {
+            while (p_ != end && (is_identifier_start(*p_) || (*p_ >= '0' && *p_ <= '9')))
+                ++p_;
+            type = FlatZincToken::Identifier;
+        }
+        else if ((*p_ >= '0' && *p_ <= '9') || (*p_ == '-' && p_ + 1 != end && p_[1] >= '0' && p_[1] <= '9'))
+        {
+            const auto [ptr, ec] = std::from_chars(p_, end, int_value);
+            if (ec != std::errc())
+            {
+                error("Invalid integer");
+            }
+            p_ = ptr;
+            type = FlatZincToken::Int;
+
+            // Read the rest of a float, which is not followed by the dots of a range.
+            if (p_ != end && ((*p_ == '.' && p_ + 1 != end && p_[1] >= '0' && p_[1] <= '9') ||
+                              *p_ == 'e' || *p_ == 'E'))
+            {
+                double float_value;
+                const auto [float_ptr, float_ec] = std::from_chars(begin, end, float_value);
+                if (float_ec != std::errc())
+                {
+                    error("Invalid float");
+                }
+                p_ = float_ptr;
+                type = FlatZincToken::Float;
+            }
+        }
+        else if (*p_ == '"')
+        {
+            for (++p_; p_ != end && *p_ != '"'; ++p_)
+                if (*p_ == '\\' && p_ + 1 != end)
+                {
+                    ++p_;
+                }
+            if (p_ == end)
+            {
+                error("Unterminated string");
+            }
+            ++p_;
+            type = FlatZincToken::String;
+        }
+        else if (p_ + 1 != end && ((p_[0] == ':' && p_[1] == ':') || (p_[0] == '.' && p_[1] == '.')))
+        {
+            p_ += 2;
+            type = FlatZincToken::Symbol;
+        }
+        else if (std::string_view(";:,=()[]{}").find(*p_) != std::string_view::npos)
+        {
+            ++p_;
+            type = FlatZincToken::Symbol;
+        }
+        else
+        {
+            error(fmt::format("Unexpected character {}", *p_));
+        }
+        text = std::string_view(begin, p_ - begin);
+    }
+
+    // Check the current token
+    inline bool is_symbol(const std::string_view symbol) const
+    {
+        return type == FlatZincToken::Symbol && text == symbol;
+    }
+    inline bool is_identifier(const std::string_view name) const
+    {
+        return type == FlatZincToken::Identifier && text == name;
+    }
+
+    // Read the current token and move to the next token
+    void expect(const std::string_view symbol)
+    {
+        if (!is_symbol(symbol))
+        {
+            error(fmt::format("Expected {} but found {}", symbol, text));
+        }
+        next();
+    }
+    void expect_identifier(const std::string_view name)
+    {
+        if (!is_identifier(name))
+        {
+            error(fmt::format("Expected {} but found {}", name, text));
+        }
+        next();
+    }
+    std::string_view read_identifier()
+    {
+        if (type != FlatZincToken::Identifier)
+        {
+            error(fmt::format("Expected an identifier but found {}", text));
+        }
+        const auto name = text;
+        next();
+        return name;
+    }
+    Int read_int()
+    {
+        if (type != FlatZincToken::Int ||
+            int_value < std::numeric_limits<Int>::min() || int_value > std::numeric_limits<Int>::max())
+        {
+            error(fmt::format("Expected an integer but found {}", text));
+        }
+        const auto value = static_cast<Int>(int_value);
+        next();
+        return value;
+    }
+
+    // Print an error at the current token and abort
+    [[noreturn]] void error(const String& message) const
+    {
+        const auto line = 1 + std::count(file_.begin(), std::min(p_, file_.end()), '\n');
+        err("{} at line {} of {}", message, line, path_);
+    }
+
+  private:
+    static inline bool is_identifier_start(const char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+};
+
+static inline
+FlatZincValue make_int(
+    const Int value    // Value
+)
+{
+    FlatZincValue result;
+    result.type = FlatZincType::Int;
+    result.value = value;
+    return result;
+}
+
+static inline
+FlatZincValue make_bool(
+    const bool value    // Value
+)
+{
+    FlatZincValue result;
+    result.type = FlatZincType::Bool;
+    result.value = value;
+    return result;
+}
+
+FlatZincModel::FlatZincModel(Model& model) :
+    model_(model),
+    path_(),
+    vars_(),
+    arrays_(),
+    sets_(),
+    outputs_(),
+    objective_(Objective::Satisfy),
+    obj_value_(),
+    obj_var_(),
+    args_(),
+    nb_constraints_(0)
+{
+}
+
+void FlatZincModel::read(const String& path)
+{
+    // Map the file.
+    path_ = path;
+    const MappedFile file(path);
+    FlatZincLexer lexer(file, path_);
+
+    // Read items.
+    while (lexer.type != FlatZincToken::End)
+    {
+        if (lexer.is_identifier("predicate"))
+        {
+            // Skip predicate declarations.
+            while (lexer.type != FlatZincToken::End && !lexer.is_symbol(";"))
+            {
+                lexer.next();
+            }
+            lexer.expect(";");
+        }
+        else if (lexer.is_identifier("constraint"))
+        {
+            parse_constraint(lexer);
+        }
+        else if (lexer.is_identifier("solve"))
+        {
+            parse_solve(lexer);
+        }
+        else
+        {
+            parse_declaration(lexer);
+        }
+    }
+    debugln("Read {} constraints from {}", nb_constraints_, path_);
+
+    // Drop the symbol tables, whose names point into the file.
+    vars_.clear();
+    arrays_.clear();
+    sets_.clear();
+}
+
+void FlatZincModel::parse_declaration(FlatZincLexer& lexer)
+{
+    // Read the index set of an array.
+    bool is_array = false;
+    Int array_size = 0;
+    if (lexer.is_identifier("array"))
+    {
+        lexer.next();
+        lexer.expect("[");
+        const auto lb = lexer.read_int();
+        lexer.expect("..");
+        const auto ub = lexer.read_int();
+        lexer.expect("]");
+        lexer.expect_identifier("of");
+        is_array = true;
+        array_size = std::max(ub - lb + 1, 0);
+    }
+
+    // Read the type.
+    bool is_var = false;
+    if (lexer.is_identifier("var"))
+    {
+        lexer.next();
+        is_var = true;
+    }
+    auto type = FlatZincType::Int;
+    bool is_bounded = false;
+    Int lb = std::numeric_limits<Int>::min();
+    Int ub = std::numeric_limits<Int>::max();
+    Vector<Int> domain;
+    if (lexer.is_identifier("bool"))
+    {
+        lexer.next();
+        type = FlatZincType::Bool;
+    }
+    else if (lexer.is_identifier("int"))
+    {
+        lexer.next();
+    }
+    else if (lexer.is_identifier("float") || lexer.type == FlatZincToken::Float)
+    {
+        type = FlatZincType::Float;
+        lexer.next();
+        if (lexer.is_symbol(".."))
+        {
+            lexer.next();
+            lexer.next();
+        }
+    }
+    else if (lexer.is_identifier("set"))
+    {
+        lexer.next();
+        lexer.expect_identifier("of");
+        type = FlatZincType::Set;
+        if (lexer.is_identifier("int"))
+        {
+            lexer.next();
+        }
+        else
+        {
+            parse_value(lexer, nullptr);
+        }
+        if (is_var)
+        {
+            lexer.error("Set variables are not supported");
+        }
+    }
+    else
+    {
+        const auto set = parse_value(lexer, &domain);
+        if (set.type != FlatZincType::Set)
+        {
+            lexer.error("Expected a type");
+        }
+        is_bounded = true;
+        lb = set.value;
+        ub = set.set_ub;
+    }
+
+    // Read the name and annotations.
+    lexer.expect(":");
+    const auto name = lexer.read_identifier();
+    FlatZincOutput output{String(name), is_array, {}, {}};
+    const auto is_output = parse_annotations(lexer, &output);
+
+    // Read the assigned value.
+    FlatZincArg arg;
+    const auto is_assigned = lexer.is_symbol("=");
+    if (is_assigned)
+    {
+        lexer.next();
+        parse_arg(lexer, arg);
+        if (arg.is_array != is_array)
+        {
+            lexer.error(fmt::format("Value of {} has the wrong dimension", name));
+        }
+        if (is_array && static_cast<Int>(arg.array.size()) != array_size)
+        {
+            lexer.error(fmt::format("Array {} has {} elements instead of {}", name, arg.array.size(), array_size));
+        }
+    }
+    lexer.expect(";");
+
+    // Store parameters.
+    if (!is_var)
+    {
+        if (!is_assigned)
+        {
+            err("Parameter {} has no value in {}", name, path_);
+        }
+        if (is_array)
+        {
+            arrays_[name] = std::move(arg.array);
+        }
+        else if (type == FlatZincType::Set)
+        {
+            vars_[name] = arg.scalar;
+            sets_[name] = std::move(arg.set);
+        }
+        else
+        {
+            vars_[name] = arg.scalar;
+        }
+        return;
+    }
+    if (type == FlatZincType::Float)
+    {
+        err("Float variable {} is not supported in {}", name, path_);
+    }
+
+    // Create variables.
+    if (is_array)
+    {
+        if (!is_assigned)
+        {
+            err("Array of variables {} has no value in {}", name, path_);
+        }
+        if (is_output)
+        {
+            output.values = arg.array;
+            outputs_.push_back(std::move(output));
+        }
+        arrays_[name] = std::move(arg.array);
+    }
+    else
+    {
+        FlatZincValue var;
+        if (is_assigned)
+        {
+            // Alias an existing variable or a constant.
+            var = arg.scalar;
+            if (is_bounded)
+            {
+                post_domain(var, lb, ub, domain.empty() ? nullptr : &domain);
+            }
+        }
+        else if (type == FlatZincType::Bool)
+        {
+            var.type = FlatZincType::BoolVar;
+            var.bool_var = model_.add_bool_var(String(name));
+        }
+        else
+        {
+            if (!is_bounded)
+            {
+                lb = UNBOUNDED_INT_VAR_LB;
+                ub = UNBOUNDED_INT_VAR_UB;
+            }
+            var.type = FlatZincType::IntVar;
+            var.int_var = model_.add_int_var(lb, ub, true, String(name));
+            if (!domain.empty() && static_cast<int64_t>(domain.size()) < static_cast<int64_t>(ub) - lb + 1)
+            {
+                post_domain(var, lb, ub, &domain);
+            }
+        }
+        if (is_output)
+        {
+            output.values.push_back(var);
+            outputs_.push_back(std::move(output));
+        }
+        vars_[name] = var;
+    }
+}
+
+void FlatZincModel::parse_constraint(FlatZincLexer& lexer)
+{
+    // Read the name.
+    lexer.expect_identifier("constraint");
+    const auto name = lexer.read_identifier();
+
+    // Read the arguments into buffers reused across constraints.
+    lexer.expect("(");
+    size_t nb_args = 0;
+    while (!lexer.is_symbol(")"))
+    {
+        if (args_.size() <= nb_args)
+        {
+            args_.emplace_back();
+        }
+        parse_arg(lexer, args_[nb_args++]);
+        if (!lexer.is_symbol(","))
+        {
+            break;
+        }
+        lexer.next();
+    }
+    lexer.expect(")");
+    parse_annotations(lexer, nullptr);
+    lexer.expect(";");
+
+    // Post the constraint.
+    post_constraint(name, nb_args);
+    ++nb_constraints_;
+}
+
+void FlatZincModel::parse_solve(FlatZincLexer& lexer)
+{
+    lexer.expect_identifier("solve");
+    parse_annotations(lexer, nullptr);
+    if (lexer.is_identifier("satisfy"))
+    {
+        lexer.next();
+        objective_ = Objective::Satisfy;
+    }
+    else
+    {
+        if (lexer.is_identifier("minimize"))
+        {
+            objective_ = Objective::Minimize;
+        }
+        else if (lexer.is_identifier("maximize"))
+        {
+            objective_ = Objective::Maximize;
+        }
+        else
+        {
+            lexer.error(fmt::format("Invalid solve item {}", lexer.text));
+        }
+        lexer.next();
+        obj_value_ = parse_value(lexer, nullptr);
+    }
+    lexer.expect(";");
+}
+
+bool FlatZincModel::parse_annotations(FlatZincLexer& lexer, FlatZincOutput* output)
+{
+    bool is_output = false;
+    while (lexer.is_symbol("::"))
+    {
+        lexer.next();
+        const auto name = lexer.read_identifier();
+        if (output && name == "output_var")
+        {
+            is_output = true;
+        }
+        else if (output && name == "output_array")
+        {
+            // Read the index sets.
+            is_output = true;
+            lexer.expect("(");
+            lexer.expect("[");
+            while (!lexer.is_symbol("]"))
+            {
+                const auto lb = lexer.read_int();
+                lexer.expect("..");
+                const auto ub = lexer.read_int();
+                output->dims.emplace_back(lb, ub);
+                if (!lexer.is_symbol(","))
+                {
+                    break;
+                }
+                lexer.next();
+            }
+            lexer.expect("]");
+            lexer.expect(")");
+        }
+        else if (lexer.is_symbol("("))
+        {
+            // Skip the arguments of other annotations.
+            Int depth = 0;
+            do
+            {
+                if (lexer.type == FlatZincToken::End)
+                {
+                    lexer.error("Unterminated annotation");
+                }
+                depth += lexer.is_symbol("(") - lexer.is_symbol(")");
+                lexer.next();
+            }
+            while (depth > 0);
+        }
+    }
+    return is_output;
+}
+
+void FlatZincModel::parse_arg(FlatZincLexer& lexer, FlatZincArg& arg)
+{
+    arg.is_array = false;
+    arg.array.clear();
+    arg.set.clear();
+    if (lexer.is_symbol("["))
+    {
+        // Read an array literal.
+        arg.is_array = true;
+        lexer.next();
+        while (!lexer.is_symbol("]"))
+        {
+            arg.array.push_back(parse_value(lexer, nullptr));
+            if (!lexer.is_symbol(","))
+            {
+                break;
+            }
+            lexer.next();
+        }
+        lexer.expect("]");
+    }
+    else if (lexer.type == FlatZincToken::Identifier)
+    {
+        // Read a named array or a scalar.
+        if (const auto it = arrays_.find(lexer.text); it != arrays_.end())
+        {
+            const auto& array = it->second;
+            lexer.next();
+            if (lexer.is_symbol("["))
+            {
+                // Access an element without copying the array.
+                lexer.next();
+                const auto idx = lexer.read_int();
+                lexer.expect("]");
+                if (idx < 1 || idx > static_cast<Int>(array.size()))
+                {
+                    lexer.error(fmt::format("Index {} is out of bounds", idx));
+                }
+                arg.scalar = array[idx - 1];
+            }
+            else
+            {
+                // Copy the whole array.
+                arg.is_array = true;
+                arg.array = array;
+            }
+        }
+        else
+        {
+            arg.scalar = parse_value(lexer, &arg.set);
+        }
+    }
+    else
+    {
+        arg.scalar = parse_value(lexer, &arg.set);
+    }
+}
+
+FlatZincValue FlatZincModel::parse_value(FlatZincLexer& lexer, Vector<Int>* set)
+{
+    FlatZincValue value;
+    if (lexer.type == FlatZincToken::Int)
+    {
+        // Read an integer or a range.
+        value = make_int(lexer.read_int());
+        if (lexer.is_symbol(".."))
+        {
+            lexer.next();
+            value.type = FlatZincType::Set;
+            value.set_ub = lexer.read_int();
+        }
+    }
+    else if (lexer.type == FlatZincToken::Float)
+    {
+        lexer.next();
+        value.type = FlatZincType::Float;
+        if (lexer.is_symbol(".."))
+        {
+            lexer.next();
+            lexer.next();
+        }
+    }
+    else if (lexer.type == FlatZincToken::String)
+    {
+        lexer.next();
+        value.type = FlatZincType::String;
+    }
+    else if (lexer.is_symbol("{"))
+    {
+        // Read a set literal.
+        lexer.next();
+        Vector<Int> elements;
+        while (!lexer.is_symbol("}"))
+        {
+            elements.push_back(lexer.read_int());
+            if (!lexer.is_symbol(","))
+            {
+                break;
+            }
+            lexer.next();
+        }
+        lexer.expect("}");
+        std::sort(elements.begin(), elements.end());
+        elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+        value.type = FlatZincType::Set;
+        value.value = elements.empty() ? 1 : elements.front();
+        value.set_ub = elements.empty() ? 0 : elements.back();
+        if (set)
+        {
+            *set = std::move(elements);
+        }
+    }
+    else if (lexer.is_identifier("true") || lexer.is_identifier("false"))
+    {
+        value = make_bool(lexer.is_identifier("true"));
+        lexer.next();
+    }
+    else if (lexer.type == FlatZincToken::Identifier)
+    {
+        // Read a variable or a parameter.
+        const auto name = lexer.text;
+        if (const auto it = vars_.find(name); it != vars_.end())
+        {
+            value = it->second;
+            if (const auto set_it = sets_.find(name); set && set_it != sets_.end())
+            {
+                *set = set_it->second;
+            }
+            lexer.next();
+        }
+        else if (const auto array_it = arrays_.find(name); array_it != arrays_.end())
+        {
+            // Access an element.
+            lexer.next();
+            lexer.expect("[");
+            const auto idx = lexer.read_int();
+            lexer.expect("]");
+            if (idx < 1 || idx > static_cast<Int>(array_it->second.size()))
+            {
+                lexer.error(fmt::format("Index {} is out of bounds", idx));
+            }
+            value = array_it->second[idx - 1];
+        }
+        else
+        {
+            lexer.error(fmt::format("Unknown identifier {}", name));
+        }
+    }
+    else
+    {
+        lexer.error(fmt::format("Unexpected {}", lexer.text));
+    }
+    return value;
+}
+
+void FlatZincModel::post_constraint(const std::string_view name, const size_t nb_args)
+{
+    // Check the arguments.
+    const auto check_args = [&](const size_t nb_expected)
+    {
+        release_assert(nb_args == nb_expected,
+                       "Constraint {} has {} arguments instead of {} in {}", name, nb_args, nb_expected, path_);
+    };
+    const auto& args = args_;
+
+    // Post the constraint.
+    debugln("Posting {}", name);
+    if (name == "int_lin_eq" || name == "int_lin_le")
+    {
+        check_args(3);
+        post_linear(get_ints(args[0].array),
+                    args[1].array,
+                    name == "int_lin_eq" ? Sign::EQ : Sign::LE,
+                    get_int(args[2].scalar));
+    }
+    else if (name == "int_lin_ne")
+    {
+        check_args(3);
+        post_linear_neq(get_ints(args[0].array), args[1].array, get_int(args[2].scalar));
+    }
+    else if (name == "int_eq" || name == "int_le" || name == "int_lt")
+    {
+        check_args(2);
+        post_linear({1, -1},
+                    {args[0].scalar, args[1].scalar},
+                    name == "int_eq" ? Sign::EQ : Sign::LE,
+                    name == "int_lt" ? -1 : 0);
+    }
+    else if (name == "int_ne")
+    {
+        check_args(2);
+        post_linear_neq({1, -1}, {args[0].scalar, args[1].scalar}, 0);
+    }
+    else if (name == "int_lin_le_reif" || name == "int_lin_le_imp" ||
+             name == "int_lin_eq_reif" || name == "int_lin_eq_imp" ||
+             name == "int_lin_ne_reif")
+    {
+        // r <-> sum != rhs is posted as !r <-> sum == rhs.
+        check_args(4);
+        post_reified_linear(get_ints(args[0].array),
+                            args[1].array,
+                            name == "int_lin_le_reif" || name == "int_lin_le_imp" ? Sign::LE : Sign::EQ,
+                            get_int(args[2].scalar),
+                            args[3].scalar,
+                            name != "int_lin_ne_reif",
+                            name != "int_lin_le_imp" && name != "int_lin_eq_imp");
+    }
+    else if (name == "int_le_reif" || name == "int_lt_reif" || name == "int_le_imp" || name == "int_lt_imp" ||
+             name == "int_eq_reif" || name == "int_eq_imp" || name == "int_ne_reif")
+    {
+        check_args(3);
+        const auto is_lt = name == "int_lt_reif" || name == "int_lt_imp";
+        const auto is_le = is_lt || name == "int_le_reif" || name == "int_le_imp";
+        post_reified_linear({1, -1},
+                            {args[0].scalar, args[1].scalar},
+                            is_le ? Sign::LE : Sign::EQ,
+                            is_lt ? -1 : 0,
+                            args[2].scalar,
+                            name != "int_ne_reif",
+                            name != "int_le_imp" && name != "int_lt_imp" && name != "int_eq_imp");
+    }
+    else if (name == "array_int_element")
+    {
+        check_args(3);
+        const auto array = get_ints(args[1].array);
+        if (args[0].scalar.type == FlatZincType::Int)
+        {
+            const auto idx = args[0].scalar.value;
+            release_assert(1 <= idx && idx <= static_cast<Int>(array.size()),
+                           "Index {} of {} is out of bounds in {}", idx, name, path_);
+            post_linear({1}, {args[2].scalar}, Sign::EQ, array[idx - 1]);
+        }
+        else
+        {
+            model_.add_constr_element(get_int_var(args[0].scalar), array, get_int_var(args[2].scalar));
+        }
+    }
+    else if (name == "array_var_int_element")
+    {
+        check_args(3);
+        model_.add_constr_element(get_int_var(args[0].scalar),
+                                  get_int_vars(args[1].array),
+                                  get_int_var(args[2].scalar));
+    }
+    else if (name == "fzn_all_different_int" || name == "all_different_int")
+    {
+        check_args(1);
+        model_.add_constr_alldifferent(get_int_vars(args[0].array));
+    }
+    else if (name == "fzn_cumulative" || name == "cumulative")
+    {
+        check_args(4);
+        model_.add_constr_cumulative(get_int_vars(args[0].array),
+                                     get_ints(args[1].array),
+                                     get_ints(args[2].array),
+                                     get_int(args[3].scalar));
+    }
+    else if (name == "fzn_table_int" || name == "table_int")
+    {
+        check_args(2);
+        const auto vars = get_int_vars(args[0].array);
+        const auto values = get_ints(args[1].array);
+        release_assert(!vars.empty() && values.size() % vars.size() == 0,
+                       "Table of {} has {} values for {} variables in {}", name, values.size(), vars.size(), path_);
+        Matrix<Int> tuples(values.size() / vars.size(), vars.size());
+        for (size_t k = 0; k < tuples.rows(); ++k)
+            std::copy(values.begin() + k * vars.size(), values.begin() + (k + 1) * vars.size(), tuples.begin(k));
+        model_.add_constr_table(vars, tuples);
+    }
+    else if (name == "set_in")
+    {
+        check_args(2);
+        const auto& set = args[1].scalar;
+        release_assert(set.type == FlatZincType::Set, "Second argument of set_in must be a set in {}", path_);
+        post_domain(args[0].scalar, set.value, set.set_ub, args[1].set.empty() ? nullptr : &args[1].set);
+    }
+    else if (name == "bool_clause")
+    {
+        check_args(2);
+        auto terms = args[0].array;
+        for (const auto& value : args[1].array)
+        {
+            terms.push_back(negate(value));
+        }
+        post_bool_linear(Vector<Int>(terms.size(), 1), terms, Sign::GE, 1);
+    }
+    else if (name == "bool_lin_eq" || name == "bool_lin_le")
+    {
+        check_args(3);
+        post_bool_linear(get_ints(args[0].array),
+                         args[1].array,
+                         name == "bool_lin_eq" ? Sign::EQ : Sign::LE,
+                         get_int(args[2].scalar));
+    }
+    else if (name == "bool_eq" || name == "bool_le" || name == "bool_lt")
+    {
+        check_args(2);
+        post_bool_linear({1, -1},
+                         {args[0].scalar, args[1].scalar},
+                         name == "bool_eq" ? Sign::EQ : Sign::LE,
+                         name == "bool_lt" ? -1 : 0);
+    }
+    else if (name == "bool_not")
+    {
+        check_args(2);
+        post_bool_linear({1, 1}, {args[0].scalar, args[1].scalar}, Sign::EQ, 1);
+    }
+    else if (name == "array_bool_or" || name == "array_bool_and")
+    {
+        // r <-> or(a) is sum(a) >= r and a[i] <= r, and r <-> and(a) is sum(a) <= n - 1 + r and r <= a[i].
+        check_args(2);
+        const auto is_or = name == "array_bool_or";
+        const auto& a = args[0].array;
+        const auto& r = args[1].scalar;
+        const auto n = static_cast<Int>(a.size());
+        auto terms = a;
+        terms.push_back(r);
+        Vector<Int> coeffs(terms.size(), 1);
+        coeffs.back() = -1;
+        post_bool_linear(coeffs, terms, is_or ? Sign::GE : Sign::LE, is_or ? 0 : n - 1);
+        for (const auto& value : a)
+        {
+            if (is_or)
+            {
+                post_bool_linear({1, -1}, {value, r}, Sign::LE, 0);
+            }
+            else
+            {
+                post_bool_linear({1, -1}, {r, value}, Sign::LE, 0);
+            }
+        }
+    }
+    else if (name == "bool2int")
+    {
+        check_args(2);
+        const auto& b = args[0].scalar;
+        const auto& x = args[1].scalar;
+        if (b.type == FlatZincType::Bool)
+        {
+            post_linear({1}, {x}, Sign::EQ, b.value);
+        }
+        else if (x.type == FlatZincType::Int)
+        {
+            post_bool_linear({1}, {b}, Sign::EQ, x.value);
+        }
+        else
+        {
+            model_.add_constr_linear(Vector<BoolVar>{get_bool_var(b)}, Vector<Int>{1}, Sign::EQ, 0, get_int_var(x), 1);
+        }
+    }
+    else
+    {
+        err("Constraint {} is not supported by the FlatZinc front end in {}", name, path_);
+    }
+}
+
+void FlatZincModel::post_linear(const Vector<Int>& coeffs,
+                                const Vector<FlatZincValue>& terms,
+                                const Sign sign,
+                                Int rhs)
+{
+    // Move constants to the right-hand side.
+    release_assert(coeffs.size() == terms.size(), "Linear constraint has mismatched arrays in {}", path_);
+    Vector<IntVar> vars;
+    Vector<Int> var_coeffs;
+    for (size_t idx = 0; idx < terms.size(); ++idx)
+        if (terms[idx].type == FlatZincType::Int)
+        {
+            rhs -= coeffs[idx] * terms[idx].value;
+        }
+        else if (coeffs[idx] != 0)
+        {
+            vars.push_back(get_int_var(terms[idx]));
+            var_coeffs.push_back(coeffs[idx]);
+        }
+
+    // Post.
+    if (vars.empty())
+    {
+        if ((sign == Sign::EQ && rhs != 0) || (sign == Sign::LE && rhs < 0) || (sign == Sign::GE && rhs > 0))
+        {
+            model_.mark_as_infeasible();
+        }
+    }
+    else
+    {
+        model_.add_constr_linear(vars, var_coeffs, sign, rhs);
+    }
+}
+
+void FlatZincModel::post_linear_neq(const Vector<Int>& coeffs, const Vector<FlatZincValue>& terms, Int rhs)
+{
+    // Move constants to the right-hand side.
+    release_assert(coeffs.size() == terms.size(), "Linear constraint has mismatched arrays in {}", path_);
+    Vector<IntVar> vars;
+    Vector<Int> var_coeffs;
+    for (size_t idx = 0; idx < terms.size(); ++idx)
+        if (terms[idx].type == FlatZincType::Int)
+        {
+            rhs -= coeffs[idx] * terms[idx].value;
+        }
+        else if (coeffs[idx] != 0)
+        {
+            vars.push_back(get_int_var(terms[idx]));
+            var_coeffs.push_back(coeffs[idx]);
+        }
+
+    // Post.
+    if (vars.empty())
+    {
+        if (rhs == 0)
+        {
+            model_.mark_as_infeasible();
+        }
+    }
+    else
+    {
+        model_.add_constr_linear_neq(vars, var_coeffs, rhs);
+    }
+}
+
+void FlatZincModel::post_bool_linear(const Vector<Int>& coeffs,
+                                     const Vector<FlatZincValue>& terms,
+                                     const Sign sign,
+                                     Int rhs)
+{
+    // Move constants to the right-hand side.
+    release_assert(coeffs.size() == terms.size(), "Linear constraint has mismatched arrays in {}", path_);
+    Vector<BoolVar> vars;
+    Vector<Int> var_coeffs;
+    for (size_t idx = 0; idx < terms.size(); ++idx)
+        if (terms[idx].type == FlatZincType::Bool)
+        {
+            rhs -= coeffs[idx] * terms[idx].value;
+        }
+        else if (coeffs[idx] != 0)
+        {
+            vars.push_back(get_bool_var(terms[idx]));
+            var_coeffs.push_back(coeffs[idx]);
+        }
+
+    // Post.
+    if (vars.empty())
+    {
+        if ((sign == Sign::EQ && rhs != 0) || (sign == Sign::LE && rhs < 0) || (sign == Sign::GE && rhs > 0))
+        {
+            model_.mark_as_infeasible();
+        }
+    }
+    else if (vars.size() == 1 && var_coeffs[0] == 1 && sign != Sign::LE && rhs == 1)
+    {
+        model_.add_constr_fix(vars[0]);
+    }
+    else
+    {
+        model_.add_constr_linear(vars, var_coeffs, sign, rhs);
+    }
+}
+
+void FlatZincModel::post_reified_linear(const Vector<Int>& coeffs,
+                                        const Vector<FlatZincValue>& terms,
+                                        const Sign sign,
+                                        Int rhs,
+                                        const FlatZincValue& r,
+                                        const bool r_val,
+                                        const bool full)
+{
+    // Check.
+    debug_assert(sign == Sign::LE || sign == Sign::EQ);
+
+    // Post the constraint or its negation if the literal is fixed.
+    if (r.type == FlatZincType::Bool)
+    {
+        if ((r.value != 0) == r_val)
+        {
+            post_linear(coeffs, terms, sign, rhs);
+        }
+        else if (full && sign == Sign::LE)
+        {
+            post_linear(coeffs, terms, Sign::GE, rhs + 1);
+        }
+        else if (full)
+        {
+            post_linear_neq(coeffs, terms, rhs);
+        }
+        return;
+    }
+    const auto r_var = r_val ? get_bool_var(r) : model_.get_neg(get_bool_var(r));
+
+    // Move constants to the right-hand side.
+    release_assert(coeffs.size() == terms.size(), "Linear constraint has mismatched arrays in {}", path_);
+    Vector<IntVar> vars;
+    Vector<Int> var_coeffs;
+    for (size_t idx = 0; idx < terms.size(); ++idx)
+        if (terms[idx].type == FlatZincType::Int)
+        {
+            rhs -= coeffs[idx] * terms[idx].value;
+        }
+        else if (coeffs[idx] != 0)
+        {
+            vars.push_back(get_int_var(terms[idx]));
+            var_coeffs.push_back(coeffs[idx]);
+        }
+
+    // Post.
+    if (vars.empty())
+    {
+        // r -> 0 <= / == rhs and, if fully reified, !r -> 0 > / != rhs.
+        const auto is_true = sign == Sign::LE ? 0 <= rhs : 0 == rhs;
+        if (!is_true)
+        {
+            post_bool_linear({1}, {r}, Sign::EQ, r_val ? 0 : 1);
+        }
+        else if (full)
+        {
+            post_bool_linear({1}, {r}, Sign::EQ, r_val ? 1 : 0);
+        }
+    }
+    else if (vars.size() == 1 && (var_coeffs[0] == 1 || var_coeffs[0] == -1) && (sign == Sign::LE || !full))
+    {
+        // r -> x <= / == rhs or r -> x >= / == -rhs.
+        const auto x = vars[0];
+        if (var_coeffs[0] == 1)
+        {
+            model_.add_constr_imply(r_var, true, x, sign, rhs);
+            if (full)
+            {
+                model_.add_constr_imply(r_var, false, x, Sign::GE, rhs + 1);
+            }
+        }
+        else
+        {
+            model_.add_constr_imply(r_var, true, x, sign == Sign::LE ? Sign::GE : Sign::EQ, -rhs);
+            if (full)
+            {
+                model_.add_constr_imply(r_var, false, x, Sign::LE, -rhs - 1);
+            }
+        }
+    }
+    else if (sign == Sign::LE &&
+             vars.size() == 2 &&
+             var_coeffs[0] == -var_coeffs[1] &&
+             (var_coeffs[0] == 1 || var_coeffs[0] == -1))
+    {
+        // r -> x - y <= rhs and, if fully reified, !r -> y - x <= -rhs - 1.
+        const auto x = var_coeffs[0] == 1 ? vars[0] : vars[1];
+        const auto y = var_coeffs[0] == 1 ? vars[1] : vars[0];
+        model_.add_constr_reify_subtraction_leq(r_var, x, y, rhs);
+        if (full)
+        {
+            model_.add_constr_reify_subtraction_leq(model_.get_neg(r_var), y, x, -rhs - 1);
+        }
+    }
+    else if (full)
+    {
+        model_.add_constr_linear_reif(r_var, vars, var_coeffs, sign, rhs);
+    }
+    else
+    {
+        model_.add_constr_linear_imply(r_var, vars, var_coeffs, sign, rhs);
+    }
+}
+
+void FlatZincModel::post_domain(const FlatZincValue& var, const Int lb, const Int ub, const Vector<Int>* set)
+{
+    // Check a constant.
+    if (var.type == FlatZincType::Int)
+    {
+        if (var.value < lb || var.value > ub || (set && !std::binary_search(set->begin(), set->end(), var.value)))
+        {
+            model_.mark_as_infeasible();
+        }
+        return;
+    }
+
+    // Tighten the bounds.
+    const auto x = get_int_var(var);
+    if (lb > model_.lb(x))
+    {
+        model_.add_constr_linear({x}, Vector<Int>{1}, Sign::GE, lb);
+    }
+    if (ub < model_.ub(x))
+    {
+        model_.add_constr_linear({x}, Vector<Int>{1}, Sign::LE, ub);
+    }
+
+    // Remove the holes in the domain. Exclude each hole if there are fewer holes than values and otherwise post
+    // the domain once as a table over one variable, so that the number of constraints never exceeds the size of
+    // the domain.
+    if (set)
+    {
+        const auto first = std::lower_bound(set->begin(), set->end(), std::max(lb, model_.lb(x)));
+        const auto last = std::upper_bound(first, set->end(), std::min(ub, model_.ub(x)));
+        const auto nb_vals = static_cast<int64_t>(last - first);
+        const auto nb_holes = static_cast<int64_t>(model_.ub(x)) - model_.lb(x) + 1 - nb_vals;
+        if (nb_vals == 0)
+        {
+            model_.mark_as_infeasible();
+        }
+        else if (nb_holes <= nb_vals)
+        {
+            for (Int val = model_.lb(x); val <= model_.ub(x); ++val)
+                if (!std::binary_search(first, last, val))
+                {
+                    model_.add_constr_linear_neq({x}, {1}, val);
+                }
+        }
+        else
+        {
+            Matrix<Int> tuples(nb_vals, 1);
+            for (int64_t k = 0; k < nb_vals; ++k)
+                tuples(k, 0) = first[k];
+            model_.add_constr_table({x}, tuples);
+        }
+    }
+}
+
+IntVar FlatZincModel::get_int_var(const FlatZincValue& value)
+{
+    if (value.type == FlatZincType::IntVar)
+    {
+        return value.int_var;
+    }
+    else if (value.type == FlatZincType::Int)
+    {
+        return model_.add_int_var(value.value, value.value, true);
+    }
+    err("Expected an integer variable in {}", path_);
+}
+
+BoolVar FlatZincModel::get_bool_var(const FlatZincValue& value)
+{
+    if (value.type == FlatZincType::BoolVar)
+    {
+        return value.bool_var;
+    }
+    else if (value.type == FlatZincType::Bool)
+    {
+        return value.value ? model_.get_true() : model_.get_false();
+    }
+    err("Expected a Boolean variable in {}", path_);
+}
+
+Vector<IntVar> FlatZincModel::get_int_vars(const Vector<FlatZincValue>& values)
+{
+    Vector<IntVar> vars;
+    vars.reserve(values.size());
+    for (const auto& value : values)
+    {
+        vars.push_back(get_int_var(value));
+    }
+    return vars;
+}
+
+Vector<BoolVar> FlatZincModel::get_bool_vars(const Vector<FlatZincValue>& values)
+{
+    Vector<BoolVar> vars;
+    vars.reserve(values.size());
+    for (const auto& value : values)
+    {
+        vars.push_back(get_bool_var(value));
+    }
+    return vars;
+}
+
+Int FlatZincModel::get_int(const FlatZincValue& value) const
+{
+    release_assert(value.type == FlatZincType::Int || value.type == FlatZincType::Bool,
+                   "Expected an integer parameter in {}", path_);
+    return value.value;
+}
+
+Vector<Int> FlatZincModel::get_ints(const Vector<FlatZincValue>& values) const
+{
+    Vector<Int> ints;
+    ints.reserve(values.size());
+    for (const auto& value : values)
+    {
+        ints.push_back(get_int(value));
+    }
+    return ints;
+}
+
+FlatZincValue FlatZincModel::negate(const FlatZincValue& value)
+{
+    if (value.type == FlatZincType::Bool)
+    {
+        return make_bool(!value.value);
+    }
+    FlatZincValue neg;
+    neg.type = FlatZincType::BoolVar;
+    neg.bool_var = model_.get_neg(get_bool_var(value));
+    return neg;
+}
+
+void FlatZincModel::solve(const Float time_limit, const bool verbose)
+{
+    if (objective_ == Objective::Satisfy)
+    {
+        model_.satisfy(time_limit, verbose);
+        return;
+    }
+
+    // Get the objective variable, negating it to maximize.
+    auto var = get_int_var(obj_value_);
+    model_.add_mip_var(var);
+    if (objective_ == Objective::Maximize)
+    {
+        const auto neg_var = model_.add_int_var(-model_.ub(var), -model_.lb(var), true, "-objective");
+        model_.add_constr_linear({var, neg_var}, {1, 1}, Sign::EQ, 0);
+        var = neg_var;
+    }
+    obj_var_ = var;
+
+    // Solve.
+    model_.minimize(obj_var_, time_limit, verbose);
+}
+
+String FlatZincModel::format_value(const FlatZincValue& value) const
+{
+    switch (value.type)
+    {
+        case FlatZincType::Bool:
+            return value.value ? "true" : "false";
+        case FlatZincType::Int:
+            return fmt::format("{}", value.value);
+        case FlatZincType::Set:
+            return fmt::format("{}..{}", value.value, value.set_ub);
+        case FlatZincType::BoolVar:
+            return model_.get_sol(value.bool_var) ? "true" : "false";
+        case FlatZincType::IntVar:
+            return fmt::format("{}", model_.get_sol(value.int_var));
+        default:
+            return "";
+    }
+}
+
+void FlatZincModel::print_solution() const
+{
+    for (const auto& output : outputs_)
+        if (!output.is_array)
+        {
+            println("{} = {};", output.name, format_value(output.values[0]));
+        }
+        else
+        {
+            String dims;
+            for (const auto& [lb, ub] : output.dims)
+            {
+                dims += fmt::format("{}..{}, ", lb, ub);
+            }
+            String values;
+            for (const auto& value : output.values)
+            {
+                values += values.empty() ? "" : ", ";
+                values += format_value(value);
+            }
+            println("{} = array{}d({}[{}]);", output.name, output.dims.size(), dims, values);
+        }
+    println("----------");
+}
+
+void FlatZincModel::print_status() const
+{
+    const auto status = model_.get_status();
+    if (status == Status::Optimal && objective_ != Objective::Satisfy)
+    {
+        println("==========");
+    }
+    else if (status == Status::Infeasible)
+    {
+        println("=====UNSATISFIABLE=====");
+    }
+    else if (status != Status::Optimal && status != Status::Feasible)
+    {
+        println("=====UNKNOWN=====");
+    }
+}
+
+void FlatZincModel::print_statistics(const Float solve_time) const
+{
+    const auto status = model_.get_status();
+    println("%%%mzn-stat: solveTime={:.3f}", solve_time);
+    println("%%%mzn-stat: nodes={}", model_.get_nb_nodes());
+    println("%%%mzn-stat: boolVariables={}", model_.nb_bool_vars());
+    println("%%%mzn-stat: intVariables={}", model_.nb_int_vars());
+    println("%%%mzn-stat: constraints={}", nb_constraints_);
+    if (objective_ != Objective::Satisfy && status != Status::Infeasible && status != Status::Unknown)
+    {
+        const auto sign = objective_ == Objective::Maximize ? -1 : 1;
+        println("%%%mzn-stat: objective={}", sign * model_.get_primal_bound());
+        println("%%%mzn-stat: objectiveBound={}", sign * model_.get_dual_bound());
+    }
+    println("%%%mzn-stat-end");
+}
+
+}
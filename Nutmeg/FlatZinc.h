@@ -0,0 +1,138 @@
+#ifndef NUTMEG_FLATZINC_H
+#define NUTMEG_FLATZINC_H
+
+#include "Includes.h"
+#include "Model.h"
+#include <string_view>
+
+namespace Nutmeg
+{
+
+class FlatZincLexer;
+
+// Type of a FlatZinc value
+enum class FlatZincType : uint8_t
+{
+    Bool,
+    Int,
+    Set,
+    Float,
+    String,
+    BoolVar,
+    IntVar
+};
+
+// Scalar FlatZinc value. Sets are stored as ranges with the explicit elements of set literals kept in
+// the argument that contains them.
+struct FlatZincValue
+{
+    FlatZincType type{FlatZincType::Int};
+    Int value{0};
+    Int set_ub{0};
+    BoolVar bool_var{};
+    IntVar int_var{};
+};
+
+// Argument of a constraint, which is a scalar or an array
+struct FlatZincArg
+{
+    bool is_array{false};
+    FlatZincValue scalar{};
+    Vector<FlatZincValue> array{};
+    Vector<Int> set{};
+};
+
+// Variable or array of variables printed in a solution
+struct FlatZincOutput
+{
+    String name;
+    bool is_array;
+    Vector<Pair<Int, Int>> dims;
+    Vector<FlatZincValue> values;
+};
+
+// Front end that reads a FlatZinc model into a Nutmeg model. The file is memory-mapped and read in one
+// pass. Declarations create variables as they are read, and constraints are posted as soon as their
+// arguments are read, so no syntax tree of the model is kept. Integer variables are created in the
+// MIP so that linear constraints enter the master problem, leaving global constraints to the CP checker.
+class FlatZincModel
+{
+    enum class Objective
+    {
+        Satisfy,
+        Minimize,
+        Maximize
+    };
+
+    Model& model_;
+    String path_;
+    HashTable<std::string_view, FlatZincValue> vars_;
+    HashTable<std::string_view, Vector<FlatZincValue>> arrays_;
+    HashTable<std::string_view, Vector<Int>> sets_;
+    Vector<FlatZincOutput> outputs_;
+    Objective objective_;
+    FlatZincValue obj_value_;
+    IntVar obj_var_;
+    Vector<FlatZincArg> args_;
+    Int nb_constraints_;
+
+  public:
+    // Constructors and destructors
+    explicit FlatZincModel(Model& model);
+    FlatZincModel(const FlatZincModel&) = delete;
+    FlatZincModel(FlatZincModel&&) = delete;
+    FlatZincModel& operator=(const FlatZincModel&) = delete;
+    FlatZincModel& operator=(FlatZincModel&&) = delete;
+    ~FlatZincModel() = default;
+
+    // Read a model
+    void read(const String& path);
+    inline Int nb_constraints() const { return nb_constraints_; }
+
+    // Solve
+    void solve(const Float time_limit = Infinity, const bool verbose = false);
+
+    // Print the current solution and the final status in the FlatZinc output format
+    void print_solution() const;
+    void print_status() const;
+
+    // Print the statistics of the solve in the FlatZinc output format
+    void print_statistics(const Float solve_time) const;
+
+  private:
+    // Parse items
+    void parse_declaration(FlatZincLexer& lexer);
+    void parse_constraint(FlatZincLexer& lexer);
+    void parse_solve(FlatZincLexer& lexer);
+    bool parse_annotations(FlatZincLexer& lexer, FlatZincOutput* output);
+    void parse_arg(FlatZincLexer& lexer, FlatZincArg& arg);
+    FlatZincValue parse_value(FlatZincLexer& lexer, Vector<Int>* set);
+
+    // Post constraints
+    void post_constraint(const std::string_view name, const size_t nb_args);
+    void post_linear(const Vector<Int>& coeffs, const Vector<FlatZincValue>& terms, const Sign sign, Int rhs);
+    void post_linear_neq(const Vector<Int>& coeffs, const Vector<FlatZincValue>& terms, Int rhs);
+    void post_bool_linear(const Vector<Int>& coeffs, const Vector<FlatZincValue>& terms, const Sign sign, Int rhs);
+    void post_reified_linear(const Vector<Int>& coeffs,
+                             const Vector<FlatZincValue>& terms,
+                             const Sign sign,
+                             const Int rhs,
+                             const FlatZincValue& r,
+                             const bool r_val,
+                             const bool full);
+    void post_domain(const FlatZincValue& var, const Int lb, const Int ub, const Vector<Int>* set);
+
+    // Convert values
+    IntVar get_int_var(const FlatZincValue& value);
+    BoolVar get_bool_var(const FlatZincValue& value);
+    Vector<IntVar> get_int_vars(const Vector<FlatZincValue>& values);
+    Vector<BoolVar> get_bool_vars(const Vector<FlatZincValue>& values);
+    Int get_int(const FlatZincValue& value) const;
+    Vector<Int> get_ints(const Vector<FlatZincValue>& values) const;
+    FlatZincValue negate(const FlatZincValue& value);
+    String format_value(const FlatZincValue& value) const;
+};
+
+}
+
+#endif
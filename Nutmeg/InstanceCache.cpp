@@ -0,0 +1,193 @@
+#include "InstanceCache.h"
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INSTANCE_CACHE_MAGIC                    "NUTMEGIC"
+
+namespace Nutmeg
+{
+
+static_assert(sizeof(InstanceCacheHeader) % INSTANCE_CACHE_ALIGNMENT == 0);
+
+// Hash the contents of a file eight bytes at a time
+static
+uint64_t hash_bytes(
+    const char* data,    // Data
+    const size_t size    // Number of bytes
+)
+{
+    constexpr uint64_t prime = 0x100000001b3;
+    uint64_t hash = 0xcbf29ce484222325 ^ size;
+    size_t idx = 0;
+    for (; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + idx, sizeof(uint64_t));
+        hash = ((hash ^ word) * prime);
+        hash ^= hash >> 29;
+    }
+    for (; idx < size; ++idx)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[idx])) * prime;
+    }
+    return hash;
+}
+
+static
+uint64_t hash_file(
+    const String& path    // Path
+)
+{
+    const MappedFile file(path);
+    return hash_bytes(file.data(), file.size());
+}
+
+InstanceCacheWriter::InstanceCacheWriter(const String& path) :
+    file_(path, std::ios::binary | std::ios::trunc),
+    offset_(0)
+{
+    // Reserve space for the header.
+    const InstanceCacheHeader header{};
+    write_bytes(&header, sizeof(header));
+}
+
+void InstanceCacheWriter::write_bytes(const void* data, const size_t size)
+{
+    file_.write(static_cast<const char*>(data), size);
+    offset_ += size;
+}
+
+void InstanceCacheWriter::align()
+{
+    constexpr char padding[INSTANCE_CACHE_ALIGNMENT]{};
+    write_bytes(padding, (INSTANCE_CACHE_ALIGNMENT - offset_ % INSTANCE_CACHE_ALIGNMENT) % INSTANCE_CACHE_ALIGNMENT);
+}
+
+void InstanceCacheWriter::write_header(const InstanceCacheHeader& header)
+{
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.flush();
+}
+
+InstanceCacheReader::InstanceCacheReader(const MappedFile& file, const size_t offset) :
+    file_(file),
+    p_(file.begin() + offset)
+{
+}
+
+const char* InstanceCacheReader::read_bytes(const size_t size)
+{
+    release_assert(size <= static_cast<size_t>(file_.end() - p_),
+                   "Instance cache is corrupt, delete it or set NUTMEG_INSTANCE_CACHE=0");
+    const auto data = p_;
+    p_ += size;
+    return data;
+}
+
+void InstanceCacheReader::align()
+{
+    const auto offset = static_cast<size_t>(p_ - file_.begin());
+    read_bytes((INSTANCE_CACHE_ALIGNMENT - offset % INSTANCE_CACHE_ALIGNMENT) % INSTANCE_CACHE_ALIGNMENT);
+}
+
+InstanceCache::InstanceCache(const String& source_path, const String& tag, const uint32_t data_version) :
+    source_path_(source_path),
+    cache_path_(),
+    source_header_()
+{
+    release_assert(tag.size() < sizeof(source_header_.tag), "Instance cache tag {} is too long", tag);
+
+    // Get the size and modification time of the instance file. Leave the cache disabled if the file
+    // cannot be found so that the reader of the instance reports the error.
+    struct stat status;
+    if (::stat(source_path.c_str(), &status) != 0)
+    {
+        return;
+    }
+    std::memcpy(source_header_.magic, INSTANCE_CACHE_MAGIC, sizeof(source_header_.magic));
+    source_header_.cache_version = INSTANCE_CACHE_VERSION;
+    source_header_.data_version = data_version;
+    std::strcpy(source_header_.tag, tag.c_str());
+    source_header_.source_size = status.st_size;
+    source_header_.source_mtime = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+
+    // Get the path of the cache file.
+    const auto cache_dir = std::getenv("NUTMEG_INSTANCE_CACHE");
+    if (!cache_dir)
+    {
+        cache_path_ = source_path + ".cache";
+    }
+    else if (String(cache_dir) != "0")
+    {
+        // Tell apart instances with the same file name in different directories.
+        const auto slash = source_path.find_last_of('/');
+        const auto file_name = slash == String::npos ? source_path : source_path.substr(slash + 1);
+        cache_path_ = fmt::format("{}/{}.{:016x}.cache",
+                                  cache_dir, file_name, hash_bytes(source_path.data(), source_path.size()));
+    }
+}
+
+std::unique_ptr<MappedFile> InstanceCache::open()
+{
+    // Check that the cache exists.
+    struct stat status;
+    if (cache_path_.empty() ||
+        ::stat(cache_path_.c_str(), &status) != 0 ||
+        static_cast<size_t>(status.st_size) < sizeof(InstanceCacheHeader))
+    {
+        return nullptr;
+    }
+
+    // Check the header.
+    auto file = std::make_unique<MappedFile>(cache_path_);
+    InstanceCacheHeader header;
+    std::memcpy(&header, file->data(), sizeof(InstanceCacheHeader));
+    if (std::memcmp(header.magic, source_header_.magic, sizeof(header.magic)) != 0 ||
+        header.cache_version != source_header_.cache_version ||
+        header.data_version != source_header_.data_version ||
+        std::strncmp(header.tag, source_header_.tag, sizeof(header.tag)) != 0 ||
+        header.source_size != source_header_.source_size ||
+        header.payload_size != file->size() - sizeof(InstanceCacheHeader))
+    {
+        return nullptr;
+    }
+
+    // Check that the instance is unchanged, comparing the contents only if it has been touched.
+    if (header.source_mtime != source_header_.source_mtime && header.source_hash != hash_file(source_path_))
+    {
+        return nullptr;
+    }
+
+    // Done.
+    return file;
+}
+
+String InstanceCache::get_tmp_path() const
+{
+    // Runs in parallel write to different temporary files.
+    return fmt::format("{}.{}.tmp", cache_path_, ::getpid());
+}
+
+bool InstanceCache::finish(InstanceCacheWriter& writer)
+{
+    auto header = source_header_;
+    header.source_hash = hash_file(source_path_);
+    header.payload_size = writer.offset() - sizeof(InstanceCacheHeader);
+    writer.write_header(header);
+    return writer.good();
+}
+
+void InstanceCache::commit(const String& tmp_path, const bool success)
+{
+    // Replace the cache in one step so that other runs never see a partial file.
+    if (!success || std::rename(tmp_path.c_str(), cache_path_.c_str()) != 0)
+    {
+        std::remove(tmp_path.c_str());
+        println("Warning: cannot write instance cache {}, set NUTMEG_INSTANCE_CACHE to a writable "
+                "directory or to 0", cache_path_);
+    }
+}
+
+}
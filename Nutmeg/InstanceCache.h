@@ -0,0 +1,229 @@
+#ifndef NUTMEG_INSTANCECACHE_H
+#define NUTMEG_INSTANCECACHE_H
+
+#include "Includes.h"
+#include "Matrix.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+
+namespace Nutmeg
+{
+
+// Version of the layout of cache files, independent of the version of the data of each example
+#define INSTANCE_CACHE_VERSION                           1
+
+// Alignment of arrays in cache files
+#define INSTANCE_CACHE_ALIGNMENT                        64
+
+// Header of a cache file
+struct InstanceCacheHeader
+{
+    char magic[8];
+    uint32_t cache_version;
+    uint32_t data_version;
+    char tag[16];
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+    uint64_t payload_size;
+};
+
+// Writer of the data of an instance into a cache file. Arrays are aligned so that they can be copied
+// out of a memory mapping in one block.
+class InstanceCacheWriter
+{
+    std::ofstream file_;
+    uint64_t offset_;
+
+  public:
+    // Constructors and destructors
+    explicit InstanceCacheWriter(const String& path);
+
+    // Write values
+    template<class... Ts>
+    inline void operator()(const Ts&... values) { (write(values), ...); }
+
+    // Check if all writes succeeded
+    inline bool good() const { return file_.good(); }
+    inline uint64_t offset() const { return offset_; }
+
+    // Go back to the start to write the header
+    void write_header(const InstanceCacheHeader& header);
+
+  private:
+    void write_bytes(const void* data, const size_t size);
+    void align();
+
+    template<class T>
+    void write(const T& value)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        write_bytes(&value, sizeof(T));
+    }
+    void write(const String& str)
+    {
+        write<uint64_t>(str.size());
+        write_bytes(str.data(), str.size());
+    }
+    template<class T>
+    void write(const Vector<T>& vector)
+    {
+        write<uint64_t>(vector.size());
+        if constexpr (std::is_same_v<T, String>)
+        {
+            for (const auto& str : vector)
+            {
+                write(str);
+            }
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+            align();
+            write_bytes(vector.data(), vector.size() * sizeof(T));
+        }
+    }
+    template<class T>
+    void write(const Matrix<T>& matrix)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        write<uint64_t>(matrix.rows());
+        write<uint64_t>(matrix.cols());
+        align();
+        for (size_t i = 0; i < matrix.rows() && matrix.cols() > 0; ++i)
+        {
+            write_bytes(&*matrix.cbegin(i), matrix.cols() * sizeof(T));
+        }
+    }
+};
+
+// Reader of the data of an instance from a memory-mapped cache file
+class InstanceCacheReader
+{
+    const MappedFile& file_;
+    const char* p_;
+
+  public:
+    // Constructors and destructors
+    InstanceCacheReader(const MappedFile& file, const size_t offset);
+
+    // Read values
+    template<class... Ts>
+    inline void operator()(Ts&... values) { (read(values), ...); }
+
+  private:
+    const char* read_bytes(const size_t size);
+    void align();
+
+    template<class T>
+    void read(T& value)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+    }
+    void read(String& str)
+    {
+        uint64_t size;
+        read(size);
+        str.assign(read_bytes(size), size);
+    }
+    template<class T>
+    void read(Vector<T>& vector)
+    {
+        uint64_t size;
+        read(size);
+        if constexpr (std::is_same_v<T, String>)
+        {
+            vector.resize(size);
+            for (auto& str : vector)
+            {
+                read(str);
+            }
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+            align();
+            const auto data = read_bytes(size * sizeof(T));
+            vector.resize(size);
+            std::memcpy(vector.data(), data, size * sizeof(T));
+        }
+    }
+    template<class T>
+    void read(Matrix<T>& matrix)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        uint64_t rows;
+        uint64_t cols;
+        read(rows);
+        read(cols);
+        align();
+        const auto data = read_bytes(rows * cols * sizeof(T));
+        matrix.clear_and_resize(rows, cols);
+        for (size_t i = 0; i < rows && cols > 0; ++i)
+        {
+            std::memcpy(&*matrix.begin(i), data + i * cols * sizeof(T), cols * sizeof(T));
+        }
+    }
+};
+
+// Binary cache of the data of an instance, stored next to the instance file or in the directory named
+// by the environment variable NUTMEG_INSTANCE_CACHE, which also disables the cache if set to 0. The data
+// type describes its members by a method serialize(archive) calling archive(members...). A cache file
+// is used if it has the same tag and versions and the instance file has the same size and either the
+// same modification time or the same contents.
+class InstanceCache
+{
+    String source_path_;
+    String cache_path_;
+    InstanceCacheHeader source_header_;
+
+  public:
+    // Constructors and destructors
+    InstanceCache(const String& source_path, const String& tag, const uint32_t data_version);
+
+    // Read the data from the cache, returning false if there is no valid cache
+    template<class Data>
+    bool load(Data& data)
+    {
+        const auto file = open();
+        if (!file)
+        {
+            return false;
+        }
+        InstanceCacheReader reader(*file, sizeof(InstanceCacheHeader));
+        data.serialize(reader);
+        return true;
+    }
+
+    // Write the data to the cache, printing a warning on failure
+    template<class Data>
+    void store(Data& data)
+    {
+        if (cache_path_.empty())
+        {
+            return;
+        }
+        const auto tmp_path = get_tmp_path();
+        bool success;
+        {
+            InstanceCacheWriter writer(tmp_path);
+            data.serialize(writer);
+            success = finish(writer);
+        }
+        commit(tmp_path, success);
+    }
+
+  private:
+    std::unique_ptr<MappedFile> open();
+    String get_tmp_path() const;
+    bool finish(InstanceCacheWriter& writer);
+    void commit(const String& tmp_path, const bool success);
+};
+
+}
+
+#endif
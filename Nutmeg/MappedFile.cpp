@@ -0,0 +1,58 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Nutmeg
+{
+
+MappedFile::MappedFile(const String& path) :
+    data_(nullptr),
+    size_(0)
+{
+    // Open file.
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    release_assert(fd >= 0, "Cannot open file {}", path);
+
+    // Get size.
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        err("Cannot get size of file {}", path);
+    }
+    size_ = static_cast<size_t>(status.st_size);
+
+    // Map the file. An empty file cannot be mapped and is left as an empty range.
+    if (size_ > 0)
+    {
+        auto data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            err("Cannot map file {}", path);
+        }
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+    ::close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data_(other.data_),
+    size_(other.size_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+    {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+}
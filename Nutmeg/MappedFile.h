@@ -0,0 +1,35 @@
+#ifndef NUTMEG_MAPPEDFILE_H
+#define NUTMEG_MAPPEDFILE_H
+
+#include "Includes.h"
+#include <string_view>
+
+namespace Nutmeg
+{
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+    const char* data_;
+    size_t size_;
+
+  public:
+    // Constructors and destructors
+    explicit MappedFile(const String& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+    ~MappedFile();
+
+    // Getters
+    inline const char* data() const { return data_; }
+    inline size_t size() const { return size_; }
+    inline const char* begin() const { return data_; }
+    inline const char* end() const { return data_ + size_; }
+    inline std::string_view view() const { return {data_, size_}; }
+};
+
+}
+
+#endif
@@ -1,63 +1,241 @@
 #ifndef NUTMEG_MATRIX_H
 #define NUTMEG_MATRIX_H
 
-#include <valarray>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
 
+// Alignment of the rows of a matrix in bytes, which is the size of a cache line and of the widest
+// vector registers
+#define MATRIX_ALIGNMENT                                64
+
+// Contiguous view of a row of a matrix
+template<typename T>
+class RowSpan
+{
+    T* _data{nullptr};
+    size_t _size{0};
+
+  public:
+    // Constructors
+    RowSpan() = default;
+    RowSpan(T* data, const size_t size) : _data(data), _size(size) {}
+
+    // Getters
+    inline T* data() const { return _data; }
+    inline size_t size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+    inline T& operator[](const size_t j) const { return _data[j]; }
+    inline T* begin() const { return _data; }
+    inline T* end() const { return _data + _size; }
+};
+
+// Strided view of a column of a matrix
+template<typename T>
+class ColumnView
+{
+    T* _data{nullptr};
+    size_t _stride{0};
+    size_t _size{0};
+
+  public:
+    // Iterator stepping over the rows
+    class Iterator
+    {
+        T* _ptr;
+        size_t _stride;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator(T* ptr, const size_t stride) : _ptr(ptr), _stride(stride) {}
+        inline T& operator*() const { return *_ptr; }
+        inline Iterator& operator++() { _ptr += _stride; return *this; }
+        inline Iterator operator++(int) { auto it = *this; _ptr += _stride; return it; }
+        inline bool operator==(const Iterator& other) const { return _ptr == other._ptr; }
+        inline bool operator!=(const Iterator& other) const { return _ptr != other._ptr; }
+    };
+
+    // Constructors
+    ColumnView() = default;
+    ColumnView(T* data, const size_t stride, const size_t size) : _data(data), _stride(stride), _size(size) {}
+
+    // Getters
+    inline size_t size() const { return _size; }
+    inline size_t stride() const { return _stride; }
+    inline bool empty() const { return _size == 0; }
+    inline T& operator[](const size_t i) const { return _data[i * _stride]; }
+    inline Iterator begin() const { return Iterator(_data, _stride); }
+    inline Iterator end() const { return Iterator(_data + _size * _stride, _stride); }
+};
+
+// Reduce an array with one accumulator per lane of a vector register so that the loop vectorizes
+// without reassociating a single accumulator. Sums of floating-point values are therefore added in a
+// different order than a sequential loop would.
+template<typename T, typename Op>
+inline T matrix_reduce(const T* __restrict data, const size_t size, const T init, Op op)
+{
+    constexpr size_t lanes = sizeof(T) < MATRIX_ALIGNMENT ? MATRIX_ALIGNMENT / sizeof(T) : 1;
+    T acc[lanes];
+    std::fill(acc, acc + lanes, init);
+    size_t j = 0;
+    for (; j + lanes <= size; j += lanes)
+        for (size_t k = 0; k < lanes; ++k)
+            acc[k] = op(acc[k], data[j + k]);
+    T result = init;
+    for (size_t k = 0; k < lanes; ++k)
+        result = op(result, acc[k]);
+    for (; j < size; ++j)
+        result = op(result, data[j]);
+    return result;
+}
+
+template<typename T>
+class Matrix;
+template<>
+class Matrix<bool>;
+
+// Dense matrix stored in row-major order. Rows of at least one cache line are padded to a multiple of
+// the alignment so that every row starts on an aligned address, which lets loops over a row use aligned
+// vector loads. Elements must be trivially copyable.
 template<typename T>
 class Matrix
 {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "Matrix elements must be trivially copyable");
+
   protected:
     size_t _rows{0};
     size_t _cols{0};
-    std::valarray<T> _data{};
+    size_t _stride{0};
+    size_t _capacity{0};
+    T* _data{nullptr};
 
   public:
     // Constructors and destructors
     Matrix(const size_t rows, const size_t cols, const T value = {})
-        : _rows(rows),
-          _cols(cols),
-          _data(value, rows * cols)
     {
+        clear_and_resize(rows, cols, value);
     }
     Matrix(const size_t rows, const size_t cols, const T* const* matrix)
         : Matrix<T>(rows, cols)
     {
         for (size_t i = 0; i < _rows; ++i)
-            for (size_t j = 0; j < _cols; ++j)
-                _data[i * _cols + j] = matrix[i][j];
+            std::copy(matrix[i], matrix[i] + _cols, begin(i));
     }
     Matrix() = default;
-    Matrix(const Matrix<T>& other) = default;
-    Matrix(Matrix<T>&& other) = default;
-    ~Matrix() = default;
+    Matrix(const Matrix<T>& other)
+    {
+        *this = other;
+    }
+    Matrix(Matrix<T>&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+    ~Matrix()
+    {
+        deallocate(_data);
+    }
 
     // Assignment
-    Matrix<T>& operator=(const Matrix<T>& other) = default;
-    Matrix<T>& operator=(Matrix<T>&& other) = default;
+    Matrix<T>& operator=(const Matrix<T>& other)
+    {
+        if (this != &other)
+        {
+            reserve(other._rows, other._cols);
+            _rows = other._rows;
+            _cols = other._cols;
+            _stride = other._stride;
+            if (other._data)
+            {
+                std::memcpy(static_cast<void*>(_data), other._data, _rows * _stride * sizeof(T));
+            }
+        }
+        return *this;
+    }
+    Matrix<T>& operator=(Matrix<T>&& other) noexcept
+    {
+        if (this != &other)
+        {
+            deallocate(_data);
+            _rows = other._rows;
+            _cols = other._cols;
+            _stride = other._stride;
+            _capacity = other._capacity;
+            _data = other._data;
+            other._rows = other._cols = other._stride = other._capacity = 0;
+            other._data = nullptr;
+        }
+        return *this;
+    }
     Matrix<T>& operator=(const T& value)
     {
-        _data = value;
+        std::fill(_data, _data + _rows * _stride, value);
         return *this;
     }
 
     // Modifiers
     void clear_and_resize(const size_t rows, const size_t cols, const T value = {})
     {
+        reserve(rows, cols);
         _rows = rows;
         _cols = cols;
-        _data.resize(0);
-        _data.resize(rows * cols, value);
+        _stride = get_stride(cols);
+        std::uninitialized_fill_n(_data, _rows * _stride, value);
+    }
+
+    // Allocate memory for a matrix of the given dimensions so that later resizes up to that size do not
+    // reallocate
+    void reserve(const size_t rows, const size_t cols)
+    {
+        const auto size = rows * get_stride(cols);
+        if (size > _capacity)
+        {
+            auto data = allocate(size);
+            if (_data)
+            {
+                std::memcpy(static_cast<void*>(data), _data, _rows * _stride * sizeof(T));
+            }
+            deallocate(_data);
+            _data = data;
+            _capacity = size;
+        }
     }
 
     // Comparison
     inline bool operator==(const Matrix<T>& other) const
     {
-        return _rows == other.rows() && _data == other._data;
+        if (_rows != other._rows || _cols != other._cols)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < _rows; ++i)
+            if (!std::equal(cbegin(i), cend(i), other.cbegin(i)))
+            {
+                return false;
+            }
+        return true;
     }
 
     // Getters
     inline size_t rows() const { return _rows; }
     inline size_t cols() const { return _cols; }
+    inline size_t stride() const { return _stride; }
+    inline T* data() { return _data; }
+    inline const T* data() const { return _data; }
     inline const T operator()(const size_t i, const size_t j) const
     {
 #ifndef NDEBUG
@@ -67,7 +245,7 @@ class Matrix
             std::abort();
         }
 #endif
-        return _data[i * _cols + j];
+        return _data[i * _stride + j];
     }
 
     // Setters
@@ -80,16 +258,83 @@ class Matrix
             std::abort();
         }
 #endif
-        return _data[i * _cols + j];
+        return _data[i * _stride + j];
     }
 
     // Row iterators
-    inline auto begin(const size_t row) { return (&_data[0]) + (row * cols()); }
-    inline auto end(const size_t row) { return (&_data[0]) + ((row + 1) * cols()); }
-    inline auto begin(const size_t row) const { return (&_data[0]) + (row * cols()); }
-    inline auto end(const size_t row) const { return (&_data[0]) + ((row + 1) * cols()); }
-    inline auto cbegin(const size_t row) const { return (&_data[0]) + (row * cols()); }
-    inline auto cend(const size_t row) const { return (&_data[0]) + ((row + 1) * cols()); }
+    inline T* begin(const size_t row) { return _data + row * _stride; }
+    inline T* end(const size_t row) { return _data + row * _stride + _cols; }
+    inline const T* begin(const size_t row) const { return _data + row * _stride; }
+    inline const T* end(const size_t row) const { return _data + row * _stride + _cols; }
+    inline const T* cbegin(const size_t row) const { return _data + row * _stride; }
+    inline const T* cend(const size_t row) const { return _data + row * _stride + _cols; }
+
+    // Row and column views
+    inline RowSpan<T> row(const size_t i) { return {begin(i), _cols}; }
+    inline RowSpan<const T> row(const size_t i) const { return {cbegin(i), _cols}; }
+    inline ColumnView<T> col(const size_t j) { return {_data + j, _stride, _rows}; }
+    inline ColumnView<const T> col(const size_t j) const { return {_data + j, _stride, _rows}; }
+
+    // Reductions over a row
+    inline T row_sum(const size_t i) const
+    {
+        return matrix_reduce(cbegin(i), _cols, T{}, [](const T a, const T b) { return a + b; });
+    }
+    inline T row_min(const size_t i) const
+    {
+        return matrix_reduce(cbegin(i), _cols, std::numeric_limits<T>::max(),
+                             [](const T a, const T b) { return b < a ? b : a; });
+    }
+    inline T row_max(const size_t i) const
+    {
+        return matrix_reduce(cbegin(i), _cols, std::numeric_limits<T>::lowest(),
+                             [](const T a, const T b) { return a < b ? b : a; });
+    }
+
+    // Maximum of the elements of a row selected by a mask, or init if no element is selected
+    template<typename Mask>
+    inline T row_max(const size_t i, const Mask& mask, const T init) const
+    {
+        const auto data = cbegin(i);
+        T result = init;
+        if constexpr (std::is_same_v<Mask, Matrix<bool>>)
+        {
+            for (const auto j : mask.row_bits(i))
+                result = result < data[j] ? data[j] : result;
+        }
+        else
+        {
+            for (size_t j = 0; j < _cols; ++j)
+            {
+                const T value = mask(i, j) ? data[j] : init;
+                result = result < value ? value : result;
+            }
+        }
+        return result;
+    }
+
+    // Reductions over all elements
+    T sum() const
+    {
+        T result{};
+        for (size_t i = 0; i < _rows; ++i)
+            result += row_sum(i);
+        return result;
+    }
+    T min() const
+    {
+        T result = std::numeric_limits<T>::max();
+        for (size_t i = 0; i < _rows; ++i)
+            result = std::min(result, row_min(i));
+        return result;
+    }
+    T max() const
+    {
+        T result = std::numeric_limits<T>::lowest();
+        for (size_t i = 0; i < _rows; ++i)
+            result = std::max(result, row_max(i));
+        return result;
+    }
 
     // Print
     inline void print() const
@@ -102,36 +347,38 @@ class Matrix
     }
 
   private:
-    // Internal print methods
-    template<class U>
-    static inline void print_internal(const Matrix<U>&)
-    {
-        fprintf(stderr, "No implementation to print matrix of arbitrary type\n");
-    }
-    static inline void print_internal(const Matrix<bool>& matrix)
+    // Get the distance between the starts of consecutive rows
+    static inline size_t get_stride(const size_t cols)
     {
-        printf("     ");
-        for (size_t j = 0; j < matrix.cols(); ++j)
-            printf(" %3lu", j);
-        printf("\n");
-        printf("    +");
-        for (size_t j = 0; j < matrix.cols(); ++j)
-            printf("----");
-        printf("\n");
-
-        for (size_t i = 0; i < matrix.rows(); ++i)
+        if constexpr (sizeof(T) <= MATRIX_ALIGNMENT && MATRIX_ALIGNMENT % sizeof(T) == 0)
         {
-            printf("%3lu |", i);
-            for (size_t j = 0; j < matrix.cols(); ++j)
+            constexpr size_t line = MATRIX_ALIGNMENT / sizeof(T);
+            if (cols >= line)
             {
-                if (matrix(i, j))
-                    printf("   1");
-                else
-                    printf("   -");
+                return (cols + line - 1) / line * line;
             }
-            printf("\n");
         }
-        printf("\n");
+        return cols;
+    }
+
+    // Allocate aligned memory
+    static inline T* allocate(const size_t size)
+    {
+        return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(MATRIX_ALIGNMENT)));
+    }
+    static inline void deallocate(T* data)
+    {
+        if (data)
+        {
+            ::operator delete(data, std::align_val_t(MATRIX_ALIGNMENT));
+        }
+    }
+
+    // Internal print methods
+    template<class U>
+    static inline void print_internal(const Matrix<U>&)
+    {
+        fprintf(stderr, "No implementation to print matrix of arbitrary type\n");
     }
     static inline void print_internal(const Matrix<double>& matrix)
     {
@@ -218,7 +465,7 @@ class Matrix
     {
         fprintf(stderr, "No implementation to write matrix of arbitrary type\n");
     }
-    void write_internal(const Matrix<bool>& matrix, const std::string& output_file_path) const
+    void write_internal(const Matrix<double>& matrix, const std::string& output_file_path) const
     {
         // Open file.
         auto f = fopen(output_file_path.c_str(), "w");
@@ -232,14 +479,267 @@ class Matrix
         for (size_t i = 0; i < rows(); ++i)
         {
             for (size_t j = 0; j < cols(); ++j)
-                fprintf(f, " %9u,", matrix(i, j));
+                fprintf(f, " %9.3f,", matrix(i, j));
             fprintf(f, "\n");
         }
 
         // Close file.
         fclose(f);
     }
-    void write_internal(const Matrix<double>& matrix, const std::string& output_file_path) const
+};
+
+
+// Matrix of Booleans packed 64 to a word. Each row starts on a new word and the unused bits at the end
+// of a row are always zero, so rows can be combined and counted one word at a time.
+template<>
+class Matrix<bool>
+{
+  public:
+    using Word = uint64_t;
+    static constexpr size_t WordBits = 64;
+
+    // Reference to one bit
+    class BitReference
+    {
+        Word& _word;
+        Word _mask;
+
+      public:
+        BitReference(Word& word, const Word mask) : _word(word), _mask(mask) {}
+        BitReference(const BitReference&) = default;
+        inline operator bool() const { return _word & _mask; }
+        inline BitReference& operator=(const bool value)
+        {
+            _word = value ? _word | _mask : _word & ~_mask;
+            return *this;
+        }
+        inline BitReference& operator=(const BitReference& other) { return *this = static_cast<bool>(other); }
+    };
+
+    // Range of the columns of the set bits of a row in increasing order
+    class SetBitRange
+    {
+        const Word* _words;
+        size_t _nb_words;
+
+      public:
+        class Iterator
+        {
+            const Word* _words;
+            size_t _nb_words;
+            size_t _word_idx;
+            Word _word;
+
+          public:
+            Iterator(const Word* words, const size_t nb_words, const size_t word_idx)
+                : _words(words),
+                  _nb_words(nb_words),
+                  _word_idx(word_idx),
+                  _word(word_idx < nb_words ? words[word_idx] : 0)
+            {
+                skip_zero_words();
+            }
+            inline size_t operator*() const { return _word_idx * WordBits + __builtin_ctzll(_word); }
+            inline Iterator& operator++()
+            {
+                _word &= _word - 1;
+                skip_zero_words();
+                return *this;
+            }
+            inline bool operator==(const Iterator& other) const
+            {
+                return _word_idx == other._word_idx && _word == other._word;
+            }
+            inline bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+          private:
+            inline void skip_zero_words()
+            {
+                while (_word == 0 && _word_idx < _nb_words && ++_word_idx < _nb_words)
+                    _word = _words[_word_idx];
+            }
+        };
+
+        SetBitRange(const Word* words, const size_t nb_words) : _words(words), _nb_words(nb_words) {}
+        inline Iterator begin() const { return Iterator(_words, _nb_words, 0); }
+        inline Iterator end() const { return Iterator(_words, _nb_words, _nb_words); }
+    };
+
+  protected:
+    size_t _rows{0};
+    size_t _cols{0};
+    size_t _words_per_row{0};
+    std::vector<Word> _data{};
+
+  public:
+    // Constructors and destructors
+    Matrix(const size_t rows, const size_t cols, const bool value = false)
+    {
+        clear_and_resize(rows, cols, value);
+    }
+    Matrix() = default;
+    Matrix(const Matrix<bool>& other) = default;
+    Matrix(Matrix<bool>&& other) = default;
+    ~Matrix() = default;
+
+    // Assignment
+    Matrix<bool>& operator=(const Matrix<bool>& other) = default;
+    Matrix<bool>& operator=(Matrix<bool>&& other) = default;
+    Matrix<bool>& operator=(const bool value)
+    {
+        std::fill(_data.begin(), _data.end(), value ? ~Word(0) : Word(0));
+        if (value)
+        {
+            clear_unused_bits();
+        }
+        return *this;
+    }
+
+    // Modifiers
+    void clear_and_resize(const size_t rows, const size_t cols, const bool value = false)
+    {
+        _rows = rows;
+        _cols = cols;
+        _words_per_row = (cols + WordBits - 1) / WordBits;
+        _data.assign(_rows * _words_per_row, Word(0));
+        *this = value;
+    }
+    void reserve(const size_t rows, const size_t cols)
+    {
+        _data.reserve(rows * ((cols + WordBits - 1) / WordBits));
+    }
+
+    // Comparison
+    inline bool operator==(const Matrix<bool>& other) const
+    {
+        return _rows == other._rows && _cols == other._cols && _data == other._data;
+    }
+
+    // Getters
+    inline size_t rows() const { return _rows; }
+    inline size_t cols() const { return _cols; }
+    inline size_t words_per_row() const { return _words_per_row; }
+    inline bool operator()(const size_t i, const size_t j) const
+    {
+        check_bounds(i, j);
+        return (_data[i * _words_per_row + j / WordBits] >> (j % WordBits)) & 1;
+    }
+
+    // Setters
+    inline BitReference operator()(const size_t i, const size_t j)
+    {
+        check_bounds(i, j);
+        return BitReference(_data[i * _words_per_row + j / WordBits], Word(1) << (j % WordBits));
+    }
+
+    // Words of a row
+    inline Word* row_words(const size_t i) { return _data.data() + i * _words_per_row; }
+    inline const Word* row_words(const size_t i) const { return _data.data() + i * _words_per_row; }
+
+    // Columns of the set bits of a row
+    inline SetBitRange row_bits(const size_t i) const { return {row_words(i), _words_per_row}; }
+
+    // Count the set bits
+    inline size_t row_count(const size_t i) const
+    {
+        const auto words = row_words(i);
+        size_t count = 0;
+        for (size_t k = 0; k < _words_per_row; ++k)
+            count += __builtin_popcountll(words[k]);
+        return count;
+    }
+    inline size_t count() const
+    {
+        size_t count = 0;
+        for (const auto word : _data)
+            count += __builtin_popcountll(word);
+        return count;
+    }
+    inline bool row_any(const size_t i) const
+    {
+        const auto words = row_words(i);
+        for (size_t k = 0; k < _words_per_row; ++k)
+            if (words[k])
+            {
+                return true;
+            }
+        return false;
+    }
+
+    // Combine row i with row k of another matrix with the same number of columns
+    inline void row_and(const size_t i, const Matrix<bool>& other, const size_t k)
+    {
+        auto words = row_words(i);
+        const auto other_words = other.row_words(k);
+        for (size_t w = 0; w < _words_per_row; ++w)
+            words[w] &= other_words[w];
+    }
+    inline void row_or(const size_t i, const Matrix<bool>& other, const size_t k)
+    {
+        auto words = row_words(i);
+        const auto other_words = other.row_words(k);
+        for (size_t w = 0; w < _words_per_row; ++w)
+            words[w] |= other_words[w];
+    }
+    inline void row_and_not(const size_t i, const Matrix<bool>& other, const size_t k)
+    {
+        auto words = row_words(i);
+        const auto other_words = other.row_words(k);
+        for (size_t w = 0; w < _words_per_row; ++w)
+            words[w] &= ~other_words[w];
+    }
+
+    // Combine with another matrix of the same dimensions
+    inline Matrix<bool>& operator&=(const Matrix<bool>& other)
+    {
+        for (size_t w = 0; w < _data.size(); ++w)
+            _data[w] &= other._data[w];
+        return *this;
+    }
+    inline Matrix<bool>& operator|=(const Matrix<bool>& other)
+    {
+        for (size_t w = 0; w < _data.size(); ++w)
+            _data[w] |= other._data[w];
+        return *this;
+    }
+
+    // Get the transpose, which turns columns into rows for iterating over the set bits of a column
+    Matrix<bool> transpose() const
+    {
+        Matrix<bool> result(_cols, _rows);
+        for (size_t i = 0; i < _rows; ++i)
+            for (const auto j : row_bits(i))
+                result(j, i) = true;
+        return result;
+    }
+
+    // Print
+    inline void print() const
+    {
+        printf("     ");
+        for (size_t j = 0; j < cols(); ++j)
+            printf(" %3lu", j);
+        printf("\n");
+        printf("    +");
+        for (size_t j = 0; j < cols(); ++j)
+            printf("----");
+        printf("\n");
+
+        for (size_t i = 0; i < rows(); ++i)
+        {
+            printf("%3lu |", i);
+            for (size_t j = 0; j < cols(); ++j)
+            {
+                if ((*this)(i, j))
+                    printf("   1");
+                else
+                    printf("   -");
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+    void write_to_file(const std::string& output_file_path) const
     {
         // Open file.
         auto f = fopen(output_file_path.c_str(), "w");
@@ -253,13 +753,39 @@ class Matrix
         for (size_t i = 0; i < rows(); ++i)
         {
             for (size_t j = 0; j < cols(); ++j)
-                fprintf(f, " %9.3f,", matrix(i, j));
+                fprintf(f, " %9u,", (*this)(i, j));
             fprintf(f, "\n");
         }
 
         // Close file.
         fclose(f);
     }
+
+  private:
+    inline void check_bounds(const size_t i, const size_t j) const
+    {
+#ifndef NDEBUG
+        if (i >= rows() || j >= cols())
+        {
+            printf("Accessing matrix element (%lu,%lu) is out of bounds\n", i, j);
+            std::abort();
+        }
+#else
+        static_cast<void>(i);
+        static_cast<void>(j);
+#endif
+    }
+
+    // Clear the bits past the last column of each row
+    inline void clear_unused_bits()
+    {
+        if (_cols % WordBits != 0)
+        {
+            const auto mask = (Word(1) << (_cols % WordBits)) - 1;
+            for (size_t i = 0; i < _rows; ++i)
+                row_words(i)[_words_per_row - 1] &= mask;
+        }
+    }
 };
 
 #endif
@@ -0,0 +1,445 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include "ConstraintHandler-Geas.h"
+#include "EventHandler-Checkpoint.h"
+#include "scip/cons_logicor.h"
+#include "scip/cons_bounddisjunction.h"
+#include "geas/solver/solver_data.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+// Checkpoint file layout (native endianness):
+//   magic, version
+//   number of Boolean variables, number of integer variables
+//   objective dual bound, CP dual bound
+//   incumbent flag, incumbent values of Boolean and integer variables
+//   number of nogoods, nogoods
+//   number of CP clauses, CP clauses
+// where each nogood and clause is its size followed by its literals (index, type, sign, bound).
+#define CHECKPOINT_MAGIC                        "NUTMEGCP"
+#define CHECKPOINT_MAGIC_SIZE                            8
+#define CHECKPOINT_VERSION                               1
+
+namespace Nutmeg
+{
+
+// Get the clauses learned by Geas that are stated only on Nutmeg variables
+static
+Vector<Nogood> get_cp_clauses(
+    const ProblemData& probdata,    // Problem data
+    geas::solver& cp                // CP solver
+)
+{
+    // Index the predicates of the variables.
+    HashTable<uint64_t, Vector<Int>> bool_vars_pid;
+    HashTable<uint64_t, Int> int_vars_pid;
+    for (Int idx = 0; idx < probdata.nb_bool_vars(); ++idx)
+    {
+        const auto& cp_var = probdata.cp_bool_vars_[idx];
+        bool_vars_pid[cp_var.pid].push_back(idx);
+        bool_vars_pid[(~cp_var).pid].push_back(idx);
+    }
+    for (Int idx = 0; idx < probdata.nb_int_vars(); ++idx)
+    {
+        int_vars_pid.emplace(probdata.cp_int_vars_[idx].p, idx);
+    }
+
+    // Translate the learnt clauses.
+    Vector<Nogood> clauses;
+    for (auto cl : cp.data->learnts)
+    {
+        auto& clause = clauses.emplace_back();
+        for (Int i = 0; i < cl->size(); ++i)
+        {
+            const auto atom = (*cl)[i].atom;
+
+            // Find a Boolean variable.
+            if (auto it = bool_vars_pid.find(atom.pid); it != bool_vars_pid.end())
+                for (const auto idx : it->second)
+                {
+                    const auto& cp_var = probdata.cp_bool_vars_[idx];
+                    if (atom == cp_var)
+                    {
+                        clause.push_back({idx, false, SCIP_BOUNDTYPE_LOWER, 1});
+                        goto NEXT_LITERAL;
+                    }
+                    else if (atom == ~cp_var)
+                    {
+                        clause.push_back({idx, false, SCIP_BOUNDTYPE_UPPER, 0});
+                        goto NEXT_LITERAL;
+                    }
+                }
+
+            // Find an integer variable.
+            if (auto it = int_vars_pid.find(atom.pid); it != int_vars_pid.end())
+            {
+                const auto idx = it->second;
+                const auto val = probdata.cp_int_vars_[idx].lb_of_pval(atom.val);
+                clause.push_back({idx, true, SCIP_BOUNDTYPE_LOWER, static_cast<Int>(val)});
+                goto NEXT_LITERAL;
+            }
+            else if (auto it = int_vars_pid.find((~atom).pid); it != int_vars_pid.end())
+            {
+                const auto idx = it->second;
+                const auto val = probdata.cp_int_vars_[idx].ub_of_pval(atom.val);
+                clause.push_back({idx, true, SCIP_BOUNDTYPE_UPPER, static_cast<Int>(val)});
+                goto NEXT_LITERAL;
+            }
+
+            // The clause contains an internal variable of Geas so it cannot be stored.
+            clauses.pop_back();
+            break;
+
+            // Next iteration.
+            NEXT_LITERAL:;
+        }
+    }
+
+    // Done.
+    return clauses;
+}
+
+void Model::set_checkpoint(const String& path, const Float interval, const bool save_cp_clauses)
+{
+    // Check.
+    release_assert(method_ == Method::BC, "Checkpointing is only available in branch-and-check");
+    release_assert(!path.empty(), "Path to checkpoint file is empty");
+    release_assert(interval > 0, "Checkpoint interval {} is invalid", interval);
+
+    // Create event handler for writing checkpoints during the search.
+    if (checkpoint_path_.empty())
+    {
+        scip_assert(includeEventHdlrCheckpoint(mip_, this));
+    }
+
+    // Store settings.
+    checkpoint_path_ = path;
+    checkpoint_interval_ = interval;
+    checkpoint_cp_clauses_ = save_cp_clauses;
+}
+
+void Model::write_checkpoint()
+{
+    // Check.
+    release_assert(!checkpoint_path_.empty(), "Path to checkpoint file is not set");
+
+    // Get problem data of the problem being solved.
+    const auto& probdata = *reinterpret_cast<ProblemData*>(SCIPgetProbData(mip_));
+
+    // Get dual bound.
+    Float obj_bound = resume_obj_bound_;
+    if (!std::isnan(obj_bound_) && obj_bound_ > obj_bound)
+    {
+        obj_bound = obj_bound_;
+    }
+    if (const auto stage = SCIPgetStage(mip_); stage >= SCIP_STAGE_TRANSFORMED && stage <= SCIP_STAGE_SOLVED)
+    {
+        const auto new_obj_bound = SCIPceil(mip_, SCIPgetDualbound(mip_));
+        if (new_obj_bound > obj_bound)
+        {
+            obj_bound = new_obj_bound;
+        }
+    }
+    const auto cp_dual_bound = std::max(probdata.cp_dual_bound_, resume_cp_dual_bound_);
+
+    // Check if an incumbent exists.
+    const auto has_sol = static_cast<Int>(sol_.int_vars_sol_.size()) == nb_int_vars() &&
+                         sol_.int_vars_sol_[probdata.obj_var_idx_] != std::numeric_limits<Int>::max();
+
+    // Get clauses from the CP solver.
+    Vector<Nogood> cp_clauses;
+    if (checkpoint_cp_clauses_)
+    {
+        cp_clauses = get_cp_clauses(probdata, cp_);
+        cp_clauses.insert(cp_clauses.end(), resume_cp_clauses_.begin(), resume_cp_clauses_.end());
+    }
+
+    // Write to a temporary file so that an interrupted write does not destroy the previous checkpoint.
+    const auto tmp_path = checkpoint_path_ + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            println("Failed to open checkpoint file {}", tmp_path);
+            return;
+        }
+
+        // Write header.
+        file.write(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+        write_value<uint32_t>(file, CHECKPOINT_VERSION);
+        write_value<Int>(file, nb_bool_vars());
+        write_value<Int>(file, nb_int_vars());
+
+        // Write bounds.
+        write_value<Float>(file, obj_bound);
+        write_value<Int>(file, cp_dual_bound);
+
+        // Write incumbent.
+        write_value<uint8_t>(file, has_sol);
+        if (has_sol)
+        {
+            for (Int idx = 0; idx < nb_bool_vars(); ++idx)
+            {
+                write_value<uint8_t>(file, sol_.bool_vars_sol_[idx]);
+            }
+            for (Int idx = 0; idx < nb_int_vars(); ++idx)
+            {
+                write_value<Int>(file, sol_.int_vars_sol_[idx]);
+            }
+        }
+
+        // Write nogoods.
+        write_value<uint32_t>(file, nogood_pool_.size());
+        for (const auto& nogood : nogood_pool_)
+        {
+            write_nogood(file, nogood);
+        }
+
+        // Write CP clauses.
+        write_value<uint32_t>(file, cp_clauses.size());
+        for (const auto& clause : cp_clauses)
+        {
+            write_nogood(file, clause);
+        }
+
+        // Flush.
+        file.flush();
+        if (!file)
+        {
+            println("Failed to write checkpoint file {}", tmp_path);
+            return;
+        }
+    }
+
+    // Replace the previous checkpoint.
+    if (std::rename(tmp_path.c_str(), checkpoint_path_.c_str()) != 0)
+    {
+        println("Failed to replace checkpoint file {}", checkpoint_path_);
+        return;
+    }
+    last_checkpoint_time_ = get_cpu_time();
+    debugln("Wrote checkpoint with {} nogoods and {} CP clauses", nogood_pool_.size(), cp_clauses.size());
+}
+
+void Model::load_checkpoint(const String& path)
+{
+    // Check.
+    release_assert(method_ == Method::BC, "Checkpointing is only available in branch-and-check");
+    release_assert(SCIPgetStage(mip_) == SCIP_STAGE_PROBLEM, "Checkpoint must be loaded before solving");
+
+    // Open file.
+    std::ifstream file(path, std::ios::binary);
+    release_assert(file, "Cannot open checkpoint file {}", path);
+
+    // Read header.
+    char magic[CHECKPOINT_MAGIC_SIZE];
+    file.read(magic, CHECKPOINT_MAGIC_SIZE);
+    release_assert(file && std::memcmp(magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) == 0,
+                   "File {} is not a checkpoint", path);
+    const auto version = read_value<uint32_t>(file);
+    release_assert(version == CHECKPOINT_VERSION, "Checkpoint version {} is not supported", version);
+    const auto nb_bool_vars = read_value<Int>(file);
+    const auto nb_int_vars = read_value<Int>(file);
+    release_assert(nb_bool_vars == this->nb_bool_vars() && nb_int_vars == this->nb_int_vars(),
+                   "Checkpoint has {} Boolean and {} integer variables but the model has {} and {}",
+                   nb_bool_vars, nb_int_vars, this->nb_bool_vars(), this->nb_int_vars());
+
+    // Read bounds.
+    resume_obj_bound_ = read_value<Float>(file);
+    resume_cp_dual_bound_ = read_value<Int>(file);
+
+    // Read incumbent.
+    resume_sol_.bool_vars_sol_.clear();
+    resume_sol_.int_vars_sol_.clear();
+    if (read_value<uint8_t>(file))
+    {
+        resume_sol_.bool_vars_sol_.resize(nb_bool_vars);
+        resume_sol_.int_vars_sol_.resize(nb_int_vars);
+        for (Int idx = 0; idx < nb_bool_vars; ++idx)
+        {
+            resume_sol_.bool_vars_sol_[idx] = read_value<uint8_t>(file);
+        }
+        for (Int idx = 0; idx < nb_int_vars; ++idx)
+        {
+            resume_sol_.int_vars_sol_[idx] = read_value<Int>(file);
+        }
+    }
+
+    // Read nogoods and add them to the master problem.
+    const auto nb_nogoods = read_value<uint32_t>(file);
+    for (uint32_t n = 0; n < nb_nogoods; ++n)
+    {
+        const auto nogood = read_nogood(file, nb_bool_vars, nb_int_vars);
+        add_nogood(nogood);
+    }
+
+    // Read clauses and add them to the CP solver.
+    const auto nb_cp_clauses = read_value<uint32_t>(file);
+    resume_cp_clauses_.resize(nb_cp_clauses);
+    for (auto& clause : resume_cp_clauses_)
+    {
+        clause = read_nogood(file, nb_bool_vars, nb_int_vars);
+
+        vec<geas::clause_elt> cp_clause;
+        for (const auto& literal : clause)
+            cp_clause.push(probdata_.cp_atom(literal));
+        if (!geas::add_clause(*cp_.data, cp_clause))
+        {
+            status_ = Status::Infeasible;
+        }
+    }
+
+    // Print.
+    println("Loaded checkpoint {} with {} nogoods and {} CP clauses{}",
+            path, nb_nogoods, nb_cp_clauses, resume_sol_.int_vars_sol_.empty() ? "" : " and an incumbent");
+}
+
+bool Model::add_nogood(const Nogood& nogood)
+{
+    // Check.
+    release_assert(SCIPgetStage(mip_) == SCIP_STAGE_PROBLEM, "Nogoods can only be added before solving");
+
+    // If there is zero literals, the problem is infeasible.
+    if (nogood.empty())
+    {
+        status_ = Status::Infeasible;
+        return false;
+    }
+
+    // Get the variables in the MIP.
+    NogoodData data;
+    for (const auto& literal : nogood)
+    {
+        auto mip_var = literal.is_int_var ?
+                       probdata_.mip_int_vars_[literal.var_idx] :
+                       probdata_.mip_bool_vars_[literal.var_idx];
+        release_assert(mip_var, "Nogood contains a variable that is not in the MIP");
+        data.vars.push_back(mip_var);
+        data.signs.push_back(literal.sign);
+        data.bounds.push_back(literal.bound);
+        data.all_binary &= !literal.is_int_var;
+    }
+
+    // If there is one literal, enforce the bound change globally.
+    if (nogood.size() == 1)
+    {
+        auto var = data.vars[0];
+        const auto sign = data.signs[0];
+        const auto bound = data.bounds[0];
+        if (sign == SCIP_BOUNDTYPE_UPPER)
+        {
+            if (SCIPisLT(mip_, bound, SCIPvarGetLbGlobal(var)))
+            {
+                status_ = Status::Infeasible;
+                return false;
+            }
+            else if (SCIPisLT(mip_, bound, SCIPvarGetUbGlobal(var)))
+            {
+                scip_assert(SCIPchgVarUb(mip_, var, bound));
+            }
+        }
+        else
+        {
+            if (SCIPisGT(mip_, bound, SCIPvarGetUbGlobal(var)))
+            {
+                status_ = Status::Infeasible;
+                return false;
+            }
+            else if (SCIPisGT(mip_, bound, SCIPvarGetLbGlobal(var)))
+            {
+                scip_assert(SCIPchgVarLb(mip_, var, bound));
+            }
+        }
+        if (!cp_.post(probdata_.cp_atom(nogood[0])))
+        {
+            status_ = Status::Infeasible;
+            return false;
+        }
+    }
+    else if (data.all_binary)
+    {
+        // Get negated variables.
+        for (size_t idx = 0; idx < data.vars.size(); ++idx)
+            if (data.signs[idx] == SCIP_BOUNDTYPE_UPPER)
+            {
+                scip_assert(SCIPgetNegatedVar(mip_, data.vars[idx], &data.vars[idx]));
+            }
+
+        // Add constraint.
+        SCIP_CONS* cons = nullptr;
+        scip_assert(SCIPcreateConsBasicLogicor(mip_, &cons, "", data.vars.size(), data.vars.data()));
+        debug_assert(cons);
+        scip_assert(SCIPaddCons(mip_, cons));
+        scip_assert(SCIPreleaseCons(mip_, &cons));
+    }
+    else
+    {
+        // Add constraint.
+        SCIP_CONS* cons = nullptr;
+        scip_assert(SCIPcreateConsBasicBounddisjunction(mip_,
+                                                        &cons,
+                                                        "",
+                                                        data.vars.size(),
+                                                        data.vars.data(),
+                                                        data.signs.data(),
+                                                        data.bounds.data()));
+        debug_assert(cons);
+        scip_assert(SCIPaddCons(mip_, cons));
+        scip_assert(SCIPreleaseCons(mip_, &cons));
+    }
+
+    // Store the nogood.
+    nogood_pool_.push_back(nogood);
+    return true;
+}
+
+void Model::resume_from_checkpoint(const IntVar obj_var)
+{
+    // Raise the dual bound.
+    probdata_.cp_dual_bound_ = std::max(probdata_.cp_dual_bound_, resume_cp_dual_bound_);
+    if (resume_obj_bound_ > obj_bound_)
+    {
+        auto var = mip_var(obj_var);
+        if (resume_obj_bound_ > SCIPvarGetUbGlobal(var) ||
+            !cp_.post(cp_var(obj_var) >= static_cast<Int>(resume_obj_bound_)))
+        {
+            status_ = Status::Infeasible;
+            return;
+        }
+        scip_assert(SCIPchgVarLb(mip_, var, resume_obj_bound_));
+        obj_bound_ = resume_obj_bound_;
+        timeline_.add_dual_bound(obj_bound_, BoundSource::Injected);
+    }
+
+    // Inject the incumbent.
+    if (!resume_sol_.int_vars_sol_.empty())
+    {
+        // Store as incumbent.
+        sol_ = resume_sol_;
+        obj_ = sol_.int_vars_sol_[obj_var.idx];
+        timeline_.add_primal_bound(obj_, BoundSource::Injected);
+
+        // Create solution.
+        SCIP_SOL* sol = nullptr;
+        scip_assert(SCIPcreateOrigSol(mip_, &sol, nullptr));
+        for (Int idx = 0; idx < nb_bool_vars(); ++idx)
+            if (probdata_.is_pos_var(idx))
+            {
+                scip_assert(SCIPsetSolVal(mip_, sol, probdata_.mip_bool_vars_[idx], sol_.bool_vars_sol_[idx]));
+            }
+        for (Int idx = 0; idx < nb_int_vars(); ++idx)
+            if (auto var = probdata_.mip_int_vars_[idx]; var)
+            {
+                scip_assert(SCIPsetSolVal(mip_, sol, var, sol_.int_vars_sol_[idx]));
+            }
+
+        // Add solution.
+        SCIP_Bool stored = FALSE;
+        scip_assert(SCIPaddSolFree(mip_, &sol, &stored));
+        debugln("Incumbent from checkpoint with obj {} is {}", obj_, stored ? "stored" : "rejected");
+    }
+}
+
+}
@@ -13,6 +13,9 @@ namespace Nutmeg
 
 bool Model::add_constr_fix(const BoolVar var)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrFix, var);
+
     // Fix variable in MIP.
     {
         const auto var_idx = var.idx;
@@ -45,6 +48,9 @@ bool Model::add_constr_linear(
     const Int rhs
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinear, vars, coeffs, sign, rhs);
+
     // Check.
     release_assert(vars.size() == coeffs.size(),
                    "Vectors of variables and coefficients have different lengths in "
@@ -155,6 +161,9 @@ bool Model::add_constr_linear_neq(
     const Int rhs
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinearNeq, vars, coeffs, rhs);
+
     // Check.
     release_assert(vars.size() == coeffs.size(),
                    "Vectors of variables and coefficients have different lengths in "
@@ -254,6 +263,9 @@ bool Model::add_constr_linear_neq(
 
 bool Model::add_constr_element(const IntVar& idx_var, const Vector<Int>& array, const IntVar& val_var)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrElement, idx_var, array, val_var);
+
     // Create constraint in MIP.
     if (mip_var(idx_var) && mip_var(val_var))
     {
@@ -362,6 +374,9 @@ bool Model::add_constr_element(const IntVar& idx_var, const Vector<Int>& array,
 
 bool Model::add_constr_element(const IntVar& idx_var, const Vector<IntVar>& array, const IntVar& val_var)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrElementVar, idx_var, array, val_var);
+
     // Create constraint in MIP.
     if (mip_var(idx_var) && mip_var(val_var))
     {
@@ -476,6 +491,9 @@ bool Model::add_constr_element(const IntVar& idx_var, const Vector<IntVar>& arra
 
 bool Model::add_constr_alldifferent(const Vector<IntVar>& vars)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrAllDifferent, vars);
+
     // Check.
     for (const auto var : vars)
     {
@@ -0,0 +1,252 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include "ConstraintHandler-Geas.h"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+// Cut file layout: a header line followed by one cut per line. A cut is a disjunction of literals
+// separated by spaces. A literal is one of key, ~key, key>=val and key<=val.
+#define CUTS_FILE_HEADER                 "# Nutmeg cuts 1"
+
+#define MAX_IMPORT_VALIDATION_DURATION                 0.1
+#define MAX_IMPORT_VALIDATION_CONFLICTS                300
+
+namespace Nutmeg
+{
+
+static
+void check_var_key(
+    const String& key    // Key
+)
+{
+    release_assert(!key.empty(), "Variable key is empty");
+    release_assert(key[0] != '~', "Variable key {} cannot start with ~", key);
+    for (const auto c : key)
+    {
+        release_assert(!std::isspace(static_cast<unsigned char>(c)) && c != '<' && c != '>',
+                       "Variable key {} cannot contain whitespace, < or >", key);
+    }
+}
+
+void Model::set_var_key(const BoolVar var, const String& key)
+{
+    // Check.
+    release_assert(var.model == this, "Variable belongs to a different model");
+    release_assert(0 <= var.idx && var.idx < nb_bool_vars(), "Variable is invalid");
+    check_var_key(key);
+
+    // Store key.
+    const auto [it, inserted] = var_keys_.insert({key, {false, var.idx}});
+    release_assert(inserted || (!it->second.first && it->second.second == var.idx),
+                   "Variable key {} is already used", key);
+    if (static_cast<Int>(bool_vars_key_.size()) <= var.idx)
+    {
+        bool_vars_key_.resize(nb_bool_vars());
+    }
+    bool_vars_key_[var.idx] = key;
+}
+
+void Model::set_var_key(const IntVar var, const String& key)
+{
+    // Check.
+    release_assert(var.model == this, "Variable belongs to a different model");
+    release_assert(0 <= var.idx && var.idx < nb_int_vars(), "Variable is invalid");
+    check_var_key(key);
+
+    // Store key.
+    const auto [it, inserted] = var_keys_.insert({key, {true, var.idx}});
+    release_assert(inserted || (it->second.first && it->second.second == var.idx),
+                   "Variable key {} is already used", key);
+    if (static_cast<Int>(int_vars_key_.size()) <= var.idx)
+    {
+        int_vars_key_.resize(nb_int_vars());
+    }
+    int_vars_key_[var.idx] = key;
+}
+
+void Model::set_cuts_export(const String& path)
+{
+    release_assert(method_ == Method::BC, "Exporting cuts is only available in branch-and-check");
+    release_assert(!path.empty(), "Path to file of cuts is empty");
+    cuts_export_path_ = path;
+}
+
+Int Model::export_cuts(const String& path) const
+{
+    // Open file.
+    std::ofstream file(path);
+    release_assert(file, "Cannot open file {} for writing cuts", path);
+    file << CUTS_FILE_HEADER << '\n';
+
+    // Write nogoods whose variables all have keys.
+    Int nb_cuts = 0;
+    String line;
+    for (const auto& nogood : nogood_pool_)
+    {
+        line.clear();
+        for (const auto& literal : nogood)
+        {
+            const auto& keys = literal.is_int_var ? int_vars_key_ : bool_vars_key_;
+            if (literal.var_idx >= static_cast<Int>(keys.size()) || keys[literal.var_idx].empty())
+            {
+                goto NEXT_NOGOOD;
+            }
+            const auto& key = keys[literal.var_idx];
+
+            if (!line.empty())
+            {
+                line += ' ';
+            }
+            if (literal.is_int_var)
+            {
+                line += fmt::format("{}{}{}", key, literal.sign == SCIP_BOUNDTYPE_LOWER ? ">=" : "<=", literal.bound);
+            }
+            else
+            {
+                line += literal.sign == SCIP_BOUNDTYPE_LOWER ? key : '~' + key;
+            }
+        }
+        file << line << '\n';
+        ++nb_cuts;
+
+        // Next iteration.
+        NEXT_NOGOOD:;
+    }
+
+    // Done.
+    release_assert(file, "Failed to write cuts to file {}", path);
+    return nb_cuts;
+}
+
+Int Model::import_cuts(const String& path)
+{
+    // Check.
+    release_assert(method_ == Method::BC, "Importing cuts is only available in branch-and-check");
+    release_assert(SCIPgetStage(mip_) == SCIP_STAGE_PROBLEM, "Cuts must be imported before solving");
+    if (status_ == Status::Infeasible)
+    {
+        return 0;
+    }
+
+    // Open file.
+    std::ifstream file(path);
+    release_assert(file, "Cannot open file {} of cuts", path);
+    String line;
+    std::getline(file, line);
+    release_assert(line == CUTS_FILE_HEADER, "File {} does not contain cuts", path);
+
+    // Read cuts.
+    Int nb_read = 0;
+    Int nb_imported = 0;
+    Vector<geas::patom_t> literals;
+    while (std::getline(file, line))
+    {
+        // Skip empty lines.
+        if (line.empty())
+        {
+            continue;
+        }
+        ++nb_read;
+
+        // Map the literals to variables in this model.
+        literals.clear();
+        std::istringstream tokens(line);
+        for (String token; tokens >> token;)
+        {
+            if (const auto pos = token.find_first_of("<>"); pos != String::npos)
+            {
+                // Find integer variable.
+                release_assert(pos + 2 <= token.size() && token[pos + 1] == '=', "Invalid literal {}", token);
+                const auto it = var_keys_.find(token.substr(0, pos));
+                if (it == var_keys_.end() || !it->second.first)
+                {
+                    goto NEXT_CUT;
+                }
+                const IntVar var(this, it->second.second);
+                if (!mip_var(var) && !has_mip_indicator_vars(var))
+                {
+                    goto NEXT_CUT;
+                }
+
+                // Clip the literal to the domain of the variable.
+                Int val = 0;
+                const auto [end, ec] = std::from_chars(token.data() + pos + 2, token.data() + token.size(), val);
+                release_assert(ec == std::errc() && end == token.data() + token.size(), "Invalid literal {}", token);
+                if (token[pos] == '>')
+                {
+                    if (val <= lb(var))
+                        goto NEXT_CUT;
+                    else if (val <= ub(var))
+                        literals.push_back(cp_var(var) >= val);
+                }
+                else
+                {
+                    if (val >= ub(var))
+                        goto NEXT_CUT;
+                    else if (val >= lb(var))
+                        literals.push_back(cp_var(var) <= val);
+                }
+            }
+            else
+            {
+                // Find Boolean variable.
+                const bool is_neg = token[0] == '~';
+                const auto it = var_keys_.find(is_neg ? token.substr(1) : token);
+                if (it == var_keys_.end() || it->second.first)
+                {
+                    goto NEXT_CUT;
+                }
+                const BoolVar var(this, it->second.second);
+                literals.push_back(is_neg ? ~cp_var(var) : cp_var(var));
+            }
+        }
+
+        // Validate the cut by checking that Geas cannot satisfy the negation of every literal.
+        {
+            cp_.clear_assumptions();
+            bool is_valid = false;
+            for (const auto& literal : literals)
+                if (!cp_.assume(~literal))
+                {
+                    is_valid = true;
+                    break;
+                }
+            if (!is_valid)
+            {
+                const auto cp_result = cp_.solve(limits{.time = MAX_IMPORT_VALIDATION_DURATION,
+                                                        .conflicts = MAX_IMPORT_VALIDATION_CONFLICTS});
+                is_valid = cp_result == geas::solver::UNSAT;
+            }
+            if (!is_valid)
+            {
+                debugln("Rejected cut {}", line);
+                cp_.clear_assumptions();
+                goto NEXT_CUT;
+            }
+        }
+
+        // Add the nogood found by Geas, which is a subset of the cut.
+        {
+            const auto nogood = get_nogood(cp_, probdata_);
+            cp_.clear_assumptions();
+            ++nb_imported;
+            if (!add_nogood(nogood.literals))
+            {
+                break;
+            }
+        }
+
+        // Next iteration.
+        NEXT_CUT:;
+    }
+
+    // Print.
+    println("Imported {} of {} cuts from {}", nb_imported, nb_read, path);
+
+    // Done.
+    return nb_imported;
+}
+
+}
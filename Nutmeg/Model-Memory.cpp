@@ -0,0 +1,168 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include "geas/solver/solver_data.h"
+
+// Fraction of the memory limit at which new nogoods are created as removable cuts
+#define MEMORY_PRESSURE_THRESHOLD                      0.8
+
+// Number of calls between checks of the memory used by the whole model during a solve
+#define MEMORY_CHECK_INTERVAL                          1000
+
+// Estimated size of the header of a clause in Geas
+#define CP_CLAUSE_HEADER_SIZE                          16
+
+namespace Nutmeg
+{
+
+template<class T>
+static inline
+size_t get_vector_memory(
+    const Vector<T>& vector    // Vector
+)
+{
+    return vector.capacity() * sizeof(T);
+}
+
+static
+size_t get_names_memory(
+    const Vector<String>& names    // Names
+)
+{
+    auto memory = get_vector_memory(names);
+    for (const auto& name : names)
+        if (name.capacity() > String().capacity())
+        {
+            memory += name.capacity() + 1;
+        }
+    return memory;
+}
+
+MemoryUsage Model::memory_usage() const
+{
+    MemoryUsage usage;
+
+    // Get memory of the problem data.
+    {
+        const auto& probdata = probdata_;
+        usage.problem_data = sizeof(ProblemData) +
+                             get_vector_memory(probdata.mip_bool_vars_) +
+                             get_vector_memory(probdata.mip_neg_vars_idx_) +
+                             get_vector_memory(probdata.cp_bool_vars_) +
+                             get_vector_memory(probdata.mip_int_vars_) +
+                             get_vector_memory(probdata.mip_indicator_vars_idx_) +
+                             get_vector_memory(probdata.cp_int_vars_) +
+                             get_vector_memory(probdata.int_vars_lb_) +
+                             get_vector_memory(probdata.int_vars_ub_) +
+                             probdata.constants_.size() * (sizeof(Int) + sizeof(IntVar) + sizeof(void*)) +
+                             get_vector_memory(sol_.int_vars_sol_) +
+                             sol_.bool_vars_sol_.capacity() / 8 +
+                             snapshot_.memory();
+        for (const auto& indicator_vars_idx : probdata.mip_indicator_vars_idx_)
+        {
+            usage.problem_data += get_vector_memory(indicator_vars_idx);
+        }
+        usage.names = get_names_memory(probdata.bool_vars_name_) +
+                      get_names_memory(probdata.int_vars_name_) +
+                      get_names_memory(bool_vars_key_) +
+                      get_names_memory(int_vars_key_);
+    }
+
+    // Get memory of the nogood pool.
+    usage.nogood_pool = get_vector_memory(nogood_pool_);
+    for (const auto& nogood : nogood_pool_)
+    {
+        usage.nogood_pool += get_vector_memory(nogood);
+    }
+
+    // Estimate memory of Geas from its predicates and learnt clauses.
+    if (cp_.data)
+    {
+        const auto& state = cp_.data->state;
+        usage.cp = (state.p_vals.size() + state.p_last.size() + state.p_root.size()) * sizeof(geas::pval_t);
+        for (const auto cl : cp_.data->learnts)
+        {
+            usage.cp += CP_CLAUSE_HEADER_SIZE + cl->size() * sizeof(geas::clause_elt);
+        }
+    }
+
+    // Get memory of SCIP.
+    usage.mip = SCIPgetMemUsed(mip_);
+    usage.lp = SCIPgetMemExternEstim(mip_);
+
+    // Done.
+    return usage;
+}
+
+void Model::print_memory_usage() const
+{
+    constexpr Float mb = 1024.0 * 1024.0;
+    const auto usage = memory_usage();
+    println("{:<19}: {:>10}", "Nutmeg Memory", "MB");
+    println("  {:<17}: {:>10.2f}", "problem data", usage.problem_data / mb);
+    println("  {:<17}: {:>10.2f}", "names", usage.names / mb);
+    println("  {:<17}: {:>10.2f}", "nogood pool", usage.nogood_pool / mb);
+    println("  {:<17}: {:>10.2f}", "Geas (estimate)", usage.cp / mb);
+    println("  {:<17}: {:>10.2f}", "SCIP", usage.mip / mb);
+    println("  {:<17}: {:>10.2f}", "LP (estimate)", usage.lp / mb);
+    println("  {:<17}: {:>10.2f}", "total", usage.total() / mb);
+    if (memory_limit_ < Infinity)
+    {
+        println("  {:<17}: {:>10.2f}", "limit", memory_limit_);
+    }
+}
+
+void Model::set_memory_limit(const Float megabytes)
+{
+    release_assert(megabytes > 0, "Memory limit {} is invalid", megabytes);
+    release_assert(method_ == Method::BC || method_ == Method::MIP || method_ == Method::Dichotomic,
+                   "Memory limit is only available in branch-and-check, MIP and dichotomic search");
+    memory_limit_ = megabytes;
+}
+
+void Model::apply_memory_limit()
+{
+    if (memory_limit_ < Infinity)
+    {
+        // Leave the memory used outside of SCIP to the rest of the model.
+        constexpr Float mb = 1024.0 * 1024.0;
+        const auto usage = memory_usage();
+        const auto mip_limit = std::max<Float>(memory_limit_ - (usage.total() - usage.mip - usage.lp) / mb, 1);
+        scip_assert(SCIPsetRealParam(mip_, "limits/memory", mip_limit));
+
+        // Start creating removable nogoods before SCIP stops.
+        probdata_.memory_soft_limit_ = static_cast<int64_t>(MEMORY_PRESSURE_THRESHOLD * mip_limit * mb);
+    }
+    memory_limit_reached_ = false;
+    nb_memory_checks_ = 0;
+}
+
+bool Model::check_memory_limit(bool& memory_pressure)
+{
+    // Skip if there is no limit or if the model was measured recently. The nogood pool and the learnt clauses of
+    // Geas grow during the solve but are not counted in the limit of SCIP.
+    if (memory_limit_ == Infinity || ++nb_memory_checks_ % MEMORY_CHECK_INTERVAL != 0)
+    {
+        return !memory_limit_reached_;
+    }
+
+    // Get the memory used by the whole model.
+    constexpr Float mb = 1024.0 * 1024.0;
+    const auto used = memory_usage().total() / mb;
+
+    // Create removable nogoods when approaching the limit.
+    if (!memory_pressure && used > MEMORY_PRESSURE_THRESHOLD * memory_limit_)
+    {
+        println("Memory usage is approaching the limit, creating removable nogoods");
+        memory_pressure = true;
+    }
+
+    // Stop at the limit.
+    if (used > memory_limit_)
+    {
+        memory_limit_reached_ = true;
+    }
+    return !memory_limit_reached_;
+}
+
+}
@@ -0,0 +1,110 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include <fstream>
+#include <cctype>
+
+namespace Nutmeg
+{
+
+Method get_method(const String& name)
+{
+    String lower_name(name);
+    for (auto& c : lower_name)
+    {
+        c = std::tolower(static_cast<unsigned char>(c));
+    }
+
+    if (lower_name == "bc")
+        return Method::BC;
+    else if (lower_name == "lbbd")
+        return Method::LBBD;
+    else if (lower_name == "cp")
+        return Method::CP;
+    else if (lower_name == "mip")
+        return Method::MIP;
+    else if (lower_name == "dichotomic")
+        return Method::Dichotomic;
+    else
+        err("Invalid method {}", name);
+}
+
+const char* get_method_name(const Method method)
+{
+    return method == Method::BC ? "BC" :
+           method == Method::LBBD ? "LBBD" :
+           method == Method::CP ? "CP" :
+           method == Method::MIP ? "MIP" :
+           method == Method::Dichotomic ? "Dichotomic" :
+           "Unknown";
+}
+
+const char* get_status_name(const Status status)
+{
+    return status == Status::Unknown ? "Unknown" :
+           status == Status::Optimal ? "Optimal" :
+           status == Status::Feasible ? "Feasible" :
+           status == Status::Infeasible ? "Infeasible" :
+           "Error";
+}
+
+int64_t Model::get_nb_nodes() const
+{
+    if (method_ == Method::BC || method_ == Method::MIP || method_ == Method::Dichotomic)
+    {
+        const auto stage = SCIPgetStage(mip_);
+        if (stage >= SCIP_STAGE_TRANSFORMED && stage <= SCIP_STAGE_SOLVED)
+        {
+            return SCIPgetNTotalNodes(mip_);
+        }
+    }
+    return 0;
+}
+
+// Format a number as JSON
+static
+String json_number(const Float value)
+{
+    return std::isfinite(value) ? fmt::format("{}", value) : String("null");
+}
+
+void Model::write_results(const String& path) const
+{
+    // Open file.
+    std::ofstream file(path);
+    release_assert(file, "Cannot open file {} for writing results", path);
+
+    // Write results as a flat JSON object.
+    const auto has_sol = status_ == Status::Optimal || status_ == Status::Feasible;
+    const auto& stats = stats_;
+    file << "{";
+    file << fmt::format("\"method\": \"{}\"", get_method_name(method_));
+    file << fmt::format(", \"status\": \"{}\"", get_status_name(status_));
+    file << fmt::format(", \"runtime\": {}", json_number(run_time_));
+    file << fmt::format(", \"primal_bound\": {}", has_sol ? json_number(obj_) : "null");
+    file << fmt::format(", \"dual_bound\": {}", status_ != Status::Infeasible ? json_number(obj_bound_) : "null");
+    file << fmt::format(", \"nodes\": {}", get_nb_nodes());
+    file << fmt::format(", \"time_to_first_feasible\": {}", json_number(timeline_.time_to_first_feasible()));
+    file << fmt::format(", \"primal_integral\": {}", json_number(timeline_.primal_integral()));
+    file << fmt::format(", \"primal_dual_integral\": {}", json_number(timeline_.primal_dual_integral()));
+    file << fmt::format(", \"memory_mb\": {:.2f}", memory_usage().total() / (1024.0 * 1024.0));
+    file << fmt::format(", \"nb_bool_vars\": {}", nb_bool_vars());
+    file << fmt::format(", \"nb_int_vars\": {}", nb_int_vars());
+    file << fmt::format(", \"check_calls\": {}", stats.check.nb_calls);
+    file << fmt::format(", \"check_time\": {}", stats.check.time);
+    file << fmt::format(", \"separate_calls\": {}", stats.separate.nb_calls);
+    file << fmt::format(", \"separate_time\": {}", stats.separate.time);
+    file << fmt::format(", \"propagate_calls\": {}", stats.propagate.nb_calls);
+    file << fmt::format(", \"propagate_time\": {}", stats.propagate.time);
+    file << fmt::format(", \"propagate_reductions\": {}", stats.propagate.nb_reductions);
+    file << fmt::format(", \"minimize_cut_time\": {}", stats.minimize_cut.time);
+    file << fmt::format(", \"logicor_cuts\": {}", stats.nb_logicor_cuts);
+    file << fmt::format(", \"bounddisjunction_cuts\": {}", stats.nb_bounddisjunction_cuts);
+    file << fmt::format(", \"bound_changes\": {}", stats.nb_bound_changes);
+    file << fmt::format(", \"cutoffs\": {}", stats.nb_cutoffs);
+    file << fmt::format(", \"nogood_literals\": {}", stats.nb_nogood_literals);
+    file << "}\n";
+    release_assert(file, "Failed to write results to file {}", path);
+}
+
+}
@@ -0,0 +1,25 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include "Separator-Routing.h"
+
+namespace Nutmeg
+{
+
+void Model::add_routing_cuts(
+    const ArcMatrix<BoolVar>& vars,    // Arc variables
+    const Vector<Int>& demand,         // Demand of each node
+    const Int capacity,                // Capacity of a vehicle
+    const Int start_depot,             // Node at which routes start
+    const Int end_depot                // Node at which routes end
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddRoutingCuts,
+                                       vars, demand, capacity, start_depot, end_depot);
+
+    // Include separator in MIP. The cuts are implied by the constraints on the routes in CP.
+    scip_assert(includeSepaRouting(mip_, this, vars, demand, capacity, start_depot, end_depot));
+}
+
+}
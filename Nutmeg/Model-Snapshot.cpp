@@ -0,0 +1,225 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+
+namespace Nutmeg
+{
+
+void Model::enable_snapshot()
+{
+    // Check.
+    release_assert(nb_bool_vars() == 2 && nb_int_vars() == 1 && status_ == Status::Unknown,
+                   "Snapshot must be enabled before creating variables and constraints");
+
+    // Start recording.
+    snapshot_.enable();
+}
+
+void Model::save_snapshot(const String& path) const
+{
+    // Check.
+    release_assert(snapshot_.is_enabled(), "Cannot save snapshot because recording is not enabled");
+
+    // Write.
+    snapshot_.save(path, static_cast<uint32_t>(method_), nb_bool_vars(), nb_int_vars());
+    debugln("Saved snapshot {} with {} calls in {} bytes", path, snapshot_.nb_ops(), snapshot_.data().size());
+}
+
+void Model::load_snapshot(const String& path)
+{
+    // Check.
+    release_assert(nb_bool_vars() == 2 && nb_int_vars() == 1 && status_ == Status::Unknown,
+                   "Snapshot {} must be loaded into an empty model", path);
+
+    // Open snapshot.
+    const auto start_time = clock();
+    SnapshotReader reader(path, this);
+    const auto& header = reader.header();
+    release_assert(header.method <= static_cast<uint32_t>(Method::Dichotomic), "Snapshot {} is corrupted", path);
+    release_assert(header.method == static_cast<uint32_t>(method_),
+                   "Snapshot {} was saved for method {} instead of {}",
+                   path, get_method_name(static_cast<Method>(header.method)), get_method_name(method_));
+
+    // Allocate the variables at once.
+    probdata_.mip_bool_vars_.reserve(header.nb_bool_vars);
+    probdata_.mip_neg_vars_idx_.reserve(header.nb_bool_vars);
+    probdata_.cp_bool_vars_.reserve(header.nb_bool_vars);
+    probdata_.bool_vars_name_.reserve(header.nb_bool_vars);
+    probdata_.mip_int_vars_.reserve(header.nb_int_vars);
+    probdata_.mip_indicator_vars_idx_.reserve(header.nb_int_vars);
+    probdata_.cp_int_vars_.reserve(header.nb_int_vars);
+    probdata_.int_vars_lb_.reserve(header.nb_int_vars);
+    probdata_.int_vars_ub_.reserve(header.nb_int_vars);
+    probdata_.int_vars_name_.reserve(header.nb_int_vars);
+
+    // Replay the calls, reusing the buffers of the arguments.
+    String name;
+    bool flag;
+    Int val1;
+    Int val2;
+    Int val3;
+    Sign sign;
+    BoolVar bool_var;
+    IntVar int_var1;
+    IntVar int_var2;
+    Vector<Int> ints1;
+    Vector<Int> ints2;
+    Vector<Vector<Int>> ints_matrix;
+    Matrix<Int> table;
+    Vector<BoolVar> bool_vars;
+    Vector<IntVar> int_vars;
+    ArcSet arcs;
+    for (uint64_t op_idx = 0; op_idx < header.nb_ops; ++op_idx)
+    {
+        SnapshotOp op;
+        reader(op);
+        switch (op)
+        {
+            case SnapshotOp::AddBoolVar:
+                reader(name);
+                add_bool_var(name);
+                break;
+            case SnapshotOp::AddIntVar:
+                reader(val1, val2, flag, name);
+                add_int_var(val1, val2, flag, name);
+                break;
+            case SnapshotOp::AddIndicatorVars:
+                reader(int_var1, ints1);
+                add_indicator_vars(int_var1, ints1);
+                break;
+            case SnapshotOp::AddMipVar:
+                reader(int_var1);
+                add_mip_var(int_var1);
+                break;
+            case SnapshotOp::AddMipIntVarAsBoolVarAlias:
+                reader(bool_var, int_var1);
+                add_mip_int_var_as_bool_var_alias(bool_var, int_var1);
+                break;
+            case SnapshotOp::GetNeg:
+                reader(bool_var);
+                get_neg(bool_var);
+                break;
+            case SnapshotOp::MarkAsInfeasible:
+                mark_as_infeasible();
+                break;
+            case SnapshotOp::ConstrFix:
+                reader(bool_var);
+                add_constr_fix(bool_var);
+                break;
+            case SnapshotOp::ConstrLinear:
+                reader(int_vars, ints1, sign, val1);
+                add_constr_linear(int_vars, ints1, sign, val1);
+                break;
+            case SnapshotOp::ConstrLinearNeq:
+                reader(int_vars, ints1, val1);
+                add_constr_linear_neq(int_vars, ints1, val1);
+                break;
+            case SnapshotOp::ConstrElement:
+                reader(int_var1, ints1, int_var2);
+                add_constr_element(int_var1, ints1, int_var2);
+                break;
+            case SnapshotOp::ConstrElementVar:
+                reader(int_var1, int_vars, int_var2);
+                add_constr_element(int_var1, int_vars, int_var2);
+                break;
+            case SnapshotOp::ConstrAllDifferent:
+                reader(int_vars);
+                add_constr_alldifferent(int_vars);
+                break;
+            case SnapshotOp::ConstrLinearBool:
+                reader(bool_vars, ints1, sign, val1, int_var1, val2);
+                add_constr_linear(bool_vars, ints1, sign, val1, int_var1, val2);
+                break;
+            case SnapshotOp::ConstrLinearIndicator:
+                reader(int_vars, ints_matrix, sign, val1, int_var1, val2);
+                add_constr_linear(int_vars, ints_matrix, sign, val1, int_var1, val2);
+                break;
+            case SnapshotOp::ConstrSetPartition:
+                reader(bool_vars);
+                add_constr_set_partition(bool_vars);
+                break;
+            case SnapshotOp::ConstrSubtractionLeq:
+                reader(int_var1, int_var2, val1);
+                add_constr_subtraction_leq(int_var1, int_var2, val1);
+                break;
+            case SnapshotOp::ConstrReifySubtractionLeq:
+                reader(bool_var, int_var1, int_var2, val1);
+                add_constr_reify_subtraction_leq(bool_var, int_var1, int_var2, val1);
+                break;
+            case SnapshotOp::ConstrImply:
+                reader(bool_var, flag, int_var1, sign, val1);
+                add_constr_imply(bool_var, flag, int_var1, sign, val1);
+                break;
+            case SnapshotOp::ConstrCumulative:
+                reader(int_vars, ints1, ints2, val1);
+                add_constr_cumulative(int_vars, ints1, ints2, val1);
+                break;
+            case SnapshotOp::ConstrCumulativeOptional:
+                reader(bool_vars, int_vars, ints1, ints2, val1, int_var1);
+                add_constr_cumulative_optional(bool_vars, int_vars, ints1, ints2, val1, int_var1);
+                break;
+            case SnapshotOp::AddRoutingCuts:
+            {
+                reader(arcs, bool_vars, ints1, val1, val2, val3);
+                release_assert(bool_vars.size() == arcs.nb_arcs(), "Snapshot {} is corrupted", path);
+                ArcMatrix<BoolVar> arc_vars(arcs);
+                std::copy(bool_vars.begin(), bool_vars.end(), arc_vars.begin());
+                add_routing_cuts(arc_vars, ints1, val1, val2, val3);
+                break;
+            }
+            case SnapshotOp::ConstrCircuit:
+            {
+                reader(arcs, bool_vars);
+                release_assert(bool_vars.size() == arcs.nb_arcs(), "Snapshot {} is corrupted", path);
+                ArcMatrix<BoolVar> arc_vars(arcs);
+                std::copy(bool_vars.begin(), bool_vars.end(), arc_vars.begin());
+                add_constr_circuit(arc_vars);
+                break;
+            }
+            case SnapshotOp::ConstrPaths:
+            {
+                reader(arcs, bool_vars, val1, val2);
+                release_assert(bool_vars.size() == arcs.nb_arcs(), "Snapshot {} is corrupted", path);
+                ArcMatrix<BoolVar> arc_vars(arcs);
+                std::copy(bool_vars.begin(), bool_vars.end(), arc_vars.begin());
+                add_constr_paths(arc_vars, val1, val2);
+                break;
+            }
+            case SnapshotOp::ConstrDisjunctive:
+                reader(int_vars, ints1);
+                add_constr_disjunctive(int_vars, ints1);
+                break;
+            case SnapshotOp::ConstrDisjunctiveOptional:
+                reader(bool_vars, int_vars, ints1, int_var1);
+                add_constr_disjunctive_optional(bool_vars, int_vars, ints1, int_var1);
+                break;
+            case SnapshotOp::ConstrTable:
+                reader(int_vars, table);
+                add_constr_table(int_vars, table);
+                break;
+            case SnapshotOp::ConstrBinPacking:
+                reader(int_vars, ints1, bool_vars, val1, int_var1);
+                add_constr_bin_packing(int_vars, ints1, bool_vars, val1, int_var1);
+                break;
+            case SnapshotOp::ConstrLinearImply:
+                reader(bool_var, int_vars, ints1, sign, val1);
+                add_constr_linear_imply(bool_var, int_vars, ints1, sign, val1);
+                break;
+            case SnapshotOp::ConstrLinearReif:
+                reader(bool_var, int_vars, ints1, sign, val1);
+                add_constr_linear_reif(bool_var, int_vars, ints1, sign, val1);
+                break;
+            default:
+                err("Snapshot {} has invalid call {}", path, static_cast<Int>(op));
+        }
+    }
+
+    // Check.
+    release_assert(reader.at_end() && nb_bool_vars() == header.nb_bool_vars && nb_int_vars() == header.nb_int_vars,
+                   "Snapshot {} does not rebuild the model it was saved from", path);
+
+    // Print.
+    println("Loaded snapshot {} with {} calls in {:.2f} seconds", path, header.nb_ops, get_elapsed_time(start_time));
+}
+
+}
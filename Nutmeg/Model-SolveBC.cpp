@@ -51,6 +51,16 @@ void Model::minimize_using_bc(
     sol_.bool_vars_sol_.resize(nb_bool_vars());
     sol_.int_vars_sol_.resize(nb_int_vars(), std::numeric_limits<Int>::max());
 
+    // Keep the nogoods if they are written to a checkpoint or exported.
+    probdata_.record_nogoods_ = !checkpoint_path_.empty() || !cuts_export_path_.empty();
+
+    // Continue from a checkpoint.
+    resume_from_checkpoint(obj_var);
+    if (status_ == Status::Infeasible)
+    {
+        goto EXIT;
+    }
+
     // Write LP to file.
 //    scip_assert(SCIPwriteOrigProblem(mip_, "model.lp", 0, 0));
 
@@ -66,6 +76,7 @@ void Model::minimize_using_bc(
         scip_assert(SCIPsetRealParam(mip_, "limits/time", time_limit));
     }
     start_timer(time_limit);
+    apply_memory_limit();
 
     // Solve.
     scip_assert(SCIPsolve(mip_));
@@ -83,7 +94,12 @@ void Model::minimize_using_bc(
 
     // Get status.
     scip_status = SCIPgetStatus(mip_);
+    if (scip_status == SCIP_STATUS_USERINTERRUPT && memory_limit_reached_)
+    {
+        scip_status = SCIP_STATUS_MEMLIMIT;
+    }
     release_assert(scip_status == SCIP_STATUS_TIMELIMIT ||
+                   scip_status == SCIP_STATUS_MEMLIMIT ||
                    scip_status == SCIP_STATUS_OPTIMAL ||
                    scip_status == SCIP_STATUS_INFEASIBLE ||
                    scip_status == SCIP_STATUS_USERINTERRUPT,
@@ -126,7 +142,11 @@ void Model::minimize_using_bc(
     }
     else
     {
-        debug_assert(scip_status == SCIP_STATUS_TIMELIMIT);
+        debug_assert(scip_status == SCIP_STATUS_TIMELIMIT || scip_status == SCIP_STATUS_MEMLIMIT);
+        if (scip_status == SCIP_STATUS_MEMLIMIT)
+        {
+            println("Stopped at memory limit of {} MB", memory_limit_);
+        }
         if (sol)
         {
             status_ = Status::Feasible;
@@ -137,6 +157,12 @@ void Model::minimize_using_bc(
         }
     }
 
+    // Write final checkpoint.
+    if (!checkpoint_path_.empty())
+    {
+        write_checkpoint();
+    }
+
     // Print status.
     EXIT:
     if (verbose)
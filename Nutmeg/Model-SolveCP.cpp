@@ -46,6 +46,7 @@ void Model::minimize_using_cp(
         // Store objective value.
         obj_ = probdata_.cp_int_vars_[obj_var.idx].lb(cp_.data);
         debug_assert(obj_ < sol_.int_vars_sol_[obj_var.idx]);
+        timeline_.add_primal_bound(obj_, BoundSource::CPSearch);
 
         // Store solution.
         for (Int idx = 0; idx < nb_bool_vars(); ++idx)
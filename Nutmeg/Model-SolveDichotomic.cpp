@@ -0,0 +1,288 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+
+namespace Nutmeg
+{
+
+void Model::minimize_using_dichotomic(
+    const IntVar obj_var,
+    const Float time_limit,
+    const bool verbose
+)
+{
+    // Declare.
+    SCIP_STATUS scip_status = SCIP_STATUS_UNKNOWN;
+    SCIP_SOL* sol;
+    SCIP_VAR* mip_obj_var;
+    bool proved = false;
+    Int nb_probes = 0;
+    Int obj_lb = 0;
+    Int obj_ub = 0;
+    size_t nb_replayed_nogoods = 0;
+    int64_t nb_dropped_nogoods = 0;
+
+    // Check for failure at the root level.
+    if (status_ == Status::Infeasible)
+    {
+        goto EXIT;
+    }
+
+    // Add objective function.
+    release_assert(obj_var.model == this, "Objective variable belongs to a different model");
+    release_assert(0 <= obj_var.idx && obj_var.idx < nb_int_vars(), "Objective variable is invalid");
+    release_assert(mip_var(obj_var), "Objective variable is not in the MIP model");
+    mip_obj_var = mip_var(obj_var);
+    scip_assert(SCIPchgVarObj(mip_, mip_obj_var, 1.0));
+    probdata_.obj_var_idx_ = obj_var.idx;
+
+    // Set dual bound.
+    obj_bound_ = lb(obj_var);
+
+    // Add variables to monitor of bounds changes.
+    for (Int idx = 0; idx < nb_bool_vars(); ++idx)
+    {
+        probdata_.bool_vars_monitor_.monitor(geas::atom_var(probdata_.cp_bool_vars_[idx]), idx);
+    }
+    for (Int idx = 0; idx < nb_int_vars(); ++idx)
+        if (probdata_.mip_int_vars_[idx])
+        {
+            probdata_.int_vars_monitor_.monitor(probdata_.cp_int_vars_[idx], idx);
+        }
+    if (!cp_.is_consistent())
+    {
+        status_ = Status::Infeasible;
+        goto EXIT;
+    }
+
+    // Create space to store solution.
+    sol_.bool_vars_sol_.resize(nb_bool_vars());
+    sol_.int_vars_sol_.resize(nb_int_vars(), std::numeric_limits<Int>::max());
+
+    // Keep the nogoods to replay them in the next probe.
+    probdata_.record_nogoods_ = true;
+    nb_dropped_nogoods = stats_.nb_dropped_nogoods;
+
+    // Turn off screen log.
+    if (!verbose)
+    {
+        scip_assert(SCIPsetIntParam(mip_, "display/verblevel", 0));
+    }
+
+    // Stop every probe at its first solution.
+    scip_assert(SCIPsetIntParam(mip_, "limits/solutions", 1));
+
+    // Start timer.
+    start_timer(time_limit);
+    apply_memory_limit();
+
+    // Bisect the range of the objective value. Every probe is a branch-and-check solve of the master problem
+    // with the objective variable bounded to the lower half of the remaining range. The transformed problem is
+    // freed between probes, so the nogoods found by the earlier probes are replayed from the nogood pool into
+    // the next master problem. The CP solver is kept between probes. The first probe is unbounded to find an
+    // incumbent.
+    obj_lb = SCIPceil(mip_, SCIPvarGetLbGlobal(mip_obj_var));
+    obj_ub = SCIPfloor(mip_, SCIPvarGetUbGlobal(mip_obj_var));
+    while (obj_lb <= obj_ub)
+    {
+        // Replay the nogoods found by the previous probe.
+        if (nb_probes > 0)
+        {
+            scip_assert(SCIPfreeTransform(mip_));
+            scip_assert(SCIPchgVarUb(mip_, mip_obj_var, obj_ub));
+            scip_assert(SCIPchgVarLb(mip_, mip_obj_var, obj_lb));
+
+            const auto nb_dropped = static_cast<size_t>(stats_.nb_dropped_nogoods - nb_dropped_nogoods);
+            nb_replayed_nogoods = nb_replayed_nogoods > nb_dropped ? nb_replayed_nogoods - nb_dropped : 0;
+            nb_dropped_nogoods = stats_.nb_dropped_nogoods;
+            Vector<Nogood> nogoods(std::make_move_iterator(nogood_pool_.begin() + nb_replayed_nogoods),
+                                   std::make_move_iterator(nogood_pool_.end()));
+            nogood_pool_.resize(nb_replayed_nogoods);
+            for (const auto& nogood : nogoods)
+                if (!add_nogood(nogood))
+                {
+                    // No solution is better than the incumbent.
+                    proved = true;
+                    goto STOP;
+                }
+            nb_replayed_nogoods = nogood_pool_.size();
+
+            // Get the bounds tightened by the nogoods.
+            obj_lb = std::max<Int>(obj_lb, SCIPceil(mip_, SCIPvarGetLbGlobal(mip_obj_var)));
+            obj_ub = std::min<Int>(obj_ub, SCIPfloor(mip_, SCIPvarGetUbGlobal(mip_obj_var)));
+            if (obj_lb > obj_ub)
+            {
+                proved = true;
+                break;
+            }
+        }
+
+        // Check the time limit.
+        if (get_time_remaining() <= 0)
+        {
+            break;
+        }
+
+        // Bound the objective value.
+        const Int mid = obj_ < Infinity ? obj_lb + (obj_ub - obj_lb) / 2 : obj_ub;
+        debugln("Probe {}: objective value in [{}, {}]", nb_probes, obj_lb, mid);
+        ++nb_probes;
+        scip_assert(SCIPchgVarUb(mip_, mip_obj_var, mid));
+        probdata_.cp_dual_bound_ = std::max(probdata_.cp_dual_bound_, obj_lb);
+
+        // Solve.
+        if (get_time_remaining() < Infinity)
+        {
+            scip_assert(SCIPsetRealParam(mip_, "limits/time", get_time_remaining()));
+        }
+        scip_assert(SCIPsolve(mip_));
+
+        // Get status.
+        scip_status = SCIPgetStatus(mip_);
+        if (scip_status == SCIP_STATUS_USERINTERRUPT && memory_limit_reached_)
+        {
+            scip_status = SCIP_STATUS_MEMLIMIT;
+        }
+        release_assert(scip_status == SCIP_STATUS_TIMELIMIT ||
+                       scip_status == SCIP_STATUS_MEMLIMIT ||
+                       scip_status == SCIP_STATUS_SOLLIMIT ||
+                       scip_status == SCIP_STATUS_OPTIMAL ||
+                       scip_status == SCIP_STATUS_INFEASIBLE ||
+                       scip_status == SCIP_STATUS_USERINTERRUPT,
+                       "Invalid SCIP status {} after solving", scip_status);
+
+        // Get solution.
+        sol = SCIPgetBestSol(mip_);
+        if (sol && SCIPround(mip_, SCIPgetSolOrigObj(mip_, sol)) > mid)
+        {
+            sol = nullptr;
+        }
+        if (sol)
+        {
+            // Store objective value.
+            obj_ = SCIPround(mip_, SCIPgetSolOrigObj(mip_, sol));
+            release_assert(obj_ == sol_.int_vars_sol_[obj_var.idx],
+                           "Objective value mismatch {} {}", obj_, sol_.int_vars_sol_[obj_var.idx]);
+
+            // Tighten primal bound.
+            obj_ub = obj_ - 1;
+        }
+
+        // Tighten dual bound.
+        if (scip_status == SCIP_STATUS_OPTIMAL ||
+            scip_status == SCIP_STATUS_INFEASIBLE ||
+            scip_status == SCIP_STATUS_USERINTERRUPT)
+        {
+            // The probe has no solution below its own.
+            obj_lb = sol ? obj_ + 1 : mid + 1;
+        }
+        else if (scip_status == SCIP_STATUS_SOLLIMIT)
+        {
+            obj_lb = std::max<Int>(obj_lb, SCIPceil(mip_, SCIPgetDualbound(mip_)));
+        }
+        else
+        {
+            // Ran out of time or memory.
+            if (scip_status == SCIP_STATUS_MEMLIMIT)
+            {
+                println("Stopped at memory limit of {} MB", memory_limit_);
+            }
+            break;
+        }
+        if (obj_lb > obj_bound_ && obj_lb <= obj_ub)
+        {
+            obj_bound_ = obj_lb;
+            timeline_.add_dual_bound(obj_bound_, BoundSource::Relaxation);
+            if (verbose)
+            {
+                println("Raised objective bound to {}", obj_bound_);
+            }
+        }
+    }
+    if (obj_lb > obj_ub)
+    {
+        proved = true;
+    }
+    STOP:
+
+    // Stop timer.
+    run_time_ = get_cpu_time();
+
+    // Print statistics.
+    if (verbose && SCIPgetStage(mip_) >= SCIP_STAGE_TRANSFORMED)
+    {
+        println("");
+        scip_assert(SCIPprintStatistics(mip_, nullptr));
+    }
+
+    // Get status.
+    EXIT:
+    const auto found_sol = obj_ < Infinity;
+    if (proved)
+    {
+        if (found_sol)
+        {
+            status_ = Status::Optimal;
+            obj_bound_ = obj_;
+        }
+        else
+        {
+            status_ = Status::Infeasible;
+        }
+    }
+    else if (status_ != Status::Infeasible)
+    {
+        if (found_sol)
+        {
+            status_ = Status::Feasible;
+        }
+        else
+        {
+            status_ = Status::Unknown;
+        }
+    }
+
+    // Print status.
+    if (verbose)
+    {
+        println("");
+        println("--------------------------------------------------");
+        println("Method: Dichotomic");
+        println("CPU time: {:.2f} seconds", run_time_);
+        println("Probes: {}", nb_probes);
+        println("Status: {}",
+                status_ == Status::Unknown ? "Unknown" :
+                status_ == Status::Optimal ? "Optimal" :
+                status_ == Status::Feasible ? "Feasible" :
+                status_ == Status::Infeasible ? "Infeasible" :
+                "Error");
+        if (obj_ < Infinity)
+        {
+            println("Objective value: {:.2f}", obj_);
+        }
+        if (obj_bound_ > -Infinity && status_ != Status::Infeasible)
+        {
+            println("Objective bound: {:.2f}", obj_bound_);
+        }
+        println("--------------------------------------------------");
+    }
+
+    // Print solution.
+#ifdef PRINT_DEBUG
+    if (status_ == Status::Optimal || status_ == Status::Feasible)
+    {
+        println("");
+        println("Solution:");
+        for (Int idx = 0; idx < nb_int_vars(); ++idx)
+        {
+            println("   {} = {}", probdata_.int_vars_name_[idx], sol_.int_vars_sol_[idx]);
+        }
+        for (Int idx = 0; idx < nb_bool_vars(); ++idx)
+        {
+            println("   {} = {}", probdata_.bool_vars_name_[idx], sol_.bool_vars_sol_[idx]);
+        }
+    }
+#endif
+}
+
+}
@@ -37,6 +37,7 @@ void Model::minimize_using_mip(
         scip_assert(SCIPsetRealParam(mip_, "limits/time", time_limit));
     }
     start_timer(time_limit);
+    apply_memory_limit();
 
     // Solve.
     scip_assert(SCIPsolve(mip_));
@@ -52,6 +53,7 @@ void Model::minimize_using_mip(
     // Get status.
     const auto status = SCIPgetStatus(mip_);
     release_assert(status == SCIP_STATUS_TIMELIMIT ||
+                   status == SCIP_STATUS_MEMLIMIT ||
                    status == SCIP_STATUS_OPTIMAL ||
                    status == SCIP_STATUS_INFEASIBLE,
                    "Invalid status {} after solving", status);
@@ -102,7 +104,11 @@ void Model::minimize_using_mip(
     }
     else
     {
-        debug_assert(status == SCIP_STATUS_TIMELIMIT);
+        debug_assert(status == SCIP_STATUS_TIMELIMIT || status == SCIP_STATUS_MEMLIMIT);
+        if (status == SCIP_STATUS_MEMLIMIT)
+        {
+            println("Stopped at memory limit of {} MB", memory_limit_);
+        }
         if (sol)
         {
             status_ = Status::Feasible;
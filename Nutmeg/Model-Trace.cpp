@@ -0,0 +1,109 @@
+//#define PRINT_DEBUG
+
+#include "Model.h"
+#include "ConstraintHandler-Geas.h"
+
+namespace Nutmeg
+{
+
+void Model::set_trace(const String& path)
+{
+    release_assert(method_ == Method::BC, "Tracing is only available in branch-and-check");
+    trace_path_ = path;
+}
+
+void Model::replay_trace(const String& path)
+{
+    // Check.
+    release_assert(method_ == Method::BC, "Replaying a trace is only available in branch-and-check");
+    release_assert(status_ != Status::Infeasible, "Cannot replay a trace on an infeasible model");
+
+    // Read trace.
+    const auto records = Trace::read(path, nb_bool_vars(), nb_int_vars());
+    println("Replaying {} calls from trace {}", records.size(), path);
+
+    // Replay calls.
+    constexpr Int nb_kinds = static_cast<Int>(TraceCallKind::Propagate) + 1;
+    struct ReplayStatistics
+    {
+        int64_t nb_calls{0};
+        int64_t nb_mismatches{0};
+        Float recorded_time{0};
+        Float replay_time{0};
+        int64_t recorded_nogood_literals{0};
+        int64_t replay_nogood_literals{0};
+    };
+    ReplayStatistics replay_stats[nb_kinds];
+    for (const auto& record : records)
+    {
+        const auto kind = static_cast<Int>(record.kind);
+        auto& stats = replay_stats[kind];
+        ++stats.nb_calls;
+        stats.recorded_time += record.time;
+
+        // Make assumptions.
+        cp_.clear_assumptions();
+        const auto start_time = clock();
+        bool success = true;
+        for (const auto& literal : record.assumptions)
+            if (!cp_.assume(probdata_.cp_atom(literal)))
+            {
+                success = false;
+                break;
+            }
+
+        // Solve.
+        TraceResult result = TraceResult::AssumptionsFailed;
+        if (success)
+        {
+            if (record.kind == TraceCallKind::Propagate)
+            {
+                result = cp_.is_consistent() ? TraceResult::Sat : TraceResult::Unsat;
+            }
+            else
+            {
+                const auto cp_result = cp_.solve(limits{.time = record.time_limit,
+                                                        .conflicts = record.conflict_limit});
+                result = get_trace_result(cp_result);
+            }
+        }
+        stats.replay_time += get_elapsed_time(start_time);
+
+        // Get nogood if the separator would have.
+        if (record.kind != TraceCallKind::Check && record.kind != TraceCallKind::Propagate &&
+            (result == TraceResult::Unsat || result == TraceResult::AssumptionsFailed))
+        {
+            const auto nogood = get_nogood(cp_, probdata_);
+            stats.replay_nogood_literals += nogood.literals.size();
+        }
+        stats.recorded_nogood_literals += record.nogood.size();
+
+        // Compare.
+        if (result != record.result)
+        {
+            debugln("Call {} of kind {} has result {} instead of {}",
+                    &record - records.data(), kind, static_cast<Int>(result), static_cast<Int>(record.result));
+            ++stats.nb_mismatches;
+        }
+    }
+    cp_.clear_assumptions();
+
+    // Print.
+    constexpr const char* kind_names[nb_kinds] = {"check", "separate bool", "separate obj", "separate all", "propagate"};
+    println("{:<19}: {:>10} {:>10} {:>12} {:>12} {:>12} {:>12}",
+            "Replay", "Calls", "Mismatches", "Trace Time", "Replay Time", "Trace Lits", "Replay Lits");
+    for (Int kind = 0; kind < nb_kinds; ++kind)
+    {
+        const auto& stats = replay_stats[kind];
+        println("  {:<17}: {:>10} {:>10} {:>12.3f} {:>12.3f} {:>12} {:>12}",
+                kind_names[kind],
+                stats.nb_calls,
+                stats.nb_mismatches,
+                stats.recorded_time,
+                stats.replay_time,
+                stats.recorded_nogood_literals,
+                stats.replay_nogood_literals);
+    }
+}
+
+}
@@ -3,17 +3,93 @@
 #include "Model.h"
 #include "Variable.h"
 #include "Matrix.h"
+#include "Separator-Routing.h"
 #include "scip/cons_linear.h"
 #include "scip/cons_knapsack.h"
 #include "scip/cons_setppc.h"
 #include "scip/cons_indicator.h"
+#include "scip/cons_logicor.h"
 #include <numeric>
 
+#define TABLE_MIP_MAX_TUPLES                         10000 // largest table whose tuples are given variables in MIP
+#define BIN_PACKING_MAX_L2_ROWS                         16 // most L2 bound constraints in bin_packing
+#define LINEAR_REIF_MAX_BIG_M                        10000 // largest big-M of reified linear rows in MIP
+
 #define geas_add_constr(expr) if (!expr) { status_ = Status::Infeasible; return false; }
 
 namespace Nutmeg
 {
 
+// Create ind_var -> sum(coeffs[i] * vars[i]) <= rhs in MIP. It is a big-M row with M tightened to the largest
+// activity of the left-hand side if M is small enough for the LP, and an indicator constraint otherwise.
+static
+void create_mip_implied_linear_le(
+    SCIP* mip,
+    SCIP_VAR* ind_var,
+    Vector<SCIP_VAR*> vars,
+    Vector<Float> coeffs,
+    const Float rhs,
+    const Float max_activity
+)
+{
+    // Skip if always satisfied.
+    const auto big_m = max_activity - rhs;
+    if (big_m <= 0)
+    {
+        return;
+    }
+
+    // Create constraint.
+    SCIP_CONS* cons = nullptr;
+    if (big_m <= LINEAR_REIF_MAX_BIG_M)
+    {
+        // sum(coeffs[i] * vars[i]) + M * ind_var <= rhs + M
+        vars.push_back(ind_var);
+        coeffs.push_back(big_m);
+        scip_assert(SCIPcreateConsBasicLinear(mip,
+                                              &cons,
+                                              "",
+                                              vars.size(),
+                                              vars.data(),
+                                              coeffs.data(),
+                                              -SCIPinfinity(mip),
+                                              rhs + big_m));
+    }
+    else
+    {
+        scip_assert(SCIPcreateConsBasicIndicator(mip,
+                                                 &cons,
+                                                 "",
+                                                 ind_var,
+                                                 vars.size(),
+                                                 vars.data(),
+                                                 coeffs.data(),
+                                                 rhs));
+    }
+    debug_assert(cons);
+    scip_assert(SCIPaddCons(mip, cons));
+    scip_assert(SCIPreleaseCons(mip, &cons));
+}
+
+// Get the smallest and largest values of sum(coeffs[i] * vars[i]) over the bounds of the variables.
+static
+std::pair<Float, Float> get_linear_activity_range(
+    const Model& model,
+    const Vector<IntVar>& vars,
+    const Vector<Int>& coeffs
+)
+{
+    Float min_activity = 0;
+    Float max_activity = 0;
+    for (size_t idx = 0; idx < vars.size(); ++idx)
+    {
+        const auto coeff = static_cast<Float>(coeffs[idx]);
+        min_activity += std::min(coeff * model.lb(vars[idx]), coeff * model.ub(vars[idx]));
+        max_activity += std::max(coeff * model.lb(vars[idx]), coeff * model.ub(vars[idx]));
+    }
+    return {min_activity, max_activity};
+}
+
 bool
 Model::add_constr_linear(
     const Vector<BoolVar>& vars,
@@ -24,6 +100,9 @@ Model::add_constr_linear(
     const Int rhs_coeff
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinearBool, vars, coeffs, sign, rhs, rhs_var, rhs_coeff);
+
     // Check.
     release_assert(sign == Sign::EQ || sign == Sign::LE || sign == Sign::GE,
                    "Linear constraint only supports <=, == or >=");
@@ -184,6 +263,9 @@ Model::add_constr_linear(
     const Int rhs_coeff
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinearIndicator, vars, coeffs, sign, rhs, rhs_var, rhs_coeff);
+
     // Check.
     release_assert(sign == Sign::EQ || sign == Sign::LE || sign == Sign::GE,
                    "Linear constraint only supports <=, == or >=");
@@ -323,6 +405,9 @@ Model::add_constr_set_partition(
     const Vector<BoolVar>& vars
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrSetPartition, vars);
+
     // Create constraint in MIP.
     {
         SCIP_CONS* cons;
@@ -375,6 +460,9 @@ Model::add_constr_subtraction_leq(
     const Int rhs
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrSubtractionLeq, x, y, rhs);
+
     // Check.
     release_assert(x.is_valid() && y.is_valid(),
                    "Variable is not valid in creating subtraction_leq constraint");
@@ -412,6 +500,9 @@ Model::add_constr_reify_subtraction_leq(
     const Int rhs
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrReifySubtractionLeq, r, x, y, rhs);
+
     // Check.
     release_assert(r.is_valid() && x.is_valid() && y.is_valid(),
                    "Variable is not valid in creating reify_subtraction_leq constraint");
@@ -451,6 +542,9 @@ Model::add_constr_imply(
     const Int x_val
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrImply, r, r_val, x, sign, x_val);
+
     // Check.
     release_assert(sign == Sign::EQ || sign == Sign::LE || sign == Sign::GE,
                    "Imply constraint only supports <=, == or >=");
@@ -517,6 +611,193 @@ Model::add_constr_imply(
     return true;
 }
 
+bool
+Model::add_constr_linear_imply(
+    const BoolVar r,
+    const Vector<IntVar>& vars,
+    const Vector<Int>& coeffs,
+    const Sign sign,
+    const Int rhs
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinearImply, r, vars, coeffs, sign, rhs);
+
+    // Check.
+    release_assert(sign == Sign::EQ || sign == Sign::LE || sign == Sign::GE,
+                   "Linear constraint only supports <=, == or >=");
+    release_assert(vars.size() == coeffs.size(),
+                   "Vectors of variables and coefficients have different lengths in "
+                   "creating linear_imply constraint");
+    release_assert(r.is_valid(),
+                   "Variable is not valid in creating linear_imply constraint");
+    for (const auto var : vars)
+    {
+        release_assert(var.is_valid(),
+                       "Variable is not valid in creating linear_imply constraint");
+    }
+
+    // Calculate the range of the left-hand side.
+    const auto [min_activity, max_activity] = get_linear_activity_range(*this, vars, coeffs);
+
+    // Disable r if the constraint cannot be satisfied.
+    if ((sign != Sign::GE && min_activity > rhs) || (sign != Sign::LE && max_activity < rhs))
+    {
+        return add_constr_fix(get_neg(r));
+    }
+
+    // Create constraint in MIP.
+    if (std::all_of(vars.begin(), vars.end(), [&](const IntVar var) { return mip_var(var) != nullptr; }))
+    {
+        Vector<SCIP_VAR*> mip_vars(vars.size());
+        Vector<Float> mip_coeffs(vars.size());
+        for (size_t idx = 0; idx < vars.size(); ++idx)
+        {
+            mip_vars[idx] = mip_var(vars[idx]);
+            mip_coeffs[idx] = coeffs[idx];
+        }
+
+        // r -> coeffs[0] * vars[0] + ... + coeffs[n-1] * vars[n-1] <= rhs
+        if (sign != Sign::GE)
+        {
+            create_mip_implied_linear_le(mip_, mip_var(r), mip_vars, mip_coeffs, rhs, max_activity);
+        }
+
+        // r -> -coeffs[0] * vars[0] - ... - coeffs[n-1] * vars[n-1] <= -rhs
+        if (sign != Sign::LE)
+        {
+            for (auto& coeff : mip_coeffs)
+                coeff *= -1;
+            create_mip_implied_linear_le(mip_, mip_var(r), mip_vars, mip_coeffs, -rhs, -min_activity);
+        }
+    }
+
+    // Create constraint in CP.
+    {
+        vec<geas::intvar> cp_vars;
+        vec<int> cp_coeffs;
+        for (size_t idx = 0; idx < vars.size(); ++idx)
+        {
+            cp_vars.push(cp_var(vars[idx]));
+            cp_coeffs.push(coeffs[idx]);
+        }
+        if (sign != Sign::GE && max_activity > rhs)
+        {
+            geas_add_constr(geas::linear_le(cp_.data, cp_coeffs, cp_vars, rhs, cp_var(r)));
+        }
+        if (sign != Sign::LE && min_activity < rhs)
+        {
+            for (auto& coeff : cp_coeffs)
+                coeff *= -1;
+            geas_add_constr(geas::linear_le(cp_.data, cp_coeffs, cp_vars, -rhs, cp_var(r)));
+        }
+    }
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_linear_reif(
+    const BoolVar r,
+    const Vector<IntVar>& vars,
+    const Vector<Int>& coeffs,
+    const Sign sign,
+    const Int rhs
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrLinearReif, r, vars, coeffs, sign, rhs);
+
+    // Check.
+    release_assert(sign == Sign::EQ || sign == Sign::LE || sign == Sign::GE,
+                   "Linear constraint only supports <=, == or >=");
+
+    // r -> constraint
+    if (!add_constr_linear_imply(r, vars, coeffs, sign, rhs))
+    {
+        return false;
+    }
+
+    // ~r -> negation of constraint
+    if (sign == Sign::LE)
+    {
+        return add_constr_linear_imply(get_neg(r), vars, coeffs, Sign::GE, rhs + 1);
+    }
+    else if (sign == Sign::GE)
+    {
+        return add_constr_linear_imply(get_neg(r), vars, coeffs, Sign::LE, rhs - 1);
+    }
+
+    // Calculate the range of the left-hand side.
+    const auto [min_activity, max_activity] = get_linear_activity_range(*this, vars, coeffs);
+
+    // Create ~r -> sum(coeffs[i] * vars[i]) != rhs in MIP using private variables to choose the side.
+    // r + [sum < rhs] + [sum > rhs] >= 1
+    if (std::all_of(vars.begin(), vars.end(), [&](const IntVar var) { return mip_var(var) != nullptr; }))
+    {
+        Vector<SCIP_VAR*> mip_vars(vars.size());
+        Vector<Float> mip_coeffs(vars.size());
+        for (size_t idx = 0; idx < vars.size(); ++idx)
+        {
+            mip_vars[idx] = mip_var(vars[idx]);
+            mip_coeffs[idx] = coeffs[idx];
+        }
+
+        // Create private side variables.
+        SCIP_VAR* side_vars[2]{nullptr, nullptr};
+        for (auto& side_var : side_vars)
+        {
+            scip_assert(SCIPcreateVarBasic(mip_,
+                                           &side_var,
+                                           "",
+                                           0.0,
+                                           1.0,
+                                           0.0,
+                                           SCIP_VARTYPE_BINARY));
+            release_assert(side_var, "Failed to create Boolean variable in MIP");
+            scip_assert(SCIPaddVar(mip_, side_var));
+        }
+
+        // Choose a side if r is false.
+        {
+            SCIP_VAR* choice_vars[3]{mip_var(r), side_vars[0], side_vars[1]};
+            SCIP_CONS* cons = nullptr;
+            scip_assert(SCIPcreateConsBasicLogicor(mip_, &cons, "", 3, choice_vars));
+            debug_assert(cons);
+            scip_assert(SCIPaddCons(mip_, cons));
+            scip_assert(SCIPreleaseCons(mip_, &cons));
+        }
+
+        // Enforce the side.
+        create_mip_implied_linear_le(mip_, side_vars[0], mip_vars, mip_coeffs, rhs - 1, max_activity);
+        for (auto& coeff : mip_coeffs)
+            coeff *= -1;
+        create_mip_implied_linear_le(mip_, side_vars[1], mip_vars, mip_coeffs, -rhs - 1, -min_activity);
+
+        // Release private side variables.
+        for (auto& side_var : side_vars)
+        {
+            scip_assert(SCIPreleaseVar(mip_, &side_var));
+        }
+    }
+
+    // Create ~r -> sum(coeffs[i] * vars[i]) != rhs in CP.
+    {
+        vec<geas::intvar> cp_vars;
+        vec<int> cp_coeffs;
+        for (size_t idx = 0; idx < vars.size(); ++idx)
+        {
+            cp_vars.push(cp_var(vars[idx]));
+            cp_coeffs.push(coeffs[idx]);
+        }
+        geas_add_constr(geas::linear_ne(cp_.data, cp_coeffs, cp_vars, rhs, ~cp_var(r)));
+    }
+
+    // Success.
+    return true;
+}
+
 bool
 Model::add_constr_cumulative(
     const Vector<IntVar>& start,
@@ -525,6 +806,9 @@ Model::add_constr_cumulative(
     const Int capacity
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrCumulative, start, duration, resource, capacity);
+
     // Check.
     release_assert(start.size() == duration.size() &&
                    duration.size() == resource.size(),
@@ -620,6 +904,9 @@ Model::add_constr_cumulative_optional(
     const IntVar makespan
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrCumulativeOptional, active, start, duration, resource, capacity, makespan);
+
     // Check.
     release_assert(active.size() == start.size() &&
                    start.size() == duration.size() &&
@@ -889,4 +1176,873 @@ Model::add_constr_cumulative_optional(
     return true;
 }
 
+bool
+Model::add_constr_disjunctive(
+    const Vector<IntVar>& start,
+    const Vector<Int>& duration
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrDisjunctive, start, duration);
+
+    // Check.
+    release_assert(start.size() == duration.size(),
+                   "Vectors of tasks have different lengths in creating disjunctive "
+                   "constraint");
+    const Int N = start.size();
+    for (Int j = 0; j < N; ++j)
+    {
+        release_assert(start[j].is_valid(),
+                       "Variable is not valid in creating disjunctive constraint");
+        release_assert(duration[j] >= 0,
+                       "Duration of task {} is negative in creating disjunctive constraint", j);
+    }
+
+    // Create constraint in MIP if solving using MIP.
+    if (method_ == Method::MIP)
+    {
+        // Create binarization variables.
+        for (Int j = 0; j < N; ++j)
+        {
+            add_indicator_vars(start[j]);
+        }
+
+        // Calculate earliest start time and latest start time.
+        Int e = std::numeric_limits<Int>::max();
+        Int l = std::numeric_limits<Int>::min();
+        for (Int j = 0; j < N; ++j)
+        {
+            if (lb(start[j]) < e)
+                e = lb(start[j]);
+            if (ub(start[j]) > l)
+                l = ub(start[j]);
+        }
+
+        // Create resource constraints.
+        for (Int t = e; t <= l; ++t)
+        {
+            // Create constraint.
+            SCIP_CONS* cons = nullptr;
+            scip_assert(SCIPcreateConsBasicSetpack(mip_, &cons, "", 0, nullptr));
+            debug_assert(cons);
+
+            // Add variables to constraint.
+            for (Int j = 0; j < N; ++j)
+            {
+                for (Int u = std::max(t - duration[j] + 1, lb(start[j]));
+                     u <= std::min(t, ub(start[j]));
+                     ++u)
+                {
+                    auto var = mip_indicator_var(start[j], u);
+                    debug_assert(var);
+                    scip_assert(SCIPaddCoefSetppc(mip_, cons, var));
+                }
+            }
+
+            // Add constraint.
+            scip_assert(SCIPaddCons(mip_, cons));
+            scip_assert(SCIPreleaseCons(mip_, &cons));
+        }
+    }
+
+    // Create constraint in CP. Geas propagates the unary resource by edge-finding.
+    {
+        vec<geas::intvar> start2(N);
+        vec<int> duration2(N);
+        for (Int idx = 0; idx < N; ++idx)
+        {
+            start2[idx] = cp_var(start[idx]);
+            duration2[idx] = duration[idx];
+        }
+
+        geas_add_constr(geas::disjunctive_int(cp_.data, start2, duration2));
+    }
+
+    // Create relaxation in MIP if the start times are in MIP.
+    // For every set S of tasks that cannot start before time r,
+    // sum(j in S) (duration[j] * start[j]) >= r * d(S) + (d(S)^2 - sum(j in S) (duration[j]^2)) / 2
+    // where d(S) is the total duration of S, because the tasks run one after another from r in the best case.
+    // The sets are the tasks that cannot start before each earliest start time.
+    if (std::all_of(start.begin(), start.end(), [&](const IntVar var) { return mip_var(var) != nullptr; }))
+    {
+        // Sort the tasks in decreasing order of earliest start time.
+        Vector<Int> order(N);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const Int i, const Int j) { return lb(start[i]) > lb(start[j]); });
+
+        // Create a constraint for each earliest start time.
+        Float total_duration = 0;
+        Float total_duration_sq = 0;
+        for (Int k = 0; k < N; ++k)
+        {
+            // Add the task to the set.
+            const auto r = lb(start[order[k]]);
+            total_duration += duration[order[k]];
+            total_duration_sq += static_cast<Float>(duration[order[k]]) * duration[order[k]];
+            if ((k + 1 < N && lb(start[order[k + 1]]) == r) || k == 0)
+            {
+                continue;
+            }
+
+            // Create constraint.
+            const Float rhs = r * total_duration +
+                              (total_duration * total_duration - total_duration_sq) / 2;
+            SCIP_CONS* cons = nullptr;
+            scip_assert(SCIPcreateConsBasicLinear(mip_,
+                                                  &cons,
+                                                  "",
+                                                  0,
+                                                  nullptr,
+                                                  nullptr,
+                                                  rhs,
+                                                  SCIPinfinity(mip_)));
+            debug_assert(cons);
+            for (Int idx = 0; idx <= k; ++idx)
+                if (duration[order[idx]] > 0)
+                {
+                    scip_assert(SCIPaddCoefLinear(mip_,
+                                                  cons,
+                                                  mip_var(start[order[idx]]),
+                                                  duration[order[idx]]));
+                }
+            scip_assert(SCIPaddCons(mip_, cons));
+            scip_assert(SCIPreleaseCons(mip_, &cons));
+        }
+    }
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_disjunctive_optional(
+    const Vector<BoolVar>& active,
+    const Vector<IntVar>& start,
+    const Vector<Int>& duration,
+    const IntVar makespan
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrDisjunctiveOptional, active, start, duration, makespan);
+
+    // Check.
+    release_assert(active.size() == start.size() &&
+                   start.size() == duration.size(),
+                   "Vectors of tasks have different lengths in creating "
+                   "disjunctive_optional constraint");
+    const Int N = start.size();
+    for (Int j = 0; j < N; ++j)
+    {
+        release_assert(active[j].is_valid() && start[j].is_valid(),
+                       "Variable is not valid in creating disjunctive_optional constraint");
+        release_assert(duration[j] >= 0,
+                       "Duration of task {} is negative in creating disjunctive_optional constraint", j);
+    }
+
+    // Create the time-indexed formulation and energy relaxation in MIP and the timetable propagator in CP.
+    if (!add_constr_cumulative_optional(active, start, duration, Vector<Int>(N, 1), 1, makespan))
+    {
+        return false;
+    }
+
+    // Order the pairs of active tasks whose time windows overlap in CP, which lets the solver branch on and learn
+    // precedences. A literal is only created for an order that the time windows allow.
+    // (active[i] && active[j]) -> (start[i] + duration[i] <= start[j] || start[j] + duration[j] <= start[i])
+    for (Int i = 0; i < N - 1; ++i)
+        for (Int j = i + 1; j < N; ++j)
+            if (duration[i] > 0 && duration[j] > 0 &&
+                lb(start[i]) < ub(start[j]) + duration[j] &&
+                lb(start[j]) < ub(start[i]) + duration[i])
+            {
+                vec<geas::clause_elt> clause;
+                clause.push(~cp_var(active[i]));
+                clause.push(~cp_var(active[j]));
+                if (lb(start[i]) + duration[i] <= ub(start[j]))
+                {
+                    const auto before = cp_.new_boolvar();
+                    geas_add_constr(geas::int_le(cp_.data, cp_var(start[i]), cp_var(start[j]), -duration[i], before));
+                    clause.push(before);
+                }
+                if (lb(start[j]) + duration[j] <= ub(start[i]))
+                {
+                    const auto after = cp_.new_boolvar();
+                    geas_add_constr(geas::int_le(cp_.data, cp_var(start[j]), cp_var(start[i]), -duration[j], after));
+                    clause.push(after);
+                }
+                geas_add_constr(geas::add_clause(*cp_.data, clause));
+            }
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_table(
+    const Vector<IntVar>& vars,
+    const Matrix<Int>& tuples
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrTable, vars, tuples);
+
+    // Check.
+    release_assert(tuples.cols() == vars.size(),
+                   "Tuples have {} values instead of {} in creating table constraint",
+                   tuples.cols(), vars.size());
+    for (const auto var : vars)
+    {
+        release_assert(var.is_valid(),
+                       "Variable is not valid in creating table constraint");
+    }
+    const Int N = vars.size();
+
+    // Keep the distinct tuples that are inside the domains of the variables.
+    Vector<Int> rows;
+    rows.reserve(tuples.rows());
+    for (Int k = 0; k < static_cast<Int>(tuples.rows()); ++k)
+    {
+        bool is_inside = true;
+        for (Int i = 0; i < N && is_inside; ++i)
+            is_inside = lb(vars[i]) <= tuples(k, i) && tuples(k, i) <= ub(vars[i]);
+        if (is_inside)
+            rows.push_back(k);
+    }
+    std::sort(rows.begin(), rows.end(), [&](const Int k1, const Int k2)
+    {
+        return std::lexicographical_compare(tuples.cbegin(k1), tuples.cend(k1), tuples.cbegin(k2), tuples.cend(k2));
+    });
+    rows.erase(std::unique(rows.begin(), rows.end(), [&](const Int k1, const Int k2)
+    {
+        return std::equal(tuples.cbegin(k1), tuples.cend(k1), tuples.cbegin(k2));
+    }), rows.end());
+    debugln("Table constraint over {} variables keeps {} of {} tuples", N, rows.size(), tuples.rows());
+
+    // Fail if no tuple is allowed.
+    if (rows.empty())
+    {
+        mark_as_infeasible();
+        return false;
+    }
+
+    // Tighten the bounds to the supported values and remove the unsupported values from the binarization
+    // variables.
+    for (Int i = 0; i < N; ++i)
+    {
+        const auto var = vars[i];
+        const auto var_lb = lb(var);
+        const auto var_ub = ub(var);
+        Vector<bool> is_supported(var_ub - var_lb + 1, false);
+        Int min = var_ub;
+        Int max = var_lb;
+        for (const auto k : rows)
+        {
+            const auto val = tuples(k, i);
+            is_supported[val - var_lb] = true;
+            min = std::min(min, val);
+            max = std::max(max, val);
+        }
+        if ((min > var_lb && !add_constr_linear({var}, Vector<Int>{1}, Sign::GE, min)) ||
+            (max < var_ub && !add_constr_linear({var}, Vector<Int>{1}, Sign::LE, max)))
+        {
+            return false;
+        }
+
+        if (has_mip_indicator_vars(var))
+            for (Int val = min; val <= max; ++val)
+                if (!is_supported[val - var_lb])
+                    if (auto mip_indicator = mip_indicator_var(var, val); mip_indicator)
+                    {
+                        scip_assert(SCIPchgVarUb(mip_, mip_indicator, 0.0));
+                    }
+    }
+
+    // Create the convex hull of the tuples in MIP if solving using MIP, which has no CP check, or if the table is
+    // small enough.
+    // sum(k in tuples) y[k] == 1
+    // vars[i] == sum(k in tuples) (tuples[k][i] * y[k]) for all i
+    // [vars[i] == val] == sum(k in tuples with tuples[k][i] == val) y[k] for all i and val
+    if (method_ == Method::MIP)
+    {
+        for (const auto var : vars)
+            if (!mip_var(var) && !has_mip_indicator_vars(var))
+            {
+                add_mip_var(var);
+            }
+    }
+    if ((method_ == Method::MIP || static_cast<Int>(rows.size()) <= TABLE_MIP_MAX_TUPLES) &&
+        std::any_of(vars.begin(), vars.end(), [&](const IntVar var) { return mip_var(var) || has_mip_indicator_vars(var); }))
+    {
+        // Create private tuple variables.
+        Vector<SCIP_VAR*> tuple_vars(rows.size(), nullptr);
+        for (auto& tuple_var : tuple_vars)
+        {
+            scip_assert(SCIPcreateVarBasic(mip_,
+                                           &tuple_var,
+                                           "",
+                                           0.0,
+                                           1.0,
+                                           0.0,
+                                           SCIP_VARTYPE_BINARY));
+            release_assert(tuple_var, "Failed to create Boolean variable in MIP");
+            scip_assert(SCIPaddVar(mip_, tuple_var));
+        }
+
+        // Choose one tuple.
+        {
+            SCIP_CONS* cons = nullptr;
+            scip_assert(SCIPcreateConsBasicSetpart(mip_,
+                                                   &cons,
+                                                   "",
+                                                   tuple_vars.size(),
+                                                   tuple_vars.data()));
+            debug_assert(cons);
+            scip_assert(SCIPaddCons(mip_, cons));
+            scip_assert(SCIPreleaseCons(mip_, &cons));
+        }
+
+        // Link the variables to the chosen tuple.
+        for (Int i = 0; i < N; ++i)
+        {
+            const auto var = vars[i];
+            if (auto mip = mip_var(var); mip)
+            {
+                SCIP_CONS* cons = nullptr;
+                scip_assert(SCIPcreateConsBasicLinear(mip_,
+                                                      &cons,
+                                                      "",
+                                                      0,
+                                                      nullptr,
+                                                      nullptr,
+                                                      0.0,
+                                                      0.0));
+                debug_assert(cons);
+                for (size_t idx = 0; idx < rows.size(); ++idx)
+                    if (tuples(rows[idx], i) != 0)
+                    {
+                        scip_assert(SCIPaddCoefLinear(mip_, cons, tuple_vars[idx], tuples(rows[idx], i)));
+                    }
+                scip_assert(SCIPaddCoefLinear(mip_, cons, mip, -1.0));
+                scip_assert(SCIPaddCons(mip_, cons));
+                scip_assert(SCIPreleaseCons(mip_, &cons));
+            }
+            if (has_mip_indicator_vars(var))
+            {
+                Vector<Vector<SCIP_VAR*>> val_tuple_vars(ub(var) - lb(var) + 1);
+                for (size_t idx = 0; idx < rows.size(); ++idx)
+                    val_tuple_vars[tuples(rows[idx], i) - lb(var)].push_back(tuple_vars[idx]);
+                for (Int val = lb(var); val <= ub(var); ++val)
+                    if (auto mip_indicator = mip_indicator_var(var, val); mip_indicator)
+                    {
+                        auto& terms = val_tuple_vars[val - lb(var)];
+                        Vector<Float> coeffs(terms.size(), 1.0);
+                        terms.push_back(mip_indicator);
+                        coeffs.push_back(-1.0);
+
+                        SCIP_CONS* cons = nullptr;
+                        scip_assert(SCIPcreateConsBasicLinear(mip_,
+                                                              &cons,
+                                                              "",
+                                                              terms.size(),
+                                                              terms.data(),
+                                                              coeffs.data(),
+                                                              0.0,
+                                                              0.0));
+                        debug_assert(cons);
+                        scip_assert(SCIPaddCons(mip_, cons));
+                        scip_assert(SCIPreleaseCons(mip_, &cons));
+                    }
+            }
+        }
+
+        // Release private tuple variables.
+        for (auto& tuple_var : tuple_vars)
+        {
+            scip_assert(SCIPreleaseVar(mip_, &tuple_var));
+        }
+    }
+
+    // Create constraint in CP using the compact-table propagator, which keeps the valid tuples as a bitset. Geas
+    // only builds a table from a vector per row, so the kept tuples are copied for it and freed once it is built.
+    {
+        vec<geas::intvar> cp_vars(N);
+        for (Int i = 0; i < N; ++i)
+            cp_vars[i] = cp_var(vars[i]);
+
+        const auto table = [&]()
+        {
+            vec<vec<int>> cp_tuples(rows.size());
+            for (size_t idx = 0; idx < rows.size(); ++idx)
+                for (Int i = 0; i < N; ++i)
+                    cp_tuples[idx].push(tuples(rows[idx], i));
+            return geas::table::build(cp_.data, cp_tuples);
+        }();
+        geas_add_constr(geas::table::post(cp_.data, table, cp_vars, geas::table::Table_CT));
+    }
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_bin_packing(
+    const Vector<IntVar>& bin,
+    const Vector<Int>& size,
+    const Vector<BoolVar>& active,
+    const Int capacity,
+    const IntVar nb_bins
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrBinPacking, bin, size, active, capacity, nb_bins);
+
+    // Check.
+    release_assert(bin.size() == size.size() &&
+                   size.size() == active.size(),
+                   "Vectors of items have different lengths in creating "
+                   "bin_packing constraint");
+    release_assert(capacity >= 0, "Capacity is negative in creating bin_packing constraint");
+    const Int N = bin.size();
+    for (Int i = 0; i < N; ++i)
+    {
+        release_assert(bin[i].is_valid() && active[i].is_valid(),
+                       "Variable is not valid in creating bin_packing constraint");
+        release_assert(size[i] >= 0,
+                       "Size of item {} is negative in creating bin_packing constraint", i);
+        release_assert(!nb_bins.is_valid() || lb(bin[i]) >= 0,
+                       "Bins must be numbered from 0 in creating bin_packing constraint with number of bins");
+    }
+
+    // Calculate the first and last bin.
+    Int first_bin = std::numeric_limits<Int>::max();
+    Int last_bin = std::numeric_limits<Int>::min();
+    for (Int i = 0; i < N; ++i)
+    {
+        first_bin = std::min(first_bin, lb(bin[i]));
+        last_bin = std::max(last_bin, ub(bin[i]));
+    }
+    if (nb_bins.is_valid())
+    {
+        first_bin = 0;
+        last_bin = std::min(last_bin, ub(nb_bins) - 1);
+    }
+
+    // Items larger than the capacity cannot be packed.
+    for (Int i = 0; i < N; ++i)
+        if (size[i] > capacity)
+        {
+            if (!add_constr_fix(get_neg(active[i])))
+            {
+                return false;
+            }
+        }
+
+    // Count the bins used.
+    // active[i] -> bin[i] - nb_bins <= -1
+    if (nb_bins.is_valid())
+    {
+        for (Int i = 0; i < N; ++i)
+            if (!add_constr_reify_subtraction_leq(active[i], bin[i], nb_bins, -1))
+            {
+                return false;
+            }
+    }
+
+    // Create the load of every bin in MIP if solving using MIP or if the bins of the items are already binarized in
+    // the master problem. SCIP separates lifted cover cuts from these knapsack constraints. Otherwise the bins are
+    // left to CP, since binarizing them would add a variable for every item and bin to the master problem, which
+    // gets the L2 bounds below instead.
+    // sum(i in items) (size[i] * [active[i] && bin[i] == b]) <= capacity for all b
+    if (N > 0 &&
+        (method_ == Method::MIP ||
+         std::all_of(bin.begin(), bin.end(), [&](const IntVar var) { return has_mip_indicator_vars(var); })))
+    {
+        // Create binarization variables.
+        for (Int i = 0; i < N; ++i)
+        {
+            add_indicator_vars(bin[i]);
+        }
+
+        // Create private assignment variables.
+        // [active[i] && bin[i] == b] >= active[i] + [bin[i] == b] - 1
+        Matrix<SCIP_VAR*> assign_vars(N, last_bin - first_bin + 1);
+        for (Int i = 0; i < N; ++i)
+            if (size[i] > 0)
+                for (Int b = std::max(lb(bin[i]), first_bin); b <= std::min(ub(bin[i]), last_bin); ++b)
+                {
+                    auto bin_indicator = mip_indicator_var(bin[i], b);
+                    if (!bin_indicator)
+                        continue;
+
+                    // Create variable in MIP.
+                    SCIP_VAR*& var = assign_vars(i, b - first_bin);
+                    scip_assert(SCIPcreateVarBasic(mip_,
+                                                   &var,
+                                                   "",
+                                                   0.0,
+                                                   1.0,
+                                                   0.0,
+                                                   SCIP_VARTYPE_BINARY));
+                    release_assert(var, "Failed to create Boolean variable in MIP");
+                    scip_assert(SCIPaddVar(mip_, var));
+
+                    // Link to the item.
+                    SCIP_VAR* vars[3]{var, mip_var(active[i]), bin_indicator};
+                    SCIP_Real coeffs[3]{1, -1, -1};
+                    SCIP_CONS* cons = nullptr;
+                    scip_assert(SCIPcreateConsBasicLinear(mip_,
+                                                          &cons,
+                                                          "",
+                                                          3,
+                                                          vars,
+                                                          coeffs,
+                                                          -1.0,
+                                                          SCIPinfinity(mip_)));
+                    debug_assert(cons);
+                    scip_assert(SCIPaddCons(mip_, cons));
+                    scip_assert(SCIPreleaseCons(mip_, &cons));
+                }
+
+        // Create capacity constraints.
+        for (Int b = first_bin; b <= last_bin; ++b)
+        {
+            SCIP_CONS* cons = nullptr;
+            scip_assert(SCIPcreateConsBasicKnapsack(mip_,
+                                                    &cons,
+                                                    "",
+                                                    0,
+                                                    nullptr,
+                                                    nullptr,
+                                                    capacity));
+            debug_assert(cons);
+            for (Int i = 0; i < N; ++i)
+                if (auto var = assign_vars(i, b - first_bin); var)
+                {
+                    scip_assert(SCIPaddCoefKnapsack(mip_, cons, var, size[i]));
+                }
+            scip_assert(SCIPaddCons(mip_, cons));
+            scip_assert(SCIPreleaseCons(mip_, &cons));
+        }
+
+        // Release private assignment variables.
+        for (Int i = 0; i < static_cast<Int>(assign_vars.rows()); ++i)
+            for (Int b = 0; b < static_cast<Int>(assign_vars.cols()); ++b)
+                if (assign_vars(i, b))
+                {
+                    scip_assert(SCIPreleaseVar(mip_, &assign_vars(i, b)));
+                }
+    }
+
+    // Create constraint in CP using a load variable for every bin. The loads add up to the total size of the
+    // active items, so that filling some bins bounds the space left in the others and the bins that an item still
+    // fits into.
+    // load[b] == sum(i in items) (size[i] * [active[i] && bin[i] == b]) for all b
+    // sum(b in bins) (load[b]) == sum(i in items) (size[i] * active[i])
+    if (N > 0 && last_bin >= first_bin)
+    {
+        vec<int> sum_coeffs;
+        vec<geas::intvar> sum_vars;
+        for (Int b = first_bin; b <= last_bin; ++b)
+        {
+            // Get the assignment literals. The literal of bin[i] == b is used directly for an item that is always
+            // active, and conjoined with the activity literal otherwise.
+            // [active[i] && bin[i] == b] <-> active[i] && bin[i] == b
+            vec<int> coeffs;
+            vec<geas::patom_t> assigned;
+            for (Int i = 0; i < N; ++i)
+                if (0 < size[i] && size[i] <= capacity && lb(bin[i]) <= b && b <= ub(bin[i]))
+                {
+                    const auto active_lit = cp_var(active[i]);
+                    const auto bin_lit = cp_var(bin[i]) == b;
+                    if (active_lit.lb(cp_.data->state.p_vals))
+                    {
+                        assigned.push(bin_lit);
+                    }
+                    else if ((~active_lit).lb(cp_.data->state.p_vals))
+                    {
+                        continue;
+                    }
+                    else
+                    {
+                        const auto assigned_lit = cp_.new_boolvar();
+                        geas_add_constr(geas::add_clause(cp_.data, ~assigned_lit, active_lit));
+                        geas_add_constr(geas::add_clause(cp_.data, ~assigned_lit, bin_lit));
+                        geas_add_constr(geas::add_clause(cp_.data, assigned_lit, ~active_lit, ~bin_lit));
+                        assigned.push(assigned_lit);
+                    }
+                    coeffs.push(size[i]);
+                }
+            if (assigned.size() == 0)
+            {
+                continue;
+            }
+
+            // Create the load.
+            const auto load = cp_.new_intvar(0, capacity);
+            geas_add_constr(geas::bool_linear_ge(cp_.data, geas::at_True, load, coeffs, assigned, 0));
+            geas_add_constr(geas::bool_linear_le(cp_.data, geas::at_True, load, coeffs, assigned, 0));
+            sum_coeffs.push(1);
+            sum_vars.push(load);
+        }
+
+        // Create the total size.
+        {
+            vec<int> coeffs;
+            vec<geas::patom_t> actives;
+            Int total_size = 0;
+            for (Int i = 0; i < N; ++i)
+                if (0 < size[i] && size[i] <= capacity)
+                {
+                    coeffs.push(size[i]);
+                    actives.push(cp_var(active[i]));
+                    total_size += size[i];
+                }
+            const auto total_load = cp_.new_intvar(0, total_size);
+            if (actives.size() > 0)
+            {
+                geas_add_constr(geas::bool_linear_ge(cp_.data, geas::at_True, total_load, coeffs, actives, 0));
+                geas_add_constr(geas::bool_linear_le(cp_.data, geas::at_True, total_load, coeffs, actives, 0));
+            }
+            sum_coeffs.push(-1);
+            sum_vars.push(total_load);
+        }
+
+        // Link the loads to the total size.
+        geas_add_constr(geas::linear_le(cp_.data, sum_coeffs, sum_vars, 0));
+        for (auto& coeff : sum_coeffs)
+            coeff = -coeff;
+        geas_add_constr(geas::linear_le(cp_.data, sum_coeffs, sum_vars, 0));
+    }
+
+    // Create bounds on the number of bins in MIP and CP using the dual feasible functions of the L2 bound.
+    // For 0 <= k <= capacity / 2, every item larger than capacity - k fills a bin of its own and items
+    // smaller than k are ignored:
+    // sum(i in items) (f_k(size[i]) * active[i]) <= capacity * nb_bins
+    // where f_k(x) = capacity if x > capacity - k, x if k <= x <= capacity - k, and 0 otherwise.
+    if (N > 0 && capacity > 0 && last_bin >= first_bin)
+    {
+        // Choose the values of k from the sizes of the items.
+        Vector<Int> ks;
+        for (Int i = 0; i < N; ++i)
+            if (0 < size[i] && 2 * size[i] <= capacity)
+                ks.push_back(size[i]);
+        std::sort(ks.begin(), ks.end());
+        ks.erase(std::unique(ks.begin(), ks.end()), ks.end());
+        if (static_cast<Int>(ks.size()) > BIN_PACKING_MAX_L2_ROWS - 1)
+        {
+            Vector<Int> sampled_ks(BIN_PACKING_MAX_L2_ROWS - 1);
+            for (Int idx = 0; idx < static_cast<Int>(sampled_ks.size()); ++idx)
+                sampled_ks[idx] = ks[idx * ks.size() / sampled_ks.size()];
+            ks = std::move(sampled_ks);
+        }
+        ks.insert(ks.begin(), 0);
+
+        // Create a constraint for each distinct function.
+        Vector<Vector<Int>> previous_coeffs;
+        for (const auto k : ks)
+        {
+            Vector<BoolVar> vars;
+            Vector<Int> coeffs;
+            for (Int i = 0; i < N; ++i)
+            {
+                const auto coeff = size[i] > capacity - k ? capacity : size[i] >= k ? size[i] : 0;
+                if (coeff > 0 && size[i] <= capacity)
+                {
+                    vars.push_back(active[i]);
+                    coeffs.push_back(coeff);
+                }
+            }
+            if (vars.empty() || std::find(previous_coeffs.begin(), previous_coeffs.end(), coeffs) != previous_coeffs.end())
+            {
+                continue;
+            }
+
+            if (nb_bins.is_valid() && (mip_var(nb_bins) || method_ != Method::MIP))
+            {
+                if (!add_constr_linear(vars, coeffs, Sign::LE, 0, nb_bins, capacity))
+                {
+                    return false;
+                }
+            }
+            if (!nb_bins.is_valid() || !mip_var(nb_bins))
+            {
+                if (!add_constr_linear(vars, coeffs, Sign::LE, capacity * (last_bin - first_bin + 1)))
+                {
+                    return false;
+                }
+            }
+            previous_coeffs.push_back(std::move(coeffs));
+        }
+    }
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_circuit(
+    const ArcMatrix<BoolVar>& vars
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrCircuit, vars);
+
+    // Check.
+    const auto& arcs = vars.arcs();
+    const auto N = static_cast<Int>(arcs.nb_nodes());
+    release_assert(N >= 2, "Circuit must have at least two nodes");
+    for (const auto var : vars)
+    {
+        release_assert(var.is_valid(),
+                       "Variable is not valid in creating circuit constraint");
+    }
+
+    // Leave and enter every node once.
+    for (Int i = 0; i < N; ++i)
+    {
+        const auto out_vars = vars.out(i);
+        if (!add_constr_set_partition(Vector<BoolVar>(out_vars.begin(), out_vars.end())))
+        {
+            return false;
+        }
+
+        Vector<BoolVar> in_vars;
+        for (const auto a : arcs.in_arcs(i))
+            in_vars.push_back(vars[a]);
+        if (!add_constr_set_partition(in_vars))
+        {
+            return false;
+        }
+    }
+
+    // Number the nodes in order along the circuit from node 0, which eliminates subtours in CP. The order is
+    // only created in MIP when solving using MIP alone because subtours are otherwise removed by cuts in the
+    // LP and by CP in integer solutions.
+    const auto include_in_mip = method_ == Method::MIP;
+    Vector<IntVar> rank(N);
+    rank[0] = add_int_var(0, 0, include_in_mip);
+    for (Int i = 1; i < N; ++i)
+    {
+        rank[i] = add_int_var(1, N - 1, include_in_mip, fmt::format("circuit_rank[{}]", i));
+    }
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        const auto i = arcs.tail(a);
+        const auto j = arcs.head(a);
+        if (i == 0)
+        {
+            if (!add_constr_imply(vars[a], true, rank[j], Sign::EQ, 1))
+            {
+                return false;
+            }
+        }
+        else if (j == 0)
+        {
+            if (!add_constr_imply(vars[a], true, rank[i], Sign::EQ, N - 1))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // x[i,j] -> rank[i] + 1 == rank[j]
+            if (!add_constr_reify_subtraction_leq(vars[a], rank[i], rank[j], -1) ||
+                !add_constr_reify_subtraction_leq(vars[a], rank[j], rank[i], 1))
+            {
+                return false;
+            }
+        }
+    }
+    {
+        vec<geas::intvar> cp_vars(N - 1);
+        for (Int i = 1; i < N; ++i)
+            cp_vars[i - 1] = cp_var(rank[i]);
+        geas_add_constr(geas::all_different_int(cp_.data, cp_vars));
+    }
+
+    // Separate subtour elimination cuts in MIP.
+    scip_assert(includeSepaRouting(mip_, this, vars, Vector<Int>(N, 0), 1, 0, 0));
+
+    // Success.
+    return true;
+}
+
+bool
+Model::add_constr_paths(
+    const ArcMatrix<BoolVar>& vars,
+    const Int start,
+    const Int end
+)
+{
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::ConstrPaths, vars, start, end);
+
+    // Check.
+    const auto& arcs = vars.arcs();
+    const auto N = static_cast<Int>(arcs.nb_nodes());
+    release_assert(0 <= start && start < N && 0 <= end && end < N && start != end,
+                   "Invalid start node {} and end node {} of paths in a graph with {} nodes", start, end, N);
+    for (const auto var : vars)
+    {
+        release_assert(var.is_valid(),
+                       "Variable is not valid in creating paths constraint");
+    }
+
+    // Paths do not enter the start node or leave the end node.
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+        if (static_cast<Int>(arcs.head(a)) == start || static_cast<Int>(arcs.tail(a)) == end)
+        {
+            if (!add_constr_fix(get_neg(vars[a])))
+            {
+                return false;
+            }
+        }
+
+    // Leave and enter every other node once.
+    for (Int i = 0; i < N; ++i)
+        if (i != start && i != end)
+        {
+            const auto out_vars = vars.out(i);
+            if (!add_constr_set_partition(Vector<BoolVar>(out_vars.begin(), out_vars.end())))
+            {
+                return false;
+            }
+
+            Vector<BoolVar> in_vars;
+            for (const auto a : arcs.in_arcs(i))
+                in_vars.push_back(vars[a]);
+            if (!add_constr_set_partition(in_vars))
+            {
+                return false;
+            }
+        }
+
+    // Number the nodes in increasing order along each path, which eliminates subtours in CP, as in circuit.
+    const auto include_in_mip = method_ == Method::MIP;
+    Vector<IntVar> rank(N);
+    for (Int i = 0; i < N; ++i)
+        if (i != start && i != end)
+        {
+            rank[i] = add_int_var(1, N - 2, include_in_mip, fmt::format("paths_rank[{}]", i));
+        }
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        const auto i = static_cast<Int>(arcs.tail(a));
+        const auto j = static_cast<Int>(arcs.head(a));
+        if (rank[i].is_valid() && rank[j].is_valid())
+        {
+            // x[i,j] -> rank[i] + 1 <= rank[j]
+            if (!add_constr_reify_subtraction_leq(vars[a], rank[i], rank[j], -1))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Separate subtour elimination cuts in MIP.
+    scip_assert(includeSepaRouting(mip_, this, vars, Vector<Int>(N, 0), 1, start, end));
+
+    // Success.
+    return true;
+}
+
 }
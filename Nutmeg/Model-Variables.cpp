@@ -12,6 +12,9 @@ BoolVar Model::add_bool_var(
     const String& name    // Variable name
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddBoolVar, name);
+
     // Create variable object.
     BoolVar bool_var(this, nb_bool_vars());
 
@@ -43,6 +46,24 @@ BoolVar Model::add_bool_var(
     return bool_var;
 }
 
+ArcMatrix<BoolVar> Model::add_arc_vars(
+    const ArcSet& arcs,    // Arcs of the graph
+    const String& name     // Prefix of the variable names
+)
+{
+    // Create a variable for each arc in order of the arc indices. Each variable is recorded in the snapshot
+    // by itself.
+    ArcMatrix<BoolVar> vars(arcs);
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        const auto var_name = name.empty() ? String() : fmt::format("{}[{},{}]", name, arcs.tail(a), arcs.head(a));
+        vars[a] = add_bool_var(var_name);
+    }
+
+    // Return.
+    return vars;
+}
+
 IntVar Model::add_int_var(
     const Int lb,                 // Lower bound of the values
     const Int ub,                 // Upper bound of the values
@@ -50,6 +71,9 @@ IntVar Model::add_int_var(
     const String& name            // Variable name
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddIntVar, lb, ub, include_in_mip, name);
+
     // Check.
     release_assert(lb <= ub,
                    "Failed to create integer variable with bounds {} and {}", lb, ub);
@@ -112,6 +136,9 @@ IntVar Model::add_int_var(
 
 IntVar Model::add_mip_var(IntVar var)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddMipVar, var);
+
     // Check.
     release_assert(var.model == this, "Variable belongs to a different model");
     release_assert(0 <= var.idx && var.idx < nb_int_vars(), "Variable is invalid");
@@ -208,6 +235,9 @@ Vector<BoolVar> Model::add_indicator_vars(
     const Vector<Int>& domain
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddIndicatorVars, var, domain);
+
     // Check.
     release_assert(var.model == this, "Variable belongs to a different model");
     release_assert(0 <= var.idx && var.idx < nb_int_vars(), "Variable is invalid");
@@ -358,6 +388,9 @@ void Model::add_mip_int_var_as_bool_var_alias(
     IntVar int_var
 )
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::AddMipIntVarAsBoolVarAlias, bool_var, int_var);
+
     // Check.
     release_assert(int_var.model == this, "Integer variable belongs to a different model");
     release_assert(bool_var.model == this, "Boolean variable belongs to a different model");
@@ -376,6 +409,9 @@ void Model::add_mip_int_var_as_bool_var_alias(
 
 BoolVar Model::get_neg(const BoolVar var)
 {
+    // Record call.
+    const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::GetNeg, var);
+
     // Check.
     release_assert(var.model == this, "Variable belongs to a different model");
     release_assert(0 <= var.idx && var.idx < nb_bool_vars(), "Variable is invalid");
@@ -408,4 +444,16 @@ BoolVar Model::get_neg(const BoolVar var)
     return neg_var;
 }
 
+BoolVar Model::get_bool_var(const Int idx)
+{
+    release_assert(0 <= idx && idx < nb_bool_vars(), "Boolean variable {} does not exist", idx);
+    return BoolVar(this, idx);
+}
+
+IntVar Model::get_int_var(const Int idx)
+{
+    release_assert(0 <= idx && idx < nb_int_vars(), "Integer variable {} does not exist", idx);
+    return IntVar(this, idx);
+}
+
 }
@@ -3,6 +3,9 @@
 #include "Model.h"
 #include "ConstraintHandler-Geas.h"
 #include "EventHandler-NewSolution.h"
+#include "EventHandler-Timeline.h"
+#include "Table-Statistics.h"
+#include "Tracer.h"
 #include "scip/scipdefplugins.h"
 #include "geas/vars/monitor.h"
 
@@ -108,21 +111,50 @@ Model::Model(const Method method) :
     cp_(),
     print_new_solution_function_(),
 
-    probdata_(*this, cp_, sol_),
+    probdata_(*this, cp_, nogood_pool_, sol_, stats_, trace_, timeline_),
     status_(Status::Unknown),
     obj_(std::numeric_limits<Float>::quiet_NaN()),
     obj_bound_(std::numeric_limits<Float>::quiet_NaN()),
     sol_(),
+    stats_(),
+    timeline_(),
 
     time_limit_(),
     start_time_(),
-    run_time_(0)
+    run_time_(0),
+
+    nogood_pool_(),
+    cuts_export_path_(),
+    bool_vars_key_(),
+    int_vars_key_(),
+    var_keys_(),
+
+    checkpoint_path_(),
+    checkpoint_interval_(Infinity),
+    checkpoint_cp_clauses_(false),
+    last_checkpoint_time_(0),
+    resume_sol_(),
+    resume_obj_bound_(-Infinity),
+    resume_cp_dual_bound_(std::numeric_limits<Int>::min()),
+    resume_cp_clauses_(),
+
+    memory_limit_(Infinity),
+    memory_limit_reached_(false),
+    nb_memory_checks_(0),
+
+    trace_path_(),
+    trace_(),
+
+    snapshot_()
 {
     // Print.
 #ifndef NDEBUG
     println("Nutmeg is compiled in debug mode");
 #endif
 
+    // Start recording events if requested.
+    Tracer::enable_from_environment();
+
     // Create SCIP.
     scip_assert(SCIPcreate(&mip_));
 
@@ -212,11 +244,18 @@ Model::Model(const Method method) :
     }
 
     // Create constraint handler for Geas.
-    if (method_ == Method::BC)
+    if (method_ == Method::BC || method_ == Method::Dichotomic)
     {
         scip_assert(SCIPincludeConshdlrGeas(mip_));
         scip_assert(SCIPcreateConsBasicGeas(mip_, &probdata_.cp_cons_, "Geas"));
         scip_assert(SCIPaddCons(mip_, probdata_.cp_cons_));
+        scip_assert(includeTableNutmeg(mip_, this));
+    }
+
+    // Create event handler for recording the bounds.
+    if (method_ == Method::BC || method_ == Method::MIP || method_ == Method::Dichotomic)
+    {
+        scip_assert(includeEventHdlrTimeline(mip_, this));
     }
 
     // Linearize linking constraints for binarized variables.
@@ -260,7 +299,8 @@ Model::~Model()
 
 void Model::add_print_new_solution_function(std::function<void()> print_new_solution_function)
 {
-    if ((method_ == Method::BC || method_ == Method::MIP) && !print_new_solution_function_)
+    if ((method_ == Method::BC || method_ == Method::MIP || method_ == Method::Dichotomic) &&
+        !print_new_solution_function_)
     {
         print_new_solution_function_ = print_new_solution_function;
         scip_assert(includeEventHdlrBestsol(mip_, this));
@@ -273,6 +313,25 @@ void Model::add_print_new_solution_function(std::function<void()> print_new_solu
 
 void Model::minimize(const IntVar obj_var, const Float time_limit, const bool verbose)
 {
+    // Replay a trace of calls to the CP solver instead of solving.
+    if (const auto replay_path = std::getenv("NUTMEG_REPLAY_FILE"); replay_path)
+    {
+        replay_trace(replay_path);
+        return;
+    }
+
+    // Open trace.
+    if (const auto trace_path = std::getenv("NUTMEG_TRACE_FILE"); trace_path && method_ == Method::BC)
+    {
+        trace_path_ = trace_path;
+    }
+    if (!trace_path_.empty())
+    {
+        trace_.open(trace_path_, nb_bool_vars(), nb_int_vars());
+    }
+
+    // Solve.
+    timeline_.start();
     if (method_ == Method::BC)
     {
         minimize_using_bc(obj_var, time_limit, verbose);
@@ -289,10 +348,50 @@ void Model::minimize(const IntVar obj_var, const Float time_limit, const bool ve
     {
         minimize_using_cp(obj_var, time_limit, verbose);
     }
+    else if (method_ == Method::Dichotomic)
+    {
+        minimize_using_dichotomic(obj_var, time_limit, verbose);
+    }
     else
     {
         err("Invalid method {}", static_cast<Int>(method_));
     }
+
+    // Record the final dual bound.
+    if (status_ != Status::Infeasible && obj_bound_ > -Infinity)
+    {
+        timeline_.add_dual_bound(obj_bound_, method_ == Method::CP ? BoundSource::CPSearch : BoundSource::Relaxation);
+    }
+    timeline_.stop();
+
+    // Export the cuts.
+    if (!cuts_export_path_.empty())
+    {
+        const auto nb_cuts = export_cuts(cuts_export_path_);
+        if (verbose)
+        {
+            println("Exported {} cuts to {}", nb_cuts, cuts_export_path_);
+        }
+    }
+
+    // Print memory.
+    if (verbose)
+    {
+        println("");
+        print_memory_usage();
+    }
+
+    // Write results for the benchmark driver.
+    if (const auto results_path = std::getenv("NUTMEG_RESULTS_FILE"); results_path)
+    {
+        write_results(results_path);
+    }
+
+    // Write the events recorded by the tracer.
+    if (const auto tracer_path = std::getenv("NUTMEG_TRACER"); tracer_path && Tracer::is_enabled())
+    {
+        Tracer::dump(tracer_path);
+    }
 }
 
 Status Model::get_status() const
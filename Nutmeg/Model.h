@@ -5,6 +5,8 @@
 #include "Variable.h"
 #include "ProblemData.h"
 #include "Solution.h"
+#include "Snapshot.h"
+#include "ArcMatrix.h"
 
 namespace Nutmeg
 {
@@ -21,7 +23,8 @@ enum class Method
     BC,
     LBBD,
     CP,
-    MIP
+    MIP,
+    Dichotomic
 };
 
 enum class Status
@@ -33,6 +36,10 @@ enum class Status
     Error
 };
 
+Method get_method(const String& name);
+const char* get_method_name(const Method method);
+const char* get_status_name(const Status status);
+
 class Model
 {
     // Solvers
@@ -47,12 +54,43 @@ class Model
     Float obj_;
     Float obj_bound_;
     Solution sol_;
+    Statistics stats_;
+    Timeline timeline_;
 
     // Timer
     Float time_limit_;
     clock_t start_time_;
     Float run_time_;
 
+    // Nogoods
+    Vector<Nogood> nogood_pool_;
+    String cuts_export_path_;
+    Vector<String> bool_vars_key_;
+    Vector<String> int_vars_key_;
+    HashTable<String, Pair<bool, Int>> var_keys_;
+
+    // Checkpoint
+    String checkpoint_path_;
+    Float checkpoint_interval_;
+    bool checkpoint_cp_clauses_;
+    Float last_checkpoint_time_;
+    Solution resume_sol_;
+    Float resume_obj_bound_;
+    Int resume_cp_dual_bound_;
+    Vector<Nogood> resume_cp_clauses_;
+
+    // Memory
+    Float memory_limit_;
+    bool memory_limit_reached_;
+    int64_t nb_memory_checks_;
+
+    // Trace
+    String trace_path_;
+    Trace trace_;
+
+    // Snapshot
+    Snapshot snapshot_;
+
   public:
     // Constructors
     // ------------
@@ -69,11 +107,17 @@ class Model
     inline geas::solver_data*& cp_data() { return cp_.data; }
     inline geas::solver& cp() { return cp_; }
     inline SCIP* mip() { return mip_; }
-    inline void mark_as_infeasible() { status_ = Status::Infeasible; }
+    inline ProblemData& probdata() { return probdata_; }
+    inline void mark_as_infeasible()
+    {
+        const SnapshotScope snapshot_scope(snapshot_, SnapshotOp::MarkAsInfeasible);
+        status_ = Status::Infeasible;
+    }
 
     // Create variables
     // ----------------
     BoolVar add_bool_var(const String& name = "");
+    ArcMatrix<BoolVar> add_arc_vars(const ArcSet& arcs, const String& name = "");
     IntVar add_int_var(const Int lb,
                        const Int ub,
                        const bool include_in_mip = false,
@@ -95,6 +139,8 @@ class Model
     inline BoolVar get_false() { return BoolVar(this, 0); }
     inline BoolVar get_true() { return BoolVar(this, 1); }
     inline IntVar get_zero() { return IntVar(this, 0); }
+    BoolVar get_bool_var(const Int idx);
+    IntVar get_int_var(const Int idx);
     
     // Functions to get internal variables data
     // ----------------------------------------
@@ -172,6 +218,20 @@ class Model
                           const Sign sign,
                           const Int x_val);
 
+    // r -> coeff[0] * vars[0] + ... + coeffs[n-1] * vars[n-1] <= / == / >= rhs
+    bool add_constr_linear_imply(const BoolVar r,
+                                 const Vector<IntVar>& vars,
+                                 const Vector<Int>& coeffs,
+                                 const Sign sign,
+                                 const Int rhs);
+
+    // r <-> coeff[0] * vars[0] + ... + coeffs[n-1] * vars[n-1] <= / == / >= rhs
+    bool add_constr_linear_reif(const BoolVar r,
+                                const Vector<IntVar>& vars,
+                                const Vector<Int>& coeffs,
+                                const Sign sign,
+                                const Int rhs);
+
     // cumulative(start, duration, resource, capacity)
     bool add_constr_cumulative(const Vector<IntVar>& start,
                                const Vector<Int>& duration,
@@ -187,6 +247,55 @@ class Model
                                         const Int capacity,
                                         const IntVar makespan = {});
 
+    // disjunctive(start, duration): no two tasks overlap in time
+    bool add_constr_disjunctive(const Vector<IntVar>& start,
+                                const Vector<Int>& duration);
+
+    // disjunctive(start, duration) over the tasks with active[i] true
+    // start[i] + duration[i] <= makespan for all i
+    bool add_constr_disjunctive_optional(const Vector<BoolVar>& active,
+                                         const Vector<IntVar>& start,
+                                         const Vector<Int>& duration,
+                                         const IntVar makespan = {});
+
+    // (vars[0], ..., vars[n-1]) is equal to one of the rows of tuples
+    // Geas builds its table from one vector per row, so the rows are briefly held twice while the constraint is
+    // created. Tables of millions of rows need that much memory on top of tuples. In MIP, the tuples are only
+    // linearized for tables of up to TABLE_MIP_MAX_TUPLES rows, except when solving using MIP.
+    bool add_constr_table(const Vector<IntVar>& vars, const Matrix<Int>& tuples);
+
+    // sum(i in items with active[i] and bin[i] == b) (size[i]) <= capacity for all b
+    // active[i] -> bin[i] < nb_bins for all i
+    // Decomposed into a load variable for every bin linked to the total size of the active items and L2 lower
+    // bounds on the number of bins. The loads are only created in MIP, as knapsack rows, if solving using MIP or if
+    // the bins are already binarized in MIP.
+    bool add_constr_bin_packing(const Vector<IntVar>& bin,
+                                const Vector<Int>& size,
+                                const Vector<BoolVar>& active,
+                                const Int capacity,
+                                const IntVar nb_bins = {});
+
+    // vars[a] is true if arc a is on a circuit that visits every node of the graph once
+    // Decomposed into degree constraints, node ranks and subtour elimination cuts. There is no circuit
+    // propagator in CP.
+    bool add_constr_circuit(const ArcMatrix<BoolVar>& vars);
+
+    // vars[a] is true if arc a is on one of the paths from start to end that together visit every other node of
+    // the graph once
+    // Decomposed in the same way as circuit. Subtour elimination cuts are replaced by the rounded capacity cuts
+    // of add_routing_cuts over the same arcs.
+    bool add_constr_paths(const ArcMatrix<BoolVar>& vars, const Int start, const Int end);
+
+    // Cut separators
+    // --------------
+    // Subtour elimination and rounded capacity cuts on the arc variables of a routing problem, in which every node
+    // other than the depots is visited once and the demand of the nodes on a route is at most the capacity
+    void add_routing_cuts(const ArcMatrix<BoolVar>& vars,
+                          const Vector<Int>& demand,
+                          const Int capacity,
+                          const Int start_depot,
+                          const Int end_depot);
+
     // Solve
     // -----
     void add_print_new_solution_function(std::function<void()> print_new_solution_function);
@@ -194,12 +303,54 @@ class Model
     void minimize(const IntVar obj_var, const Float time_limit = Infinity, const bool verbose = true);
     inline void print_new_solution() { print_new_solution_function_(); }
 
+    // Cut transfer
+    // ------------
+    void set_var_key(const BoolVar var, const String& key);
+    void set_var_key(const IntVar var, const String& key);
+    // The nogoods are only kept during the search if a checkpoint or an export of cuts is set before solving.
+    void set_cuts_export(const String& path);
+    Int export_cuts(const String& path) const;
+    Int import_cuts(const String& path);
+
+    // Checkpoint
+    // ----------
+    void set_checkpoint(const String& path, const Float interval, const bool save_cp_clauses = false);
+    void load_checkpoint(const String& path);
+    void write_checkpoint();
+    inline bool checkpoint_is_due() const
+    {
+        return !checkpoint_path_.empty() && get_cpu_time() - last_checkpoint_time_ >= checkpoint_interval_;
+    }
+
+    // Memory
+    // ------
+    MemoryUsage memory_usage() const;
+    void print_memory_usage() const;
+    void set_memory_limit(const Float megabytes);
+    bool check_memory_limit(bool& memory_pressure);
+
+    // Trace
+    // -----
+    void set_trace(const String& path);
+    void replay_trace(const String& path);
+
+    // Snapshot
+    // --------
+    void enable_snapshot();
+    void save_snapshot(const String& path) const;
+    void load_snapshot(const String& path);
+
     // Solution
     // --------
     Status get_status() const;
     Float get_runtime() const;
     Int get_dual_bound() const;
     Int get_primal_bound() const;
+    inline const Statistics& statistics() const { return stats_; }
+    inline Timeline& timeline() { return timeline_; }
+    inline const Timeline& timeline() const { return timeline_; }
+    int64_t get_nb_nodes() const;
+    void write_results(const String& path) const;
     bool get_sol(const BoolVar var);
     Int get_sol(const IntVar var);
 
@@ -214,6 +365,16 @@ class Model
     void minimize_using_lbbd(const IntVar obj_var, const Float time_limit, const bool verbose);
     void minimize_using_mip(const IntVar obj_var, const Float time_limit, const bool verbose);
     void minimize_using_cp(const IntVar obj_var, const Float time_limit, const bool verbose);
+    void minimize_using_dichotomic(const IntVar obj_var, const Float time_limit, const bool verbose);
+
+    // Checkpoint
+    // ----------
+    bool add_nogood(const Nogood& nogood);
+    void resume_from_checkpoint(const IntVar obj_var);
+
+    // Memory
+    // ------
+    void apply_memory_limit();
 
     // Timer
     // -----
@@ -0,0 +1,73 @@
+#ifndef NUTMEG_NOGOOD_H
+#define NUTMEG_NOGOOD_H
+
+#include "Includes.h"
+#include <istream>
+#include <ostream>
+
+namespace Nutmeg
+{
+
+// Literal [var >= bound] or [var <= bound] on a Nutmeg variable. Boolean literals have bound 1 for the
+// positive literal and bound 0 for the negative literal.
+struct NogoodLiteral
+{
+    Int var_idx;
+    bool is_int_var;
+    SCIP_BOUNDTYPE sign;
+    Int bound;
+};
+
+// Disjunction of literals stated in terms of Nutmeg variables so that it outlives the SCIP and Geas
+// representations of the problem.
+using Nogood = Vector<NogoodLiteral>;
+
+// Write a value in native endianness to a binary file
+template<class T>
+inline void write_value(std::ostream& file, const T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Read a value in native endianness from a binary file
+template<class T>
+inline T read_value(std::istream& file)
+{
+    T value;
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    release_assert(file, "File is truncated");
+    return value;
+}
+
+// Write a nogood as its size followed by its literals (index, type, sign, bound)
+inline void write_nogood(std::ostream& file, const Nogood& nogood)
+{
+    write_value<uint32_t>(file, nogood.size());
+    for (const auto& literal : nogood)
+    {
+        write_value<Int>(file, literal.var_idx);
+        write_value<uint8_t>(file, literal.is_int_var);
+        write_value<uint8_t>(file, literal.sign);
+        write_value<Int>(file, literal.bound);
+    }
+}
+
+// Read a nogood written by write_nogood and check its variables
+inline Nogood read_nogood(std::istream& file, const Int nb_bool_vars, const Int nb_int_vars)
+{
+    Nogood nogood(read_value<uint32_t>(file));
+    for (auto& literal : nogood)
+    {
+        literal.var_idx = read_value<Int>(file);
+        literal.is_int_var = read_value<uint8_t>(file);
+        literal.sign = read_value<uint8_t>(file) ? SCIP_BOUNDTYPE_UPPER : SCIP_BOUNDTYPE_LOWER;
+        literal.bound = read_value<Int>(file);
+        release_assert(0 <= literal.var_idx && literal.var_idx < (literal.is_int_var ? nb_int_vars : nb_bool_vars),
+                       "File contains invalid variable {}", literal.var_idx);
+    }
+    return nogood;
+}
+
+}
+
+#endif
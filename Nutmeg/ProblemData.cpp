@@ -4,7 +4,7 @@
 namespace Nutmeg
 {
 
-ProblemData::ProblemData(Model& model, geas::solver& cp, Solution& sol) noexcept :
+ProblemData::ProblemData(Model& model, geas::solver& cp, Vector<Nogood>& nogood_pool, Solution& sol, Statistics& stats, Trace& trace, Timeline& timeline) noexcept :
     model_(model),
 
     cp_cons_(nullptr),
@@ -33,7 +33,17 @@ ProblemData::ProblemData(Model& model, geas::solver& cp, Solution& sol) noexcept
     nb_indicator_vars_setpart_constraints_(0),
     nb_indicator_vars_linking_constraints_(0),
 
-    sol_(sol)
+    nogood_pool_(nogood_pool),
+    record_nogoods_(false),
+
+    memory_soft_limit_(std::numeric_limits<int64_t>::max()),
+    memory_pressure_(false),
+
+    sol_(sol),
+
+    stats_(stats),
+    trace_(trace),
+    timeline_(timeline)
 {
 }
 
@@ -124,6 +134,20 @@ geas::intvar ProblemData::cp_var(const IntVar var) const
     return cp_int_vars_[var.idx];
 }
 
+geas::patom_t ProblemData::cp_atom(const NogoodLiteral& literal) const
+{
+    if (literal.is_int_var)
+    {
+        const auto& cp_var = cp_int_vars_[literal.var_idx];
+        return literal.sign == SCIP_BOUNDTYPE_LOWER ? cp_var >= literal.bound : cp_var <= literal.bound;
+    }
+    else
+    {
+        const auto& cp_var = cp_bool_vars_[literal.var_idx];
+        return literal.sign == SCIP_BOUNDTYPE_LOWER ? cp_var : ~cp_var;
+    }
+}
+
 Int ProblemData::lb(const IntVar var) const
 {
     release_assert(var.model == &model_, "Variable belongs to a different model");
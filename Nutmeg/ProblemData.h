@@ -4,6 +4,10 @@
 #include "Includes.h"
 #include "Variable.h"
 #include "Solution.h"
+#include "Nogood.h"
+#include "Statistics.h"
+#include "Trace.h"
+#include "Timeline.h"
 #include "geas/solver/solver.h"
 #include "geas/constraints/builtins.h"
 #include "geas/vars/pred_var.h"
@@ -50,13 +54,26 @@ struct ProblemData
     Int nb_indicator_vars_setpart_constraints_;
     Int nb_indicator_vars_linking_constraints_;
 
+    // Nogoods
+    Vector<Nogood>& nogood_pool_;
+    bool record_nogoods_;
+
+    // Memory
+    int64_t memory_soft_limit_;
+    bool memory_pressure_;
+
     // Solution
     Solution& sol_;
 
+    // Statistics
+    Statistics& stats_;
+    Trace& trace_;
+    Timeline& timeline_;
+
   public:
     // Constructors
     ProblemData() noexcept = delete;
-    ProblemData(Model& model, geas::solver& cp, Solution& sol) noexcept;
+    ProblemData(Model& model, geas::solver& cp, Vector<Nogood>& nogood_pool, Solution& sol, Statistics& stats, Trace& trace, Timeline& timeline) noexcept;
     ProblemData(const ProblemData& probdata) = default;
     ProblemData(ProblemData&& probdata) noexcept = delete;
     ProblemData& operator=(const ProblemData& probdata) noexcept = delete;
@@ -75,6 +92,7 @@ struct ProblemData
     SCIP_VAR* mip_indicator_var(const IntVar var, const Int val) const;
     geas::patom_t cp_var(const BoolVar var) const;
     geas::intvar cp_var(const IntVar var) const;
+    geas::patom_t cp_atom(const NogoodLiteral& literal) const;
     Int lb(const IntVar var) const;
     Int ub(const IntVar var) const;
     const String& name(const BoolVar var) const;
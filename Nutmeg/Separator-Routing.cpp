@@ -0,0 +1,590 @@
+//#define PRINT_DEBUG
+
+#include "Separator-Routing.h"
+#include "Model.h"
+#include <numeric>
+#include <queue>
+#include <set>
+
+#define SEPA_NAME                                    "routing"
+#define SEPA_DESC   "subtour elimination and rounded capacity cuts"
+#define SEPA_PRIORITY                                     1000 // priority of the separator
+#define SEPA_FREQ                                            1 // frequency for calling separator
+#define SEPA_MAXBOUNDDIST                                  1.0 // maximal relative distance from current node's dual bound to
+                                                               // primal bound compared to best node's dual bound for applying
+                                                               // separation
+#define SEPA_USESSUBSCIP                                 FALSE // does the separator use a secondary SCIP instance?
+#define SEPA_DELAY                                       FALSE // should separation method be delayed, if other separators
+                                                               // found cuts?
+
+#define MIN_ARC_VALUE                                     1e-6 // arcs with a smaller value are not in the support graph
+#define MIN_VIOLATION                                     1e-2 // minimum violation of an added cut
+#define MAX_CUTS_PER_ROUND                                 200
+
+using namespace Nutmeg;
+
+// Data of the separator
+struct SepaRoutingData
+{
+    ArcSet arcs;                           // Arcs of the graph
+    Vector<SCIP_VAR*> vars;                // Arc variables in the original problem
+    Vector<SCIP_VAR*> trans_vars;          // Arc variables in the transformed problem
+    Vector<Int> demand;                    // Demand of each node
+    Int capacity;                          // Capacity of a vehicle
+    size_t start_depot;                    // Node at which routes start
+    size_t end_depot;                      // Node at which routes end
+
+    // Buffers
+    Vector<Float> x;                       // Value of the arcs in the LP solution
+    Vector<bool> in_set;                   // Nodes in the set being checked
+    Vector<bool> covered;                  // Nodes in a set with a violated cut
+    std::set<Vector<size_t>> cut_sets;     // Sets with a violated cut in this round
+    Int nb_cuts;                           // Number of cuts added in this round
+    bool is_infeasible;                    // Whether a cut is infeasible
+};
+
+// Network of the support graph of the LP solution for computing maximum flows
+struct FlowNetwork
+{
+    Vector<Vector<size_t>> adj;    // Edges leaving each node
+    Vector<size_t> to;             // Head of each edge, where edge e ^ 1 is the reverse of edge e
+    Vector<Float> residual;        // Residual capacity of each edge
+    Vector<Float> capacity;        // Capacity of each edge
+    Vector<Int> level;
+    Vector<size_t> next;
+};
+
+static inline
+bool is_customer(
+    const SepaRoutingData& data,    // Separator data
+    const size_t i                  // Node
+)
+{
+    return i != data.start_depot && i != data.end_depot;
+}
+
+// Add the cut x(A(S)) <= |S| - max(1, ceil(q(S) / Q)) if it is violated, where A(S) is the arcs inside the set S of
+// customers
+static
+SCIP_RETCODE add_cut_if_violated(
+    SCIP* scip,                  // SCIP
+    SCIP_SEPA* sepa,             // Separator
+    SepaRoutingData& data,       // Separator data
+    Vector<size_t>& set          // Customers in the set
+)
+{
+    // Check if the set is already cut.
+    std::sort(set.begin(), set.end());
+    if (set.empty() || data.cut_sets.count(set))
+    {
+        return SCIP_OKAY;
+    }
+
+    // Compute the value of the arcs inside the set and the demand of the set.
+    for (const auto i : set)
+    {
+        debug_assert(is_customer(data, i));
+        data.in_set[i] = true;
+    }
+    Float inside = 0;
+    Int demand = 0;
+    for (const auto i : set)
+    {
+        for (const auto a : data.arcs.out_arcs(i))
+            if (data.in_set[data.arcs.head(a)])
+            {
+                inside += data.x[a];
+            }
+        demand += data.demand[i];
+    }
+    const Int nb_vehicles = std::max<Int>(1, (demand + data.capacity - 1) / data.capacity);
+    const auto rhs = static_cast<Float>(set.size()) - nb_vehicles;
+
+    // Add the cut if violated.
+    if (inside > rhs + MIN_VIOLATION)
+    {
+        // Create row.
+        SCIP_ROW* row = nullptr;
+        const auto name = fmt::format("{}_{}", nb_vehicles == 1 ? "sec" : "rci", data.cut_sets.size());
+        SCIP_CALL(SCIPcreateEmptyRowSepa(scip, &row, sepa, name.c_str(), -SCIPinfinity(scip), rhs, FALSE, FALSE, TRUE));
+        SCIP_CALL(SCIPcacheRowExtensions(scip, row));
+        for (const auto i : set)
+            for (const auto a : data.arcs.out_arcs(i))
+                if (data.in_set[data.arcs.head(a)])
+                {
+                    SCIP_CALL(SCIPaddVarToRow(scip, row, data.trans_vars[a], 1.0));
+                }
+        SCIP_CALL(SCIPflushRowExtensions(scip, row));
+        debugln("   Routing cut {} on {} customers with demand {} and value {} > {}",
+                name, set.size(), demand, inside, rhs);
+
+        // Add row.
+        if (SCIPisCutEfficacious(scip, nullptr, row))
+        {
+            SCIP_Bool infeasible = FALSE;
+            SCIP_CALL(SCIPaddRow(scip, row, FALSE, &infeasible));
+            SCIP_CALL(SCIPaddPoolCut(scip, row));
+            data.is_infeasible |= infeasible;
+            ++data.nb_cuts;
+        }
+        SCIP_CALL(SCIPreleaseRow(scip, &row));
+
+        // Store the set.
+        for (const auto i : set)
+            data.covered[i] = true;
+        data.cut_sets.insert(set);
+    }
+
+    // Clear the set.
+    for (const auto i : set)
+        data.in_set[i] = false;
+
+    // Done.
+    return SCIP_OKAY;
+}
+
+// Check the connected components of the support graph over the customers
+static
+SCIP_RETCODE separate_components(
+    SCIP* scip,                  // SCIP
+    SCIP_SEPA* sepa,             // Separator
+    SepaRoutingData& data        // Separator data
+)
+{
+    // Find the components using union-find.
+    const auto nb_nodes = data.arcs.nb_nodes();
+    Vector<size_t> parent(nb_nodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (size_t a = 0; a < data.arcs.nb_arcs(); ++a)
+    {
+        const auto i = data.arcs.tail(a);
+        const auto j = data.arcs.head(a);
+        if (data.x[a] > MIN_ARC_VALUE && is_customer(data, i) && is_customer(data, j))
+        {
+            parent[find(i)] = find(j);
+        }
+    }
+
+    // Check each component.
+    Vector<Vector<size_t>> components(nb_nodes);
+    for (size_t i = 0; i < nb_nodes; ++i)
+        if (is_customer(data, i))
+        {
+            components[find(i)].push_back(i);
+        }
+    for (auto& set : components)
+        if (!set.empty() && data.nb_cuts < MAX_CUTS_PER_ROUND)
+        {
+            SCIP_CALL(add_cut_if_violated(scip, sepa, data, set));
+        }
+
+    // Done.
+    return SCIP_OKAY;
+}
+
+// Grow a set from each customer by adding the customer with the largest value of arcs to and from the set, and check the
+// most violated rounded capacity inequality on the way
+static
+SCIP_RETCODE separate_greedy(
+    SCIP* scip,                  // SCIP
+    SCIP_SEPA* sepa,             // Separator
+    SepaRoutingData& data        // Separator data
+)
+{
+    const auto nb_nodes = data.arcs.nb_nodes();
+    Vector<Float> weight(nb_nodes, 0.0);
+    Vector<size_t> touched;
+    Vector<size_t> set;
+    for (size_t seed = 0; seed < nb_nodes && data.nb_cuts < MAX_CUTS_PER_ROUND; ++seed)
+        if (is_customer(data, seed))
+        {
+            // Start with the seed.
+            std::priority_queue<Pair<Float, size_t>> queue;
+            auto add = [&](const size_t i)
+            {
+                set.push_back(i);
+                data.in_set[i] = true;
+                for (const auto a : data.arcs.out_arcs(i))
+                {
+                    const auto j = data.arcs.head(a);
+                    if (data.x[a] > MIN_ARC_VALUE && is_customer(data, j) && !data.in_set[j])
+                    {
+                        touched.push_back(j);
+                        weight[j] += data.x[a];
+                        queue.emplace(weight[j], j);
+                    }
+                }
+                for (const auto a : data.arcs.in_arcs(i))
+                {
+                    const auto j = data.arcs.tail(a);
+                    if (data.x[a] > MIN_ARC_VALUE && is_customer(data, j) && !data.in_set[j])
+                    {
+                        touched.push_back(j);
+                        weight[j] += data.x[a];
+                        queue.emplace(weight[j], j);
+                    }
+                }
+            };
+            add(seed);
+            Float inside = 0;
+            Int demand = data.demand[seed];
+            Float best_violation = 0;
+            size_t best_size = 0;
+
+            // Add customers until the set is disconnected from the rest.
+            while (!queue.empty())
+            {
+                const auto [w, j] = queue.top();
+                queue.pop();
+                if (data.in_set[j] || w != weight[j])
+                {
+                    continue;
+                }
+
+                inside += w;
+                demand += data.demand[j];
+                add(j);
+
+                const Int nb_vehicles = std::max<Int>(1, (demand + data.capacity - 1) / data.capacity);
+                const auto violation = inside - (static_cast<Float>(set.size()) - nb_vehicles);
+                if (violation > best_violation)
+                {
+                    best_violation = violation;
+                    best_size = set.size();
+                }
+            }
+
+            // Clear the set.
+            for (const auto i : set)
+                data.in_set[i] = false;
+            for (const auto i : touched)
+                weight[i] = 0.0;
+            touched.clear();
+
+            // Add cut for the most violated prefix.
+            if (best_violation > MIN_VIOLATION)
+            {
+                set.resize(best_size);
+                SCIP_CALL(add_cut_if_violated(scip, sepa, data, set));
+            }
+            set.clear();
+        }
+
+    // Done.
+    return SCIP_OKAY;
+}
+
+static
+bool flow_bfs(
+    FlowNetwork& net,    // Network
+    const size_t s,      // Source
+    const size_t t       // Sink
+)
+{
+    std::fill(net.level.begin(), net.level.end(), -1);
+    std::queue<size_t> queue;
+    net.level[s] = 0;
+    queue.push(s);
+    while (!queue.empty())
+    {
+        const auto u = queue.front();
+        queue.pop();
+        for (const auto e : net.adj[u])
+            if (net.residual[e] > MIN_ARC_VALUE && net.level[net.to[e]] < 0)
+            {
+                net.level[net.to[e]] = net.level[u] + 1;
+                queue.push(net.to[e]);
+            }
+    }
+    return net.level[t] >= 0;
+}
+
+static
+Float flow_dfs(
+    FlowNetwork& net,    // Network
+    const size_t u,      // Current node
+    const size_t t,      // Sink
+    const Float limit    // Maximum flow to push
+)
+{
+    if (u == t)
+    {
+        return limit;
+    }
+    for (auto& k = net.next[u]; k < net.adj[u].size(); ++k)
+    {
+        const auto e = net.adj[u][k];
+        const auto v = net.to[e];
+        if (net.residual[e] > MIN_ARC_VALUE && net.level[v] == net.level[u] + 1)
+        {
+            const auto pushed = flow_dfs(net, v, t, std::min(limit, net.residual[e]));
+            if (pushed > MIN_ARC_VALUE)
+            {
+                net.residual[e] -= pushed;
+                net.residual[e ^ 1] += pushed;
+                return pushed;
+            }
+        }
+    }
+    return 0;
+}
+
+// Find minimum cuts between the start depot and each customer, which give violated subtour elimination constraints
+// x(A(S)) <= |S| - 1 for the customers S cut off from the start depot when the support graph is connected
+static
+SCIP_RETCODE separate_min_cut(
+    SCIP* scip,                  // SCIP
+    SCIP_SEPA* sepa,             // Separator
+    SepaRoutingData& data        // Separator data
+)
+{
+    // Create network of the support graph.
+    const auto nb_nodes = data.arcs.nb_nodes();
+    FlowNetwork net;
+    net.adj.resize(nb_nodes);
+    net.level.resize(nb_nodes);
+    net.next.resize(nb_nodes);
+    for (size_t a = 0; a < data.arcs.nb_arcs(); ++a)
+        if (data.x[a] > MIN_ARC_VALUE)
+        {
+            const auto i = data.arcs.tail(a);
+            const auto j = data.arcs.head(a);
+            net.adj[i].push_back(net.to.size());
+            net.to.push_back(j);
+            net.capacity.push_back(data.x[a]);
+            net.adj[j].push_back(net.to.size());
+            net.to.push_back(i);
+            net.capacity.push_back(0.0);
+        }
+
+    // Compute the maximum flow to each customer not in an already violated set.
+    Vector<size_t> set;
+    for (size_t t = 0; t < nb_nodes && data.nb_cuts < MAX_CUTS_PER_ROUND; ++t)
+        if (is_customer(data, t) && !data.covered[t])
+        {
+            // Compute maximum flow up to 1.
+            net.residual = net.capacity;
+            Float flow = 0;
+            while (flow < 1.0 - MIN_VIOLATION && flow_bfs(net, data.start_depot, t))
+            {
+                std::fill(net.next.begin(), net.next.end(), 0);
+                Float pushed;
+                while ((pushed = flow_dfs(net, data.start_depot, t, 1.0 - flow)) > MIN_ARC_VALUE)
+                {
+                    flow += pushed;
+                }
+            }
+            if (flow >= 1.0 - MIN_VIOLATION)
+            {
+                continue;
+            }
+
+            // Get the customers that reach the sink in the residual network.
+            set.clear();
+            set.push_back(t);
+            data.in_set[t] = true;
+            for (size_t k = 0; k < set.size(); ++k)
+                for (const auto e : net.adj[set[k]])
+                {
+                    const auto u = net.to[e];
+                    if (!data.in_set[u] && net.residual[e ^ 1] > MIN_ARC_VALUE)
+                    {
+                        data.in_set[u] = true;
+                        set.push_back(u);
+                    }
+                }
+            for (const auto i : set)
+                data.in_set[i] = false;
+            debug_assert(!std::count(set.begin(), set.end(), data.start_depot));
+            set.erase(std::remove(set.begin(), set.end(), data.end_depot), set.end());
+
+            // Add cut.
+            SCIP_CALL(add_cut_if_violated(scip, sepa, data, set));
+            data.covered[t] = true;
+        }
+
+    // Done.
+    return SCIP_OKAY;
+}
+
+// Initialization method of separator (called after problem was transformed)
+static
+SCIP_DECL_SEPAINIT(sepaInitRouting)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(sepa);
+    debug_assert(strncmp(SCIPsepaGetName(sepa), SEPA_NAME, strlen(SEPA_NAME)) == 0);
+
+    // Get the transformed variables.
+    auto& data = *reinterpret_cast<SepaRoutingData*>(SCIPsepaGetData(sepa));
+    data.trans_vars.resize(data.vars.size());
+    SCIP_CALL(SCIPgetTransformedVars(scip, static_cast<int>(data.vars.size()), data.vars.data(), data.trans_vars.data()));
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// Destructor of separator to free user data (called when SCIP is exiting)
+static
+SCIP_DECL_SEPAFREE(sepaFreeRouting)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(sepa);
+    debug_assert(strncmp(SCIPsepaGetName(sepa), SEPA_NAME, strlen(SEPA_NAME)) == 0);
+
+    // Free separator data.
+    delete reinterpret_cast<SepaRoutingData*>(SCIPsepaGetData(sepa));
+    SCIPsepaSetData(sepa, nullptr);
+
+    // Exit.
+    return SCIP_OKAY;
+}
+
+// LP solution separation method of separator
+static
+SCIP_DECL_SEPAEXECLP(sepaExeclpRouting)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(sepa);
+    debug_assert(result);
+    debug_assert(strncmp(SCIPsepaGetName(sepa), SEPA_NAME, strlen(SEPA_NAME)) == 0);
+    *result = SCIP_DIDNOTRUN;
+    if (!SCIPhasCurrentNodeLP(scip) || SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL)
+    {
+        return SCIP_OKAY;
+    }
+
+    // Get the LP solution.
+    auto& data = *reinterpret_cast<SepaRoutingData*>(SCIPsepaGetData(sepa));
+    for (size_t a = 0; a < data.arcs.nb_arcs(); ++a)
+    {
+        data.x[a] = SCIPgetSolVal(scip, nullptr, data.trans_vars[a]);
+    }
+    data.cut_sets.clear();
+    std::fill(data.covered.begin(), data.covered.end(), false);
+    data.nb_cuts = 0;
+    data.is_infeasible = false;
+
+    // Separate. Minimum cuts are only computed when the cheaper heuristics fail.
+    SCIP_CALL(separate_components(scip, sepa, data));
+    SCIP_CALL(separate_greedy(scip, sepa, data));
+    if (data.nb_cuts == 0)
+    {
+        SCIP_CALL(separate_min_cut(scip, sepa, data));
+    }
+    debugln("Routing separator added {} cuts", data.nb_cuts);
+
+    // Exit.
+    *result = data.is_infeasible ? SCIP_CUTOFF : data.nb_cuts > 0 ? SCIP_SEPARATED : SCIP_DIDNOTFIND;
+    return SCIP_OKAY;
+}
+
+// Include separator for routing cuts
+SCIP_RETCODE Nutmeg::includeSepaRouting(
+    SCIP* scip,                         // SCIP
+    Model* model,                       // Model
+    const ArcMatrix<BoolVar>& vars,     // Arc variables
+    const Vector<Int>& demand,          // Demand of each node
+    const Int capacity,                 // Capacity of a vehicle
+    const Int start_depot,              // Node at which routes start
+    const Int end_depot                 // Node at which routes end
+)
+{
+    // Check.
+    const auto& arcs = vars.arcs();
+    const auto nb_nodes = static_cast<Int>(arcs.nb_nodes());
+    release_assert(static_cast<Int>(demand.size()) == nb_nodes,
+                   "Demand of {} nodes is given for a graph with {} nodes", demand.size(), nb_nodes);
+    release_assert(capacity > 0, "Vehicle capacity {} is not positive", capacity);
+    release_assert(0 <= start_depot && start_depot < nb_nodes && 0 <= end_depot && end_depot < nb_nodes,
+                   "Depot is not a node of the graph");
+    for (const auto q : demand)
+    {
+        release_assert(q >= 0, "Demand {} is negative", q);
+    }
+
+    // Get the arc variables in MIP.
+    Vector<SCIP_VAR*> mip_vars;
+    mip_vars.reserve(arcs.nb_arcs());
+    for (const auto var : vars)
+    {
+        release_assert(var.is_valid(), "Arc variable is invalid");
+        mip_vars.push_back(model->mip_var(var));
+    }
+
+    // Merge with a separator over the same arcs and depots. Subtour elimination cuts, which have no demand,
+    // are rounded capacity cuts with zero demand, so they are replaced by rounded capacity cuts instead of
+    // being separated twice.
+    const auto has_demand = std::any_of(demand.begin(), demand.end(), [](const Int q) { return q > 0; });
+    String name = SEPA_NAME;
+    for (Int k = 1; SCIP_SEPA* sepa = SCIPfindSepa(scip, name.c_str()); ++k)
+    {
+        auto& data = *reinterpret_cast<SepaRoutingData*>(SCIPsepaGetData(sepa));
+        if (data.vars == mip_vars &&
+            data.start_depot == static_cast<size_t>(start_depot) &&
+            data.end_depot == static_cast<size_t>(end_depot))
+        {
+            const auto had_demand = std::any_of(data.demand.begin(), data.demand.end(), [](const Int q) { return q > 0; });
+            if (!has_demand)
+            {
+                return SCIP_OKAY;
+            }
+            else if (!had_demand)
+            {
+                data.demand = demand;
+                data.capacity = capacity;
+                return SCIP_OKAY;
+            }
+        }
+        name = fmt::format("{}_{}", SEPA_NAME, k);
+    }
+
+    // Create separator data.
+    auto data = new SepaRoutingData;
+    data->arcs = arcs;
+    data->vars = std::move(mip_vars);
+    data->demand = demand;
+    data->capacity = capacity;
+    data->start_depot = start_depot;
+    data->end_depot = end_depot;
+    data->x.resize(arcs.nb_arcs());
+    data->in_set.resize(arcs.nb_nodes());
+    data->covered.resize(arcs.nb_nodes());
+    data->nb_cuts = 0;
+    data->is_infeasible = false;
+
+    // Create separator.
+    SCIP_SEPA* sepa = nullptr;
+    scip_assert(SCIPincludeSepaBasic(scip,
+                                     &sepa,
+                                     name.c_str(),
+                                     SEPA_DESC,
+                                     SEPA_PRIORITY,
+                                     SEPA_FREQ,
+                                     SEPA_MAXBOUNDDIST,
+                                     SEPA_USESSUBSCIP,
+                                     SEPA_DELAY,
+                                     sepaExeclpRouting,
+                                     nullptr,
+                                     reinterpret_cast<SCIP_SEPADATA*>(data)));
+    debug_assert(sepa);
+
+    // Attach initialisation and clean-up functions.
+    scip_assert(SCIPsetSepaInit(scip, sepa, sepaInitRouting));
+    scip_assert(SCIPsetSepaFree(scip, sepa, sepaFreeRouting));
+
+    // Exit.
+    return SCIP_OKAY;
+}
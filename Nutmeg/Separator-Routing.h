@@ -0,0 +1,25 @@
+#ifndef NUTMEG_SEPARATOR_ROUTING_H
+#define NUTMEG_SEPARATOR_ROUTING_H
+
+#include "Includes.h"
+#include "Variable.h"
+#include "ArcMatrix.h"
+
+namespace Nutmeg
+{
+
+class Model;
+
+// Include a separator of rounded capacity cuts, which are subtour elimination cuts if every demand is zero. A
+// separator over the same arcs and depots is reused, keeping the cuts with demands.
+SCIP_RETCODE includeSepaRouting(SCIP* scip,
+                                Model* model,
+                                const ArcMatrix<BoolVar>& vars,
+                                const Vector<Int>& demand,
+                                const Int capacity,
+                                const Int start_depot,
+                                const Int end_depot);
+
+}
+
+#endif
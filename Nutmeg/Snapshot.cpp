@@ -0,0 +1,111 @@
+#include "Snapshot.h"
+#include "Model.h"
+#include <fstream>
+
+// Snapshot file layout (native endianness):
+//   header (magic, version, solving method, number of Boolean and integer variables, number of calls,
+//           size of the calls)
+//   calls
+// where each call is its function followed by its arguments, variables are written as their indices,
+// and vectors and strings are written as their size followed by their elements.
+#define SNAPSHOT_MAGIC                          "NUTMEGSN"
+#define SNAPSHOT_MAGIC_SIZE                              8
+#define SNAPSHOT_VERSION                                 1
+
+namespace Nutmeg
+{
+
+void Snapshot::save(const String& path, const uint32_t method, const Int nb_bool_vars, const Int nb_int_vars) const
+{
+    // Create header.
+    SnapshotHeader header{};
+    std::copy(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + SNAPSHOT_MAGIC_SIZE, header.magic);
+    header.version = SNAPSHOT_VERSION;
+    header.method = method;
+    header.nb_bool_vars = nb_bool_vars;
+    header.nb_int_vars = nb_int_vars;
+    header.nb_ops = nb_ops_;
+    header.data_size = data_.size();
+
+    // Write to a temporary file and rename it so that a partial snapshot is never read.
+    const auto tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        release_assert(file, "Cannot open file {} for writing snapshot", tmp_path);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data_.data(), data_.size());
+        file.flush();
+        release_assert(file, "Failed to write snapshot {}", tmp_path);
+    }
+    release_assert(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+                   "Failed to rename snapshot {} to {}", tmp_path, path);
+}
+
+SnapshotReader::SnapshotReader(const String& path, Model* model) :
+    file_(path),
+    path_(path),
+    model_(model),
+    header_(),
+    p_(nullptr),
+    end_(nullptr)
+{
+    // Check header.
+    release_assert(file_.size() >= sizeof(SnapshotHeader), "File {} is not a snapshot", path_);
+    std::memcpy(&header_, file_.data(), sizeof(SnapshotHeader));
+    release_assert(std::equal(header_.magic, header_.magic + SNAPSHOT_MAGIC_SIZE, SNAPSHOT_MAGIC),
+                   "File {} is not a snapshot", path_);
+    release_assert(header_.version == SNAPSHOT_VERSION,
+                   "Snapshot {} has unsupported version {}", path_, header_.version);
+    release_assert(header_.data_size == file_.size() - sizeof(SnapshotHeader),
+                   "Snapshot {} is truncated", path_);
+
+    // Start at the first call.
+    p_ = file_.begin() + sizeof(SnapshotHeader);
+    end_ = file_.end();
+}
+
+const char* SnapshotReader::read_bytes(const size_t size)
+{
+    release_assert(size <= static_cast<size_t>(end_ - p_), "Snapshot {} is truncated", path_);
+    const auto data = p_;
+    p_ += size;
+    return data;
+}
+
+void SnapshotReader::read(BoolVar& var)
+{
+    Int idx;
+    read(idx);
+    release_assert(-1 <= idx && idx < model_->nb_bool_vars(), "Snapshot {} is corrupted", path_);
+    var = idx >= 0 ? BoolVar(model_, idx) : BoolVar();
+}
+
+void SnapshotReader::read(IntVar& var)
+{
+    Int idx;
+    read(idx);
+    release_assert(-1 <= idx && idx < model_->nb_int_vars(), "Snapshot {} is corrupted", path_);
+    var = idx >= 0 ? IntVar(model_, idx) : IntVar();
+}
+
+void SnapshotReader::read(ArcSet& arcs)
+{
+    uint64_t nb_nodes;
+    uint64_t nb_arcs;
+    read(nb_nodes);
+    read(nb_arcs);
+    release_assert(nb_arcs <= static_cast<uint64_t>(end_ - p_) / (2 * sizeof(uint64_t)), "Snapshot {} is truncated", path_);
+    std::vector<std::pair<size_t, size_t>> arcs_list(nb_arcs);
+    for (auto& [tail, head] : arcs_list)
+    {
+        uint64_t value;
+        read(value);
+        tail = value;
+        read(value);
+        head = value;
+        release_assert(tail < nb_nodes && head < nb_nodes, "Snapshot {} is corrupted", path_);
+    }
+    arcs = ArcSet(nb_nodes, std::move(arcs_list));
+}
+
+}
@@ -0,0 +1,291 @@
+#ifndef NUTMEG_SNAPSHOT_H
+#define NUTMEG_SNAPSHOT_H
+
+#include "Includes.h"
+#include "Variable.h"
+#include "MappedFile.h"
+#include "ArcMatrix.h"
+#include <cstring>
+#include <type_traits>
+
+namespace Nutmeg
+{
+
+// Call to a function of the model recorded in a snapshot
+enum class SnapshotOp : uint8_t
+{
+    AddBoolVar,
+    AddIntVar,
+    AddIndicatorVars,
+    AddMipVar,
+    AddMipIntVarAsBoolVarAlias,
+    GetNeg,
+    MarkAsInfeasible,
+    ConstrFix,
+    ConstrLinear,
+    ConstrLinearNeq,
+    ConstrElement,
+    ConstrElementVar,
+    ConstrAllDifferent,
+    ConstrLinearBool,
+    ConstrLinearIndicator,
+    ConstrSetPartition,
+    ConstrSubtractionLeq,
+    ConstrReifySubtractionLeq,
+    ConstrImply,
+    ConstrCumulative,
+    ConstrCumulativeOptional,
+    AddRoutingCuts,
+    ConstrCircuit,
+    ConstrPaths,
+    ConstrDisjunctive,
+    ConstrDisjunctiveOptional,
+    ConstrTable,
+    ConstrBinPacking,
+    ConstrLinearImply,
+    ConstrLinearReif
+};
+
+// Header of a snapshot file
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t method;
+    Int nb_bool_vars;
+    Int nb_int_vars;
+    uint64_t nb_ops;
+    uint64_t data_size;
+};
+
+// Log of the calls that build a model, which is replayed to rebuild the model without running the code
+// that created it. Only calls made by the user are recorded because calls made inside other calls are
+// repeated when the outer call is replayed.
+class Snapshot
+{
+    friend class SnapshotScope;
+
+    Vector<char> data_;
+    uint64_t nb_ops_;
+    Int depth_;
+    bool is_enabled_;
+
+  public:
+    // Constructors
+    Snapshot() noexcept : data_(), nb_ops_(0), depth_(0), is_enabled_(false) {}
+    Snapshot(const Snapshot&) = delete;
+    Snapshot(Snapshot&&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    Snapshot& operator=(Snapshot&&) = delete;
+    ~Snapshot() = default;
+
+    // Start recording
+    inline void enable() { is_enabled_ = true; }
+    inline bool is_enabled() const { return is_enabled_; }
+
+    // Get the log
+    inline const Vector<char>& data() const { return data_; }
+    inline uint64_t nb_ops() const { return nb_ops_; }
+    inline size_t memory() const { return data_.capacity(); }
+
+    // Write the log to a file
+    void save(const String& path, const uint32_t method, const Int nb_bool_vars, const Int nb_int_vars) const;
+
+  private:
+    template<class... Ts>
+    inline void record(const SnapshotOp op, const Ts&... values)
+    {
+        write(static_cast<uint8_t>(op));
+        (write(values), ...);
+        ++nb_ops_;
+    }
+
+    inline void write_bytes(const void* data, const size_t size)
+    {
+        const auto offset = data_.size();
+        data_.resize(offset + size);
+        std::memcpy(data_.data() + offset, data, size);
+    }
+    template<class T>
+    inline void write(const T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            write(static_cast<uint8_t>(value));
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T>);
+            write_bytes(&value, sizeof(T));
+        }
+    }
+    inline void write(const BoolVar var) { write(var.idx); }
+    inline void write(const IntVar var) { write(var.idx); }
+    inline void write(const String& str)
+    {
+        write<uint32_t>(str.size());
+        write_bytes(str.data(), str.size());
+    }
+    template<class T>
+    inline void write(const Vector<T>& vector)
+    {
+        write<uint32_t>(vector.size());
+        if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        {
+            write_bytes(vector.data(), vector.size() * sizeof(T));
+        }
+        else
+        {
+            for (const auto& value : vector)
+            {
+                write(value);
+            }
+        }
+    }
+    inline void write(const ArcSet& arcs)
+    {
+        write<uint64_t>(arcs.nb_nodes());
+        write<uint64_t>(arcs.nb_arcs());
+        for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+        {
+            write<uint64_t>(arcs.tail(a));
+            write<uint64_t>(arcs.head(a));
+        }
+    }
+    template<class T>
+    inline void write(const Matrix<T>& matrix)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        write<uint64_t>(matrix.rows());
+        write<uint64_t>(matrix.cols());
+        for (size_t i = 0; i < matrix.rows(); ++i)
+        {
+            write_bytes(matrix.cbegin(i), matrix.cols() * sizeof(T));
+        }
+    }
+    template<class T>
+    inline void write(const ArcMatrix<T>& matrix)
+    {
+        write(matrix.arcs());
+        write<uint32_t>(matrix.size());
+        for (const auto& value : matrix)
+        {
+            write(value);
+        }
+    }
+};
+
+// Guard placed at the start of a function of the model that records the call if it is made by the user
+class SnapshotScope
+{
+    Snapshot& snapshot_;
+
+  public:
+    // Constructors and destructors
+    template<class... Ts>
+    SnapshotScope(Snapshot& snapshot, const SnapshotOp op, const Ts&... values) : snapshot_(snapshot)
+    {
+        if (snapshot_.is_enabled_ && snapshot_.depth_ == 0)
+        {
+            snapshot_.record(op, values...);
+        }
+        ++snapshot_.depth_;
+    }
+    SnapshotScope(const SnapshotScope&) = delete;
+    SnapshotScope(SnapshotScope&&) = delete;
+    SnapshotScope& operator=(const SnapshotScope&) = delete;
+    SnapshotScope& operator=(SnapshotScope&&) = delete;
+    ~SnapshotScope() { --snapshot_.depth_; }
+};
+
+// Reader of the calls in a memory-mapped snapshot file
+class SnapshotReader
+{
+    const MappedFile file_;
+    const String path_;
+    Model* model_;
+    SnapshotHeader header_;
+    const char* p_;
+    const char* end_;
+
+  public:
+    // Constructors and destructors
+    SnapshotReader(const String& path, Model* model);
+
+    // Get the header
+    inline const SnapshotHeader& header() const { return header_; }
+
+    // Check if all calls are read
+    inline bool at_end() const { return p_ == end_; }
+
+    // Read values
+    template<class... Ts>
+    inline void operator()(Ts&... values) { (read(values), ...); }
+
+  private:
+    const char* read_bytes(const size_t size);
+
+    template<class T>
+    inline void read(T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            uint8_t raw;
+            read(raw);
+            value = static_cast<T>(raw);
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T>);
+            std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+        }
+    }
+    void read(BoolVar& var);
+    void read(IntVar& var);
+    void read(ArcSet& arcs);
+    inline void read(String& str)
+    {
+        uint32_t size;
+        read(size);
+        str.assign(read_bytes(size), size);
+    }
+    template<class T>
+    inline void read(Matrix<T>& matrix)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        uint64_t rows;
+        uint64_t cols;
+        read(rows);
+        read(cols);
+        release_assert(cols == 0 || rows <= static_cast<uint64_t>(end_ - p_) / (cols * sizeof(T)),
+                       "Snapshot {} is truncated", path_);
+        matrix.clear_and_resize(rows, cols);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            std::memcpy(matrix.begin(i), read_bytes(cols * sizeof(T)), cols * sizeof(T));
+        }
+    }
+    template<class T>
+    inline void read(Vector<T>& vector)
+    {
+        uint32_t size;
+        read(size);
+        vector.resize(size);
+        if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        {
+            const auto data = read_bytes(size * sizeof(T));
+            std::memcpy(vector.data(), data, size * sizeof(T));
+        }
+        else
+        {
+            for (auto& value : vector)
+            {
+                read(value);
+            }
+        }
+    }
+};
+
+}
+
+#endif
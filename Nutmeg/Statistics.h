@@ -0,0 +1,93 @@
+#ifndef NUTMEG_STATISTICS_H
+#define NUTMEG_STATISTICS_H
+
+#include "Includes.h"
+#include "geas/solver/solver.h"
+#include <ctime>
+
+namespace Nutmeg
+{
+
+// Get the CPU time elapsed since a starting time
+inline Float get_elapsed_time(const clock_t start_time)
+{
+    return static_cast<Float>(clock() - start_time) / CLOCKS_PER_SEC;
+}
+
+// Counters for one callback or one stage of a callback
+struct CallStatistics
+{
+    int64_t nb_calls{0};
+    Float time{0};
+    int64_t nb_cp_calls{0};
+    Float cp_time{0};
+    int64_t nb_sat{0};
+    int64_t nb_unsat{0};
+    int64_t nb_unknown{0};
+    int64_t nb_reductions{0};
+
+    // Record one call to the CP solver
+    inline void add_cp_call(const geas::solver::result result, const Float time)
+    {
+        ++nb_cp_calls;
+        cp_time += time;
+        nb_sat += result == geas::solver::SAT;
+        nb_unsat += result == geas::solver::UNSAT;
+        nb_unknown += result == geas::solver::UNKNOWN;
+    }
+};
+
+// Memory in bytes
+struct MemoryUsage
+{
+    size_t problem_data{0};
+    size_t names{0};
+    size_t nogood_pool{0};
+    size_t cp{0};
+    size_t mip{0};
+    size_t lp{0};
+
+    inline size_t total() const { return problem_data + names + nogood_pool + cp + mip + lp; }
+};
+
+struct Statistics
+{
+    // Histogram of nogood lengths in buckets 0, 1, 2, 3-4, 5-8, ..., 129-256, 257+
+    static constexpr Int nb_nogood_length_buckets = 11;
+
+    // Callbacks
+    CallStatistics check;
+    CallStatistics separate;
+    CallStatistics separate_stages[3];
+    CallStatistics propagate;
+    CallStatistics minimize_cut;
+
+    // Nogoods
+    int64_t nogood_length[nb_nogood_length_buckets]{};
+    int64_t nb_nogood_literals{0};
+    int64_t nb_minimized_literals{0};
+
+    // Cuts
+    int64_t nb_logicor_cuts{0};
+    int64_t nb_bounddisjunction_cuts{0};
+    int64_t nb_bound_changes{0};
+    int64_t nb_cutoffs{0};
+    int64_t nb_removable_nogoods{0};
+    int64_t nb_dropped_nogoods{0};
+
+    // Record the length of a nogood
+    inline void add_nogood_length(const size_t length)
+    {
+        Int bucket = 0;
+        while (bucket < nb_nogood_length_buckets - 1 && (length > (size_t(1) << bucket) >> 1))
+        {
+            ++bucket;
+        }
+        ++nogood_length[bucket];
+        nb_nogood_literals += length;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+//#define PRINT_DEBUG
+
+#include "Table-Statistics.h"
+#include "Model.h"
+
+#define TABLE_NAME              "nutmeg"
+#define TABLE_DESC              "Nutmeg statistics table"
+#define TABLE_POSITION          20000                  // the position of the statistics table
+#define TABLE_EARLIEST_STAGE    SCIP_STAGE_SOLVING     // output of the statistics table is only printed from this stage onwards
+
+using namespace Nutmeg;
+
+static
+String format_row(
+    const char* name,                 // Row name
+    const CallStatistics& stats,      // Statistics
+    const bool include_calls = true   // Whether to print callback calls and time
+)
+{
+    return fmt::format("  {:<17}: {:>10} {:>10.2f} {:>10} {:>10.2f} {:>10} {:>10} {:>10} {:>10}\n",
+                       name,
+                       include_calls ? fmt::format("{}", stats.nb_calls) : "-",
+                       stats.time,
+                       stats.nb_cp_calls,
+                       stats.cp_time,
+                       stats.nb_sat,
+                       stats.nb_unsat,
+                       stats.nb_unknown,
+                       stats.nb_reductions);
+}
+
+// Output method of statistics table to output file stream 'file'
+static
+SCIP_DECL_TABLEOUTPUT(tableOutputNutmeg)
+{
+    // Check.
+    debug_assert(scip);
+    debug_assert(table);
+
+    // Get statistics.
+    auto model = reinterpret_cast<Model*>(SCIPtableGetData(table));
+    debug_assert(model);
+    const auto& stats = model->statistics();
+
+    // Print callbacks.
+    String str = fmt::format("{:<19}: {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                             "Nutmeg Callbacks",
+                             "Calls",
+                             "Time",
+                             "CP Calls",
+                             "CP Time",
+                             "SAT",
+                             "UNSAT",
+                             "UNKNOWN",
+                             "Reductions");
+    str += format_row("check", stats.check);
+    str += format_row("separate", stats.separate);
+    str += format_row(" bool vars", stats.separate_stages[0], false);
+    str += format_row(" obj var", stats.separate_stages[1], false);
+    str += format_row(" all vars", stats.separate_stages[2], false);
+    str += format_row("propagate", stats.propagate);
+    str += format_row("minimize cut", stats.minimize_cut);
+
+    // Print cuts.
+    str += fmt::format("{:<19}: {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                       "Nutmeg Cuts",
+                       "Logicor",
+                       "Bounddisj",
+                       "BoundChg",
+                       "Cutoff",
+                       "Literals",
+                       "Minimized",
+                       "Removable");
+    str += fmt::format("  {:<17}: {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                       "nogoods",
+                       stats.nb_logicor_cuts,
+                       stats.nb_bounddisjunction_cuts,
+                       stats.nb_bound_changes,
+                       stats.nb_cutoffs,
+                       stats.nb_nogood_literals,
+                       stats.nb_minimized_literals,
+                       stats.nb_removable_nogoods);
+
+    // Print nogood lengths.
+    str += fmt::format("{:<19}:", "Nutmeg Nogood Length");
+    for (Int bucket = 0; bucket < Statistics::nb_nogood_length_buckets; ++bucket)
+    {
+        const auto lb = bucket <= 1 ? bucket : (1 << (bucket - 2)) + 1;
+        const auto ub = (1 << bucket) >> 1;
+        str += bucket == Statistics::nb_nogood_length_buckets - 1 ? fmt::format(" {:>7}+", lb) :
+               lb == ub ? fmt::format(" {:>8}", lb) :
+               fmt::format(" {:>8}", fmt::format("{}-{}", lb, ub));
+    }
+    str += fmt::format("\n  {:<17}:", "count");
+    for (Int bucket = 0; bucket < Statistics::nb_nogood_length_buckets; ++bucket)
+    {
+        str += fmt::format(" {:>8}", stats.nogood_length[bucket]);
+    }
+    str += "\n";
+
+    // Output.
+    SCIPinfoMessage(scip, file, "%s", str.c_str());
+
+    // Done.
+    return SCIP_OKAY;
+}
+
+// Create the statistics table and include it in SCIP
+SCIP_RETCODE Nutmeg::includeTableNutmeg(SCIP* scip, Model* model)
+{
+    // Include statistics table.
+    SCIP_CALL(SCIPincludeTable(scip,
+                               TABLE_NAME,
+                               TABLE_DESC,
+                               TRUE,
+                               nullptr,
+                               nullptr,
+                               nullptr,
+                               nullptr,
+                               nullptr,
+                               nullptr,
+                               tableOutputNutmeg,
+                               reinterpret_cast<SCIP_TABLEDATA*>(model),
+                               TABLE_POSITION,
+                               TABLE_EARLIEST_STAGE));
+
+    // Done.
+    return SCIP_OKAY;
+}
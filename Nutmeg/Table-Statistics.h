@@ -0,0 +1,15 @@
+#ifndef NUTMEG_TABLE_STATISTICS_H
+#define NUTMEG_TABLE_STATISTICS_H
+
+#include "Includes.h"
+
+namespace Nutmeg
+{
+
+class Model;
+
+SCIP_RETCODE includeTableNutmeg(SCIP* scip, Model* model);
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "Timeline.h"
+#include "Tracer.h"
+
+namespace Nutmeg
+{
+
+const char* get_bound_source_name(const BoundSource source)
+{
+    return source == BoundSource::LPCheck ? "LP check" :
+           source == BoundSource::CPHeuristic ? "CP heuristic" :
+           source == BoundSource::SCIPHeuristic ? "SCIP heuristic" :
+           source == BoundSource::Injected ? "Injected" :
+           source == BoundSource::Relaxation ? "Relaxation" :
+           source == BoundSource::CPSearch ? "CP search" :
+           "Unknown";
+}
+
+// Relative gap between two bounds in [0, 1] as defined for the primal integral by Berthold (2013)
+static
+Float get_gap(
+    const Float primal_bound,    // Primal bound
+    const Float dual_bound       // Dual bound or reference value
+)
+{
+    if (!std::isfinite(primal_bound) || !std::isfinite(dual_bound) || primal_bound * dual_bound < 0)
+    {
+        return 1;
+    }
+    const auto max_abs = std::max(std::abs(primal_bound), std::abs(dual_bound));
+    return max_abs == 0 ? 0 : std::min<Float>(std::abs(primal_bound - dual_bound) / max_abs, 1);
+}
+
+Timeline::Timeline() noexcept :
+    start_time_(std::chrono::steady_clock::now()),
+    end_time_(std::numeric_limits<Float>::quiet_NaN()),
+    primal_bound_(Infinity),
+    dual_bound_(-Infinity),
+    events_()
+{
+}
+
+void Timeline::start()
+{
+    start_time_ = std::chrono::steady_clock::now();
+    end_time_ = std::numeric_limits<Float>::quiet_NaN();
+    primal_bound_ = Infinity;
+    dual_bound_ = -Infinity;
+    events_.clear();
+}
+
+void Timeline::stop()
+{
+    end_time_ = get_elapsed_time();
+}
+
+Float Timeline::get_elapsed_time() const
+{
+    return std::chrono::duration<Float>(std::chrono::steady_clock::now() - start_time_).count();
+}
+
+void Timeline::add_primal_bound(const Float primal_bound, const BoundSource source)
+{
+    if (primal_bound < primal_bound_)
+    {
+        primal_bound_ = primal_bound;
+        events_.push_back({get_elapsed_time(), primal_bound_, dual_bound_, source});
+        Tracer::record(TracerEvent::Incumbent, static_cast<uint8_t>(source), 0, primal_bound);
+    }
+}
+
+void Timeline::add_dual_bound(const Float dual_bound, const BoundSource source)
+{
+    const auto new_dual_bound = std::min(dual_bound, primal_bound_);
+    if (new_dual_bound > dual_bound_)
+    {
+        dual_bound_ = new_dual_bound;
+        events_.push_back({get_elapsed_time(), primal_bound_, dual_bound_, source});
+    }
+}
+
+Float Timeline::time_to_first_feasible() const
+{
+    return time_to_target(Infinity);
+}
+
+Float Timeline::time_to_target(const Float target) const
+{
+    for (const auto& event : events_)
+        if (event.primal_bound < Infinity && event.primal_bound <= target)
+        {
+            return event.time;
+        }
+    return Infinity;
+}
+
+Float Timeline::primal_integral(const Float reference) const
+{
+    // Get the end of the solve and the reference value.
+    const auto end_time = std::isnan(end_time_) ? get_elapsed_time() : end_time_;
+    const auto ref = std::isnan(reference) ? primal_bound_ : reference;
+
+    // Integrate the piecewise-constant gap.
+    Float integral = 0;
+    Float time = 0;
+    Float gap = 1;
+    for (const auto& event : events_)
+    {
+        integral += gap * (std::min(event.time, end_time) - time);
+        time = std::min(event.time, end_time);
+        gap = get_gap(event.primal_bound, ref);
+    }
+    integral += gap * (end_time - time);
+    return integral;
+}
+
+Float Timeline::primal_dual_integral() const
+{
+    // Get the end of the solve.
+    const auto end_time = std::isnan(end_time_) ? get_elapsed_time() : end_time_;
+
+    // Integrate the piecewise-constant gap.
+    Float integral = 0;
+    Float time = 0;
+    Float gap = 1;
+    for (const auto& event : events_)
+    {
+        integral += gap * (std::min(event.time, end_time) - time);
+        time = std::min(event.time, end_time);
+        gap = get_gap(event.primal_bound, event.dual_bound);
+    }
+    integral += gap * (end_time - time);
+    return integral;
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef NUTMEG_TIMELINE_H
+#define NUTMEG_TIMELINE_H
+
+#include "Includes.h"
+#include <chrono>
+
+namespace Nutmeg
+{
+
+// Origin of an improvement to the primal or dual bound
+enum class BoundSource : uint8_t
+{
+    LPCheck,          // Solution of the MIP accepted by the CP checker
+    CPHeuristic,      // Solution found by the CP checker and injected into the MIP
+    SCIPHeuristic,    // Solution found by a SCIP primal heuristic
+    Injected,         // Solution given by the user or a checkpoint
+    Relaxation,       // Dual bound of the MIP relaxation
+    CPSearch          // Solution or proof found by the CP solver alone
+};
+
+const char* get_bound_source_name(const BoundSource source);
+
+// Primal and dual bounds after an improvement
+struct BoundEvent
+{
+    Float time;
+    Float primal_bound;
+    Float dual_bound;
+    BoundSource source;
+};
+
+// Wall-clock history of the primal and dual bounds during a solve
+class Timeline
+{
+    std::chrono::steady_clock::time_point start_time_;
+    Float end_time_;
+    Float primal_bound_;
+    Float dual_bound_;
+    Vector<BoundEvent> events_;
+
+  public:
+    // Constructors
+    Timeline() noexcept;
+    Timeline(const Timeline&) = delete;
+    Timeline(Timeline&&) = delete;
+    Timeline& operator=(const Timeline&) = delete;
+    Timeline& operator=(Timeline&&) = delete;
+    ~Timeline() = default;
+
+    // Start and stop the clock
+    void start();
+    void stop();
+    Float get_elapsed_time() const;
+
+    // Record an improvement, ignoring values that do not improve the bound
+    void add_primal_bound(const Float primal_bound, const BoundSource source);
+    void add_dual_bound(const Float dual_bound, const BoundSource source);
+
+    // Get the history
+    inline const Vector<BoundEvent>& events() const { return events_; }
+    inline Float end_time() const { return end_time_; }
+
+    // Get the time until the first solution or until a solution at least as good as the target,
+    // or infinity if none is found
+    Float time_to_first_feasible() const;
+    Float time_to_target(const Float target) const;
+
+    // Integral of the primal gap to the reference value, which defaults to the final primal bound,
+    // and integral of the gap between the primal and dual bounds over the solve
+    Float primal_integral(const Float reference = std::numeric_limits<Float>::quiet_NaN()) const;
+    Float primal_dual_integral() const;
+};
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "Trace.h"
+
+// Trace file layout (native endianness):
+//   magic, version
+//   number of Boolean variables, number of integer variables
+//   records
+// where each record is its call kind, result, time limit, conflict limit, run time, assumptions and
+// nogood, and the assumptions and nogood are written as nogoods.
+#define TRACE_MAGIC                             "NUTMEGTR"
+#define TRACE_MAGIC_SIZE                                 8
+#define TRACE_VERSION                                    1
+
+namespace Nutmeg
+{
+
+void Trace::open(const String& path, const Int nb_bool_vars, const Int nb_int_vars)
+{
+    // Open file.
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    release_assert(file_, "Cannot open file {} for writing trace", path);
+    is_open_ = true;
+
+    // Write header.
+    file_.write(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+    write_value<uint32_t>(file_, TRACE_VERSION);
+    write_value<Int>(file_, nb_bool_vars);
+    write_value<Int>(file_, nb_int_vars);
+}
+
+void Trace::write(const TraceRecord& record)
+{
+    write_value<uint8_t>(file_, static_cast<uint8_t>(record.kind));
+    write_value<uint8_t>(file_, static_cast<uint8_t>(record.result));
+    write_value<Float>(file_, record.time_limit);
+    write_value<Int>(file_, record.conflict_limit);
+    write_value<Float>(file_, record.time);
+    write_nogood(file_, record.assumptions);
+    write_nogood(file_, record.nogood);
+}
+
+Vector<TraceRecord> Trace::read(const String& path, const Int nb_bool_vars, const Int nb_int_vars)
+{
+    // Open file.
+    std::ifstream file(path, std::ios::binary);
+    release_assert(file, "Cannot open trace file {}", path);
+
+    // Check header.
+    char magic[TRACE_MAGIC_SIZE];
+    file.read(magic, TRACE_MAGIC_SIZE);
+    release_assert(file && std::equal(magic, magic + TRACE_MAGIC_SIZE, TRACE_MAGIC),
+                   "File {} is not a trace", path);
+    const auto version = read_value<uint32_t>(file);
+    release_assert(version == TRACE_VERSION, "Trace {} has unsupported version {}", path, version);
+    release_assert(read_value<Int>(file) == nb_bool_vars && read_value<Int>(file) == nb_int_vars,
+                   "Trace {} was recorded on a different model", path);
+
+    // Read records.
+    Vector<TraceRecord> records;
+    while (file.peek() != std::ifstream::traits_type::eof())
+    {
+        auto& record = records.emplace_back();
+        const auto kind = read_value<uint8_t>(file);
+        const auto result = read_value<uint8_t>(file);
+        release_assert(kind <= static_cast<uint8_t>(TraceCallKind::Propagate) &&
+                       result <= static_cast<uint8_t>(TraceResult::AssumptionsFailed),
+                       "Trace {} is corrupted", path);
+        record.kind = static_cast<TraceCallKind>(kind);
+        record.result = static_cast<TraceResult>(result);
+        record.time_limit = read_value<Float>(file);
+        record.conflict_limit = read_value<Int>(file);
+        record.time = read_value<Float>(file);
+        record.assumptions = read_nogood(file, nb_bool_vars, nb_int_vars);
+        record.nogood = read_nogood(file, nb_bool_vars, nb_int_vars);
+    }
+    return records;
+}
+
+}
@@ -0,0 +1,123 @@
+#ifndef NUTMEG_TRACE_H
+#define NUTMEG_TRACE_H
+
+#include "Includes.h"
+#include "Nogood.h"
+#include "geas/solver/solver.h"
+#include <fstream>
+
+namespace Nutmeg
+{
+
+// Callback or stage of a callback that calls the CP solver
+enum class TraceCallKind : uint8_t
+{
+    Check,
+    SeparateBool,
+    SeparateObj,
+    SeparateInt,
+    Propagate
+};
+
+// Outcome of a call to the CP solver
+enum class TraceResult : uint8_t
+{
+    Sat,
+    Unsat,
+    Unknown,
+    AssumptionsFailed
+};
+
+// Get the outcome of a call to the CP solver
+inline TraceResult get_trace_result(const geas::solver::result cp_result)
+{
+    return cp_result == geas::solver::SAT ? TraceResult::Sat :
+           cp_result == geas::solver::UNSAT ? TraceResult::Unsat :
+           TraceResult::Unknown;
+}
+
+// One call to the CP solver
+struct TraceRecord
+{
+    TraceCallKind kind;
+    TraceResult result;
+    Float time_limit;
+    Int conflict_limit;
+    Float time;
+    Nogood assumptions;
+    Nogood nogood;
+};
+
+// Binary log of the calls made by the constraint handler to the CP solver
+class Trace
+{
+    std::ofstream file_;
+    bool is_open_;
+    TraceRecord record_;
+
+  public:
+    // Constructors
+    Trace() noexcept : file_(), is_open_(false), record_() {}
+    Trace(const Trace&) = delete;
+    Trace(Trace&&) = delete;
+    Trace& operator=(const Trace&) = delete;
+    Trace& operator=(Trace&&) = delete;
+    ~Trace() = default;
+
+    // Open a file for writing and write the header
+    void open(const String& path, const Int nb_bool_vars, const Int nb_int_vars);
+    inline bool is_open() const { return is_open_; }
+
+    // Record a call
+    inline void begin(const TraceCallKind kind)
+    {
+        if (is_open_)
+        {
+            record_.kind = kind;
+            record_.result = TraceResult::AssumptionsFailed;
+            record_.time_limit = 0;
+            record_.conflict_limit = 0;
+            record_.time = 0;
+            record_.assumptions.clear();
+            record_.nogood.clear();
+        }
+    }
+    inline void add_assumption(const NogoodLiteral& literal)
+    {
+        if (is_open_)
+        {
+            record_.assumptions.push_back(literal);
+        }
+    }
+    inline void set_result(const TraceResult result, const Float time_limit, const Int conflict_limit, const Float time)
+    {
+        if (is_open_)
+        {
+            record_.result = result;
+            record_.time_limit = time_limit;
+            record_.conflict_limit = conflict_limit;
+            record_.time = time;
+        }
+    }
+    inline void end(const Nogood* nogood = nullptr)
+    {
+        if (is_open_)
+        {
+            if (nogood)
+            {
+                record_.nogood = *nogood;
+            }
+            write(record_);
+        }
+    }
+
+    // Read all records of a file
+    static Vector<TraceRecord> read(const String& path, const Int nb_bool_vars, const Int nb_int_vars);
+
+  private:
+    void write(const TraceRecord& record);
+};
+
+}
+
+#endif
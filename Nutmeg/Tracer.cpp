@@ -0,0 +1,226 @@
+#include "Tracer.h"
+#include "Nogood.h"
+#include "Timeline.h"
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Dump file layout (native endianness):
+//   magic, version, number of records
+//   records of each thread from oldest to newest
+#define TRACER_MAGIC                            "NUTMEGEV"
+#define TRACER_MAGIC_SIZE                                8
+#define TRACER_VERSION                                   1
+
+#define MAX_TRACER_THREADS                             256
+#define MAX_TRACER_PATH_SIZE                          4096
+
+namespace Nutmeg
+{
+
+struct TracerBuffer
+{
+    TracerRecord* records;
+    uint64_t mask;
+    uint64_t head;
+    uint16_t thread;
+};
+
+std::atomic<bool> Tracer::enabled_{false};
+
+// Buffers are never freed so that they can be dumped from a signal handler at any time.
+static TracerBuffer* buffers[MAX_TRACER_THREADS];
+static std::atomic<Int> nb_buffers{0};
+static std::atomic<uint64_t> capacity{0};
+static thread_local TracerBuffer* thread_buffer = nullptr;
+static std::chrono::steady_clock::time_point start_time;
+static char abort_dump_path[MAX_TRACER_PATH_SIZE];
+
+void Tracer::enable(const size_t requested_capacity)
+{
+    // Round the capacity up to a power of two.
+    uint64_t new_capacity = 1;
+    while (new_capacity < requested_capacity)
+    {
+        new_capacity <<= 1;
+    }
+
+    // Enable.
+    if (!is_enabled())
+    {
+        start_time = std::chrono::steady_clock::now();
+    }
+    capacity = new_capacity;
+    enabled_ = true;
+}
+
+void Tracer::disable()
+{
+    enabled_ = false;
+}
+
+void Tracer::write(const TracerEvent event, const uint8_t kind, const Int idx, const Float value, const int64_t count)
+{
+    // Create the buffer of this thread.
+    if (!thread_buffer)
+    {
+        const auto thread = nb_buffers.fetch_add(1);
+        if (thread >= MAX_TRACER_THREADS)
+        {
+            return;
+        }
+        const auto buffer_capacity = capacity.load();
+        thread_buffer = new TracerBuffer{new TracerRecord[buffer_capacity], buffer_capacity - 1, 0,
+                                         static_cast<uint16_t>(thread)};
+        buffers[thread] = thread_buffer;
+    }
+
+    // Write record.
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                          start_time).count();
+    thread_buffer->records[thread_buffer->head & thread_buffer->mask] =
+        TracerRecord{time, event, kind, thread_buffer->thread, idx, value, count};
+    ++thread_buffer->head;
+}
+
+// Write the buffers to a file descriptor using only async-signal-safe functions
+static
+bool dump_to_file_descriptor(
+    const int fd    // File descriptor
+)
+{
+    // Count records.
+    const auto nb_threads = std::min<Int>(nb_buffers.load(), MAX_TRACER_THREADS);
+    uint32_t nb_records = 0;
+    for (Int thread = 0; thread < nb_threads; ++thread)
+        if (const auto buffer = buffers[thread]; buffer)
+        {
+            nb_records += std::min(buffer->head, buffer->mask + 1);
+        }
+
+    // Write header.
+    const uint32_t version = TRACER_VERSION;
+    bool success = ::write(fd, TRACER_MAGIC, TRACER_MAGIC_SIZE) == TRACER_MAGIC_SIZE &&
+                   ::write(fd, &version, sizeof(version)) == sizeof(version) &&
+                   ::write(fd, &nb_records, sizeof(nb_records)) == sizeof(nb_records);
+
+    // Write records from oldest to newest.
+    for (Int thread = 0; thread < nb_threads; ++thread)
+        if (const auto buffer = buffers[thread]; buffer)
+        {
+            const auto size = buffer->mask + 1;
+            const auto head = buffer->head;
+            const auto begin = head > size ? head & buffer->mask : 0;
+            const auto nb_thread_records = std::min(head, size);
+            const auto nb_first = std::min(nb_thread_records, size - begin);
+            const auto first_size = static_cast<ssize_t>(nb_first * sizeof(TracerRecord));
+            const auto second_size = static_cast<ssize_t>((nb_thread_records - nb_first) * sizeof(TracerRecord));
+            success = success && ::write(fd, buffer->records + begin, first_size) == first_size;
+            success = success && (second_size == 0 || ::write(fd, buffer->records, second_size) == second_size);
+        }
+    return success;
+}
+
+bool Tracer::dump(const String& path)
+{
+    const auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        println("Failed to open file {} for dumping tracer", path);
+        return false;
+    }
+    const auto success = dump_to_file_descriptor(fd);
+    ::close(fd);
+    return success;
+}
+
+static
+void handle_abort(
+    int    // Signal
+)
+{
+    // Dump.
+    const auto fd = ::open(abort_dump_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        dump_to_file_descriptor(fd);
+        ::close(fd);
+    }
+
+    // Continue aborting.
+    std::signal(SIGABRT, SIG_DFL);
+    std::raise(SIGABRT);
+}
+
+void Tracer::dump_on_abort(const String& path)
+{
+    release_assert(path.size() < MAX_TRACER_PATH_SIZE, "Path {} is too long", path);
+    std::strcpy(abort_dump_path, path.c_str());
+    std::signal(SIGABRT, handle_abort);
+}
+
+void Tracer::enable_from_environment()
+{
+    if (const auto path = std::getenv("NUTMEG_TRACER"); path && !is_enabled())
+    {
+        enable();
+        dump_on_abort(path);
+    }
+}
+
+Vector<TracerRecord> Tracer::read(const String& path)
+{
+    // Open file.
+    std::ifstream file(path, std::ios::binary);
+    release_assert(file, "Cannot open tracer dump {}", path);
+
+    // Check header.
+    char magic[TRACER_MAGIC_SIZE];
+    file.read(magic, TRACER_MAGIC_SIZE);
+    release_assert(file && std::equal(magic, magic + TRACER_MAGIC_SIZE, TRACER_MAGIC),
+                   "File {} is not a tracer dump", path);
+    const auto version = read_value<uint32_t>(file);
+    release_assert(version == TRACER_VERSION, "Tracer dump {} has unsupported version {}", path, version);
+
+    // Read records and order them by time.
+    Vector<TracerRecord> records(read_value<uint32_t>(file));
+    file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TracerRecord));
+    release_assert(file, "Tracer dump {} is truncated", path);
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TracerRecord& a, const TracerRecord& b) { return a.time < b.time; });
+    return records;
+}
+
+String Tracer::format(const TracerRecord& record)
+{
+    constexpr const char* call_kind_names[] = {"check", "separate bool", "separate obj", "separate all", "propagate"};
+    constexpr const char* result_names[] = {"SAT", "UNSAT", "UNKNOWN", "assumptions failed"};
+    const auto time = fmt::format("{:>14.6f} [{}]", record.time * 1e-9, record.thread);
+    switch (record.event)
+    {
+        case TracerEvent::CPCall:
+            return fmt::format("{} CP call {}: {} in {:.6f} s",
+                               time,
+                               record.kind < 5 ? call_kind_names[record.kind] : "?",
+                               record.idx >= 0 && record.idx < 4 ? result_names[record.idx] : "?",
+                               record.value);
+        case TracerEvent::Nogood:
+            return fmt::format("{} Nogood: {} with {} literals",
+                               time, record.kind ? "bounddisjunction" : "logicor", record.count);
+        case TracerEvent::BoundChange:
+            return fmt::format("{} Bound change: {} var {} {} {}",
+                               time, record.kind ? "int" : "bool", record.idx, record.value ? "<=" : ">=", record.count);
+        case TracerEvent::Incumbent:
+            return fmt::format("{} Incumbent: {} from {}",
+                               time, record.value, get_bound_source_name(static_cast<BoundSource>(record.kind)));
+        case TracerEvent::Cutoff:
+            return fmt::format("{} Cutoff: CP dual bound {}", time, record.value);
+    }
+    return fmt::format("{} Unknown event {}", time, static_cast<Int>(record.event));
+}
+
+}
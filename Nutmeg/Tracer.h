@@ -0,0 +1,76 @@
+#ifndef NUTMEG_TRACER_H
+#define NUTMEG_TRACER_H
+
+#include "Includes.h"
+#include <atomic>
+
+namespace Nutmeg
+{
+
+// Type of a tracer event
+enum class TracerEvent : uint8_t
+{
+    CPCall,         // kind = TraceCallKind, idx = TraceResult, value = run time
+    Nogood,         // kind = 0 for logicor and 1 for bounddisjunction, count = number of literals
+    BoundChange,    // kind = 0 for Boolean and 1 for integer variables, idx = variable, count = new bound
+                    // value = 0 for lower bound and 1 for upper bound
+    Incumbent,      // kind = BoundSource, value = objective value
+    Cutoff          // value = CP dual bound
+};
+
+// Fixed-size record of an event
+struct TracerRecord
+{
+    int64_t time;         // Nanoseconds since the tracer was enabled
+    TracerEvent event;
+    uint8_t kind;
+    uint16_t thread;
+    Int idx;
+    Float value;
+    int64_t count;
+};
+static_assert(sizeof(TracerRecord) == 32);
+
+// Runtime-enabled recorder of events into per-thread ring buffers. Recording is a check of a flag when
+// disabled, and a write of one record without locking or formatting when enabled. The buffers are
+// dumped in binary on demand or when the process aborts.
+class Tracer
+{
+    static std::atomic<bool> enabled_;
+
+  public:
+    // Enable recording with ring buffers holding the given number of most recent records per thread
+    static void enable(const size_t capacity = 1 << 16);
+    static void disable();
+    static inline bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Enable recording and dump to a file on SIGABRT if the environment variable NUTMEG_TRACER names
+    // a file
+    static void enable_from_environment();
+    static void dump_on_abort(const String& path);
+
+    // Record an event
+    static inline void record(const TracerEvent event,
+                              const uint8_t kind = 0,
+                              const Int idx = 0,
+                              const Float value = 0,
+                              const int64_t count = 0)
+    {
+        if (is_enabled())
+        {
+            write(event, kind, idx, value, count);
+        }
+    }
+
+    // Write the records of all threads in binary, and read them back
+    static bool dump(const String& path);
+    static Vector<TracerRecord> read(const String& path);
+    static String format(const TracerRecord& record);
+
+  private:
+    static void write(const TracerEvent event, const uint8_t kind, const Int idx, const Float value, const int64_t count);
+};
+
+}
+
+#endif
@@ -12,6 +12,8 @@ class BoolVar
 {
     friend class Model;
     friend struct ProblemData;
+    friend class Snapshot;
+    friend class SnapshotReader;
 
     Model* model{nullptr};
     Int idx{-1};
@@ -42,6 +44,8 @@ class IntVar
 {
     friend class Model;
     friend struct ProblemData;
+    friend class Snapshot;
+    friend class SnapshotReader;
 
     Model* model{nullptr};
     Int idx{-1};
@@ -0,0 +1,689 @@
+// Benchmark driver for the example models
+//
+// Runs example binaries over instance globs, methods and time limits with parallel independent runs,
+// collects the results each run writes to NUTMEG_RESULTS_FILE and writes them as CSV or JSON. Two
+// result files can be compared for regressions.
+
+#include "Nutmeg/Includes.h"
+#include "Nutmeg/Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <glob.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Nutmeg;
+
+// Flat record of key-value pairs, keeping the order of the keys
+struct Record
+{
+    Vector<Pair<String, String>> fields;
+
+    const String& get(const String& key) const
+    {
+        static const String empty;
+        for (const auto& [k, v] : fields)
+            if (k == key)
+                return v;
+        return empty;
+    }
+
+    void set(const String& key, const String& value)
+    {
+        for (auto& [k, v] : fields)
+            if (k == key)
+            {
+                v = value;
+                return;
+            }
+        fields.emplace_back(key, value);
+    }
+};
+
+struct Run
+{
+    String model;
+    String instance;
+    String method;
+};
+
+struct Settings
+{
+    Vector<Pair<String, Vector<String>>> models;
+    Vector<String> methods{"bc"};
+    Float time_limit{60};
+    Int nb_jobs{1};
+    String bin_dir{"."};
+    String log_dir;
+    String output{"results.csv"};
+};
+
+static
+void print_usage()
+{
+    println("Usage:");
+    println("  benchmark run --model NAME --instances GLOB [--instances GLOB ...] [--model NAME ...] [options]");
+    println("    --method M[,M...]       Methods bc, lbbd, cp, mip and dichotomic (default bc)");
+    println("    --time-limit SECONDS    Time limit passed to each run (default 60)");
+    println("    --jobs N                Number of runs in parallel (default 1)");
+    println("    --bin-dir DIR           Directory containing the example binaries (default .)");
+    println("    --log-dir DIR           Directory to store the output of each run (default discarded)");
+    println("    --output FILE           Results file, JSON if it ends in .json and CSV otherwise (default results.csv)");
+    println("  benchmark compare BASE NEW [options]");
+    println("    --time-tolerance F      Report runs slower by more than this factor (default 1.2)");
+    println("    --min-time SECONDS      Ignore slowdowns smaller than this (default 1)");
+    println("  benchmark events FILE");
+    println("    Print the events in a dump written by the tracer (see NUTMEG_TRACER)");
+}
+
+static
+Vector<String> split(const String& str, const char delim)
+{
+    Vector<String> tokens;
+    std::istringstream stream(str);
+    for (String token; std::getline(stream, token, delim);)
+        if (!token.empty())
+        {
+            tokens.push_back(token);
+        }
+    return tokens;
+}
+
+static
+Vector<String> expand_glob(const String& pattern)
+{
+    Vector<String> paths;
+    glob_t result;
+    if (glob(pattern.c_str(), 0, nullptr, &result) == 0)
+    {
+        for (size_t idx = 0; idx < result.gl_pathc; ++idx)
+        {
+            paths.emplace_back(result.gl_pathv[idx]);
+        }
+    }
+    globfree(&result);
+    release_assert(!paths.empty(), "No instances match {}", pattern);
+    return paths;
+}
+
+// Parse flat JSON objects of strings, numbers and nulls, either alone or in an array
+static
+Vector<Record> parse_json(const String& text)
+{
+    Vector<Record> records;
+    size_t pos = 0;
+    const auto skip_space = [&]() { while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos; };
+    const auto parse_string = [&]()
+    {
+        release_assert(pos < text.size() && text[pos] == '"', "Expected string in JSON at {}", pos);
+        String str;
+        for (++pos; pos < text.size() && text[pos] != '"'; ++pos)
+        {
+            if (text[pos] == '\\' && pos + 1 < text.size())
+                ++pos;
+            str += text[pos];
+        }
+        release_assert(pos < text.size(), "Unterminated string in JSON");
+        ++pos;
+        return str;
+    };
+    while (true)
+    {
+        // Find next object.
+        pos = text.find('{', pos);
+        if (pos == String::npos)
+            break;
+        ++pos;
+
+        // Read fields.
+        auto& record = records.emplace_back();
+        skip_space();
+        while (pos < text.size() && text[pos] != '}')
+        {
+            const auto key = parse_string();
+            skip_space();
+            release_assert(pos < text.size() && text[pos] == ':', "Expected : in JSON at {}", pos);
+            ++pos;
+            skip_space();
+            String value;
+            if (pos < text.size() && text[pos] == '"')
+            {
+                value = parse_string();
+            }
+            else
+            {
+                const auto end = text.find_first_of(",}", pos);
+                release_assert(end != String::npos, "Unterminated object in JSON");
+                value = text.substr(pos, end - pos);
+                while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back())))
+                    value.pop_back();
+                if (value == "null")
+                    value.clear();
+                pos = end;
+            }
+            record.set(key, value);
+            skip_space();
+            if (pos < text.size() && text[pos] == ',')
+            {
+                ++pos;
+                skip_space();
+            }
+        }
+    }
+    return records;
+}
+
+// Quote a CSV field if it contains a comma, a quote or a line break
+static
+String quote_csv_field(const String& value)
+{
+    if (value.find_first_of(",\"\r\n") == String::npos)
+    {
+        return value;
+    }
+    String quoted = "\"";
+    for (const auto c : value)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// Read the fields of one CSV row, which continues over line breaks inside quoted fields
+static
+bool read_csv_row(std::istream& stream, Vector<String>& fields)
+{
+    fields.clear();
+    String line;
+    if (!std::getline(stream, line))
+    {
+        return false;
+    }
+    String field;
+    bool in_quotes = false;
+    for (size_t idx = 0;; ++idx)
+    {
+        if (idx == line.size())
+        {
+            if (in_quotes && std::getline(stream, line))
+            {
+                field += '\n';
+                idx = static_cast<size_t>(-1);
+                continue;
+            }
+            release_assert(!in_quotes, "Quoted field is not closed in CSV results");
+            break;
+        }
+        const auto c = line[idx];
+        if (in_quotes)
+        {
+            if (c == '"' && idx + 1 < line.size() && line[idx + 1] == '"')
+            {
+                field += '"';
+                ++idx;
+            }
+            else if (c == '"')
+            {
+                in_quotes = false;
+            }
+            else
+            {
+                field += c;
+            }
+        }
+        else if (c == '"')
+        {
+            in_quotes = true;
+        }
+        else if (c == ',')
+        {
+            fields.push_back(std::move(field));
+            field.clear();
+        }
+        else if (c != '\r')
+        {
+            field += c;
+        }
+    }
+    fields.push_back(std::move(field));
+    return true;
+}
+
+static
+Vector<Record> parse_csv(const String& text)
+{
+    Vector<Record> records;
+    std::istringstream stream(text);
+    Vector<String> header;
+    read_csv_row(stream, header);
+    for (Vector<String> fields; read_csv_row(stream, fields);)
+        if (fields.size() > 1 || !fields[0].empty())
+        {
+            auto& record = records.emplace_back();
+            for (size_t idx = 0; idx < header.size(); ++idx)
+            {
+                record.set(header[idx], idx < fields.size() ? fields[idx] : String());
+            }
+        }
+    return records;
+}
+
+static
+Vector<Record> read_results(const String& path)
+{
+    std::ifstream file(path);
+    release_assert(file, "Cannot open results file {}", path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const auto text = buffer.str();
+    const auto is_json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    return is_json ? parse_json(text) : parse_csv(text);
+}
+
+static
+void write_results(const String& path, const Vector<Record>& records)
+{
+    // Get all columns.
+    Vector<String> columns;
+    for (const auto& record : records)
+        for (const auto& [key, value] : record.fields)
+            if (std::find(columns.begin(), columns.end(), key) == columns.end())
+            {
+                columns.push_back(key);
+            }
+
+    // Write.
+    std::ofstream file(path);
+    release_assert(file, "Cannot open file {} for writing results", path);
+    const auto is_json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (is_json)
+    {
+        file << "[\n";
+        for (size_t r = 0; r < records.size(); ++r)
+        {
+            file << "  {";
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                const auto& value = records[r].get(columns[c]);
+                const auto is_number = !value.empty() &&
+                                       value.find_first_not_of("0123456789+-.eE") == String::npos;
+                file << (c ? ", " : "") << '"' << columns[c] << "\": ";
+                file << (value.empty() ? "null" : is_number ? value : '"' + value + '"');
+            }
+            file << (r + 1 < records.size() ? "},\n" : "}\n");
+        }
+        file << "]\n";
+    }
+    else
+    {
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            file << (c ? "," : "") << quote_csv_field(columns[c]);
+        }
+        file << '\n';
+        for (const auto& record : records)
+        {
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                file << (c ? "," : "") << quote_csv_field(record.get(columns[c]));
+            }
+            file << '\n';
+        }
+    }
+    release_assert(file, "Failed to write results to file {}", path);
+}
+
+static
+String get_base_name(const String& path)
+{
+    const auto pos = path.find_last_of('/');
+    return pos == String::npos ? path : path.substr(pos + 1);
+}
+
+// Start a run in a child process
+static
+pid_t start_run(const Settings& settings, const Run& run, const String& results_path)
+{
+    const auto pid = fork();
+    release_assert(pid >= 0, "Failed to fork");
+    if (pid == 0)
+    {
+        // Redirect output.
+        const auto log_path = settings.log_dir.empty() ?
+                              String("/dev/null") :
+                              fmt::format("{}/{}-{}-{}.log", settings.log_dir, run.model,
+                                          get_base_name(run.instance), run.method);
+        const auto fd = open(log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+
+        // Start model.
+        setenv("NUTMEG_RESULTS_FILE", results_path.c_str(), 1);
+        const auto bin_path = settings.bin_dir + "/" + run.model;
+        const auto time_limit = fmt::format("{}", settings.time_limit);
+        execl(bin_path.c_str(),
+              bin_path.c_str(),
+              run.instance.c_str(),
+              time_limit.c_str(),
+              run.method.c_str(),
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    return pid;
+}
+
+static
+Record finish_run(const Run& run, const String& results_path, const int wait_status, const bool killed, const Float wall_time)
+{
+    // Read results written by the model.
+    Record record;
+    record.set("model", run.model);
+    record.set("instance", get_base_name(run.instance));
+    record.set("method", run.method);
+    std::ifstream file(results_path);
+    if (file && !killed && WIFEXITED(wait_status) && WEXITSTATUS(wait_status) == 0)
+    {
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const auto records = parse_json(buffer.str());
+        if (!records.empty())
+        {
+            for (const auto& [key, value] : records[0].fields)
+                if (key != "method")
+                {
+                    record.set(key, value);
+                }
+        }
+        else
+        {
+            record.set("status", "Error");
+        }
+    }
+    else
+    {
+        record.set("status", killed ? "Killed" : "Error");
+    }
+    record.set("wall_time", fmt::format("{:.3f}", wall_time));
+    std::remove(results_path.c_str());
+    return record;
+}
+
+static
+int run_benchmark(const Settings& settings)
+{
+    // Create runs.
+    Vector<Run> runs;
+    for (const auto& [model, patterns] : settings.models)
+        for (const auto& pattern : patterns)
+            for (const auto& instance : expand_glob(pattern))
+                for (const auto& method : settings.methods)
+                {
+                    runs.push_back({model, instance, method});
+                }
+    release_assert(!runs.empty(), "No runs to perform");
+    println("Performing {} runs with {} jobs", runs.size(), settings.nb_jobs);
+
+    // Allow time for model building and output beyond the time limit before killing a run.
+    const auto kill_time = std::isfinite(settings.time_limit) ?
+                           2 * settings.time_limit + 60 :
+                           std::numeric_limits<Float>::infinity();
+
+    // Perform runs.
+    struct Active
+    {
+        size_t run_idx;
+        String results_path;
+        std::chrono::steady_clock::time_point start_time;
+        bool killed;
+    };
+    HashTable<pid_t, Active> active;
+    Vector<Record> records(runs.size());
+    size_t next_run = 0;
+    size_t nb_done = 0;
+    while (nb_done < runs.size())
+    {
+        // Start runs.
+        while (next_run < runs.size() && static_cast<Int>(active.size()) < settings.nb_jobs)
+        {
+            char results_path[] = "/tmp/nutmeg-results-XXXXXX";
+            const auto fd = mkstemp(results_path);
+            release_assert(fd >= 0, "Failed to create temporary file");
+            close(fd);
+            const auto pid = start_run(settings, runs[next_run], results_path);
+            active[pid] = {next_run, results_path, std::chrono::steady_clock::now(), false};
+            ++next_run;
+        }
+
+        // Collect finished runs.
+        int wait_status;
+        const auto pid = waitpid(-1, &wait_status, WNOHANG);
+        if (pid > 0)
+        {
+            auto it = active.find(pid);
+            release_assert(it != active.end(), "Unknown child process {}", pid);
+            const auto& [run_idx, results_path, start_time, killed] = it->second;
+            const auto wall_time = std::chrono::duration<Float>(std::chrono::steady_clock::now() - start_time).count();
+            records[run_idx] = finish_run(runs[run_idx], results_path, wait_status, killed, wall_time);
+            ++nb_done;
+            println("[{}/{}] {} {} {}: {} {}",
+                    nb_done, runs.size(), runs[run_idx].model, get_base_name(runs[run_idx].instance),
+                    runs[run_idx].method, records[run_idx].get("status"), records[run_idx].get("runtime"));
+            active.erase(it);
+            continue;
+        }
+
+        // Kill runs that do not stop.
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& [pid, run] : active)
+            if (!run.killed && std::chrono::duration<Float>(now - run.start_time).count() > kill_time)
+            {
+                kill(pid, SIGKILL);
+                run.killed = true;
+            }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // Write results.
+    write_results(settings.output, records);
+    println("Wrote results to {}", settings.output);
+    return 0;
+}
+
+static
+Float to_float(const String& str)
+{
+    return str.empty() ? std::numeric_limits<Float>::quiet_NaN() : std::atof(str.c_str());
+}
+
+static
+int compare_results(const String& base_path, const String& new_path, const Float time_tolerance, const Float min_time)
+{
+    // Read results.
+    const auto base_records = read_results(base_path);
+    const auto new_records = read_results(new_path);
+    std::map<String, const Record*> base_runs;
+    for (const auto& record : base_records)
+    {
+        base_runs[record.get("model") + " " + record.get("instance") + " " + record.get("method")] = &record;
+    }
+
+    // Compare.
+    Int nb_compared = 0;
+    Int nb_regressions = 0;
+    Int nb_mismatches = 0;
+    Int nb_improvements = 0;
+    for (const auto& new_record : new_records)
+    {
+        const auto key = new_record.get("model") + " " + new_record.get("instance") + " " + new_record.get("method");
+        const auto it = base_runs.find(key);
+        if (it == base_runs.end())
+            continue;
+        const auto& base_record = *it->second;
+        ++nb_compared;
+
+        const auto& base_status = base_record.get("status");
+        const auto& new_status = new_record.get("status");
+        const auto base_primal = to_float(base_record.get("primal_bound"));
+        const auto new_primal = to_float(new_record.get("primal_bound"));
+        const auto base_dual = to_float(base_record.get("dual_bound"));
+        const auto new_dual = to_float(new_record.get("dual_bound"));
+        const auto base_time = to_float(base_record.get("runtime"));
+        const auto new_time = to_float(new_record.get("runtime"));
+
+        // Check for contradicting results.
+        if ((base_status == "Optimal" && new_status == "Infeasible") ||
+            (base_status == "Infeasible" && new_status == "Optimal") ||
+            (base_status == "Optimal" && new_status == "Optimal" && base_primal != new_primal) ||
+            (new_dual > base_primal) || (base_dual > new_primal))
+        {
+            println("MISMATCH   {}: {} {} -> {} {}", key, base_status, base_primal, new_status, new_primal);
+            ++nb_mismatches;
+            continue;
+        }
+
+        // Check for regressions and improvements.
+        const auto base_solved = base_status == "Optimal" || base_status == "Infeasible";
+        const auto new_solved = new_status == "Optimal" || new_status == "Infeasible";
+        if (base_solved && !new_solved)
+        {
+            println("REGRESSION {}: {} -> {}", key, base_status, new_status);
+            ++nb_regressions;
+        }
+        else if (!base_solved && new_solved)
+        {
+            println("IMPROVED   {}: {} -> {}", key, base_status, new_status);
+            ++nb_improvements;
+        }
+        else if (base_solved && new_solved)
+        {
+            if (new_time > base_time * time_tolerance && new_time - base_time > min_time)
+            {
+                println("REGRESSION {}: runtime {:.2f} -> {:.2f}", key, base_time, new_time);
+                ++nb_regressions;
+            }
+            else if (base_time > new_time * time_tolerance && base_time - new_time > min_time)
+            {
+                println("IMPROVED   {}: runtime {:.2f} -> {:.2f}", key, base_time, new_time);
+                ++nb_improvements;
+            }
+        }
+        else if (new_primal > base_primal || new_dual < base_dual ||
+                 (std::isnan(new_primal) && !std::isnan(base_primal)))
+        {
+            println("REGRESSION {}: bounds [{}, {}] -> [{}, {}]", key, base_dual, base_primal, new_dual, new_primal);
+            ++nb_regressions;
+        }
+        else if (new_primal < base_primal || new_dual > base_dual ||
+                 (!std::isnan(new_primal) && std::isnan(base_primal)))
+        {
+            println("IMPROVED   {}: bounds [{}, {}] -> [{}, {}]", key, base_dual, base_primal, new_dual, new_primal);
+            ++nb_improvements;
+        }
+    }
+
+    // Print summary.
+    println("Compared {} runs: {} regressions, {} improvements, {} mismatches",
+            nb_compared, nb_regressions, nb_improvements, nb_mismatches);
+    return nb_regressions > 0 || nb_mismatches > 0;
+}
+
+int main(int argc, char** argv)
+{
+    // Check.
+    if (argc < 2)
+    {
+        print_usage();
+        return 1;
+    }
+    const String command(argv[1]);
+
+    if (command == "run")
+    {
+        // Read settings.
+        Settings settings;
+        for (int idx = 2; idx < argc; ++idx)
+        {
+            const String arg(argv[idx]);
+            release_assert(idx + 1 < argc, "Missing value for argument {}", arg);
+            const String value(argv[++idx]);
+            if (arg == "--model")
+                settings.models.push_back({value, {}});
+            else if (arg == "--instances")
+            {
+                release_assert(!settings.models.empty(), "--instances must follow --model");
+                settings.models.back().second.push_back(value);
+            }
+            else if (arg == "--method")
+                settings.methods = split(value, ',');
+            else if (arg == "--time-limit")
+                settings.time_limit = std::atof(value.c_str());
+            else if (arg == "--jobs")
+                settings.nb_jobs = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--bin-dir")
+                settings.bin_dir = value;
+            else if (arg == "--log-dir")
+                settings.log_dir = value;
+            else if (arg == "--output")
+                settings.output = value;
+            else
+                err("Invalid argument {}", arg);
+        }
+        release_assert(!settings.models.empty(), "No model is specified");
+
+        // Run.
+        return run_benchmark(settings);
+    }
+    else if (command == "compare")
+    {
+        // Read settings.
+        release_assert(argc >= 4, "Two results files are required");
+        Float time_tolerance = 1.2;
+        Float min_time = 1;
+        for (int idx = 4; idx < argc; ++idx)
+        {
+            const String arg(argv[idx]);
+            release_assert(idx + 1 < argc, "Missing value for argument {}", arg);
+            const String value(argv[++idx]);
+            if (arg == "--time-tolerance")
+                time_tolerance = std::atof(value.c_str());
+            else if (arg == "--min-time")
+                min_time = std::atof(value.c_str());
+            else
+                err("Invalid argument {}", arg);
+        }
+
+        // Compare.
+        return compare_results(argv[2], argv[3], time_tolerance, min_time);
+    }
+    else if (command == "events")
+    {
+        // Print events.
+        release_assert(argc == 3, "A tracer dump is required");
+        for (const auto& record : Tracer::read(argv[2]))
+        {
+            println("{}", Tracer::format(record));
+        }
+        return 0;
+    }
+    else
+    {
+        print_usage();
+        return 1;
+    }
+}
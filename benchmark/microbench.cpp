@@ -0,0 +1,261 @@
+// Microbenchmarks for the hot functions of the constraint handler and model building
+//
+// Each benchmark builds a synthetic model of a given size and repeatedly calls one function,
+// reporting the time and the number of allocations per call.
+
+#include "Nutmeg/Nutmeg.h"
+#include "Nutmeg/ConstraintHandler-Geas.h"
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+using namespace Nutmeg;
+
+#define MIN_BENCHMARK_DURATION                 0.2
+
+// Count allocations.
+static int64_t total_nb_allocs = 0;
+static int64_t total_alloc_bytes = 0;
+
+void* operator new(size_t size)
+{
+    ++total_nb_allocs;
+    total_alloc_bytes += size;
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Timer and allocation counters that can be paused to exclude setup from the measurement
+class State
+{
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start_time_;
+    Float time_{0};
+    int64_t nb_allocs_{0};
+    int64_t nb_alloc_bytes_{0};
+    bool is_running_{false};
+
+  public:
+    inline void resume()
+    {
+        debug_assert(!is_running_);
+        is_running_ = true;
+        nb_allocs_ -= total_nb_allocs;
+        nb_alloc_bytes_ -= total_alloc_bytes;
+        start_time_ = Clock::now();
+    }
+
+    inline void pause()
+    {
+        const auto end_time = Clock::now();
+        debug_assert(is_running_);
+        is_running_ = false;
+        time_ += std::chrono::duration<Float>(end_time - start_time_).count();
+        nb_allocs_ += total_nb_allocs;
+        nb_alloc_bytes_ += total_alloc_bytes;
+    }
+
+    inline Float time() const { return time_; }
+    inline int64_t nb_allocs() const { return nb_allocs_; }
+    inline int64_t nb_alloc_bytes() const { return nb_alloc_bytes_; }
+};
+
+// Repeat a function until the minimum duration is reached and print the cost per call
+template<class Function>
+static
+void run_benchmark(const char* name, const Int size, Function&& function)
+{
+    State state;
+    int64_t nb_ops = 0;
+    while (state.time() < MIN_BENCHMARK_DURATION)
+    {
+        function(state);
+        ++nb_ops;
+    }
+    println("{:<28} {:>8} {:>14.1f} {:>12.1f} {:>14.1f}",
+            name,
+            size,
+            1e9 * state.time() / nb_ops,
+            static_cast<Float>(state.nb_allocs()) / nb_ops,
+            static_cast<Float>(state.nb_alloc_bytes()) / nb_ops);
+}
+
+// Synthetic model with one set partitioning constraint over Boolean variables and one integer
+// variable linked to indicator variables
+struct Fixture
+{
+    Model model;
+    Vector<BoolVar> bool_vars;
+    IntVar int_var;
+    Vector<BoolVar> indicator_vars;
+    SCIP_SOL* sol;
+
+    Fixture(const Int size) : model(Method::BC)
+    {
+        // Create variables.
+        for (Int idx = 0; idx < size; ++idx)
+        {
+            bool_vars.push_back(model.add_bool_var(fmt::format("x[{}]", idx)));
+        }
+        int_var = model.add_int_var(0, size - 1, true, "y");
+        indicator_vars = model.add_indicator_vars(int_var);
+        model.add_constr_set_partition(bool_vars);
+
+        // Create an integral solution of the MIP with the first variable set and the integer
+        // variable at its upper bound.
+        auto& probdata = model.probdata();
+        scip_assert(SCIPcreateOrigSol(model.mip(), &sol, nullptr));
+        for (Int idx = 2; idx < probdata.nb_bool_vars(); ++idx)
+        {
+            const auto mip_var = probdata.mip_bool_vars_[idx];
+            const auto val = mip_var == model.mip_var(bool_vars[0]) ||
+                             mip_var == model.mip_var(indicator_vars.back());
+            scip_assert(SCIPsetSolVal(model.mip(), sol, mip_var, val));
+        }
+        scip_assert(SCIPsetSolVal(model.mip(), sol, model.mip_var(int_var), size - 1));
+        probdata.sol_.bool_vars_sol_.resize(probdata.nb_bool_vars());
+        probdata.sol_.int_vars_sol_.resize(probdata.nb_int_vars());
+    }
+    Fixture(const Fixture&) = delete;
+    Fixture(Fixture&&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+    Fixture& operator=(Fixture&&) = delete;
+
+    ~Fixture()
+    {
+        scip_assert(SCIPfreeSol(model.mip(), &sol));
+    }
+};
+
+int main(int argc, char** argv)
+{
+    // Get sizes.
+    Vector<Int> sizes;
+    for (int idx = 1; idx < argc; ++idx)
+    {
+        sizes.push_back(std::atoi(argv[idx]));
+        release_assert(sizes.back() >= 2, "Model size must be at least 2");
+    }
+    if (sizes.empty())
+    {
+        sizes = {10, 100, 1000, 10000};
+    }
+
+    // Run benchmarks.
+    println("{:<28} {:>8} {:>14} {:>12} {:>14}", "Benchmark", "Size", "ns/op", "allocs/op", "bytes/op");
+    for (const auto size : sizes)
+    {
+        Fixture fixture(size);
+        auto& model = fixture.model;
+        auto& probdata = model.probdata();
+        auto& cp = model.cp();
+        const auto scip = model.mip();
+        const auto sol = fixture.sol;
+
+        run_benchmark("make_bool_assumptions", size, [&](State& state)
+        {
+            state.resume();
+            make_bool_assumptions(scip, sol, probdata, cp);
+            cp.clear_assumptions();
+            state.pause();
+        });
+
+        run_benchmark("make_int_assumptions", size, [&](State& state)
+        {
+            state.resume();
+            make_int_assumptions(scip, sol, probdata, cp);
+            cp.clear_assumptions();
+            state.pause();
+        });
+
+        run_benchmark("make_bounds_assumptions", size, [&](State& state)
+        {
+            state.resume();
+            make_bounds_assumptions(scip, probdata, cp);
+            cp.clear_assumptions();
+            state.pause();
+        });
+
+        run_benchmark("sol_is_fractional", size, [&](State& state)
+        {
+            state.resume();
+            const auto is_fractional = sol_is_fractional(scip, sol, probdata);
+            state.pause();
+            release_assert(!is_fractional, "Solution of fixture is fractional");
+        });
+
+        {
+            // Solve once to have a CP solution to copy.
+            const auto cp_result = cp.solve();
+            release_assert(cp_result == geas::solver::SAT, "Fixture is infeasible");
+            run_benchmark("store_cp_solution", size, [&](State& state)
+            {
+                state.resume();
+                store_cp_solution(probdata, cp);
+                state.pause();
+            });
+            cp.clear_assumptions();
+        }
+
+        {
+            // Assume every Boolean variable is false to get a nogood over all of them.
+            bool is_infeasible = false;
+            for (const auto var : fixture.bool_vars)
+                if (!cp.assume(~model.cp_var(var)))
+                {
+                    is_infeasible = true;
+                    break;
+                }
+            if (!is_infeasible)
+            {
+                is_infeasible = cp.solve() == geas::solver::UNSAT;
+            }
+            release_assert(is_infeasible, "Fixture has no conflict");
+            run_benchmark("get_nogood", size, [&](State& state)
+            {
+                state.resume();
+                const auto nogood = get_nogood(cp, probdata);
+                state.pause();
+                release_assert(!nogood.literals.empty(), "Nogood of fixture is empty");
+            });
+            cp.clear_assumptions();
+        }
+
+        run_benchmark("add_indicator_vars", size, [&](State& state)
+        {
+            Model build_model(Method::BC);
+            const auto var = build_model.add_int_var(0, size - 1, true);
+            state.resume();
+            build_model.add_indicator_vars(var);
+            state.pause();
+        });
+
+        run_benchmark("add_constr_set_partition", size, [&](State& state)
+        {
+            Model build_model(Method::BC);
+            Vector<BoolVar> vars;
+            for (Int idx = 0; idx < size; ++idx)
+            {
+                vars.push_back(build_model.add_bool_var());
+            }
+            state.resume();
+            build_model.add_constr_set_partition(vars);
+            state.pause();
+        });
+    }
+
+    // Done.
+    return 0;
+}
@@ -29,6 +29,13 @@ class InstanceData
     InstanceData(InstanceData&& instance_data) = delete;
     InstanceData operator=(const InstanceData& instance_data) = delete;
     InstanceData operator=(InstanceData&& instance_data) = delete;
+
+    // Members stored in the instance cache
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(P, C, plant_capacity, plant_cost, client_demand, allocation_cost, vehicle_cost, max_distance, distance);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -22,18 +22,25 @@ int main(int argc, char** argv)
     const auto& max_distance = instance.max_distance;
     const auto& distance = instance.distance;
 
-    // Create empty model.
+    // Get solving method.
 #if defined(SOLVE_USING_CP)
-    Model model(Method::CP);
+    auto method = Method::CP;
 #elif defined(SOLVE_USING_MIP)
-    Model model(Method::MIP);
+    auto method = Method::MIP;
 #elif defined(SOLVE_USING_LBBD)
-    Model model(Method::LBBD);
+    auto method = Method::LBBD;
 #elif defined(SOLVE_USING_BC)
-    Model model(Method::BC);
+    auto method = Method::BC;
 #else
     err("Unspecified solving method");
 #endif
+    if (argc >= 4)
+    {
+        method = get_method(argv[3]);
+    }
+
+    // Create empty model.
+    Model model(method);
 
     // Create cost variable.
     Int max_cost = 0;
@@ -43,11 +50,7 @@ int main(int argc, char** argv)
     }
     for (int c = 0; c < C; ++c)
     {
-        Int max_c_cost = 0;
-        for (int p = 0; p < P; ++p)
-            if (allocation_cost(c, p) > max_c_cost)
-                max_c_cost = allocation_cost(c, p);
-        max_cost += max_c_cost;
+        max_cost += std::max(allocation_cost.row_max(c), 0);
     }
     max_cost += C * vehicle_cost;
     IntVar vars_cost = model.add_int_var(0, max_cost, true, "cost");
@@ -133,64 +136,29 @@ int main(int argc, char** argv)
     }
 
     // Create truck distance constraints.
-    // cumulative(truck_number_of_client,
-    //            1,
-    //            [distance[c,p] * [plant_of_client[c] == p] for all c],
-    //            max_distance)
+    // bin_packing(truck_number_of_client,
+    //             [distance[c,p] for all c],
+    //             [plant_of_client[c] == p for all c],
+    //             max_distance,
+    //             trucks_used_at_plant[p])
     for (int p = 0; p < P; ++p)
     {
         Vector<BoolVar> active(C);
-        Vector<IntVar> start(C);
-        Vector<Int> duration(C, 1);
-        Vector<Int> resource(C);
+        Vector<Int> size(C);
         for (int c = 0; c < C; ++c)
         {
             active[c] = vars_client_plant_indicator[c][p];
-            start[c] = vars_truck_number_of_client[c];
-            resource[c] = distance(c, p);
-            release_assert(resource[c] <= max_distance,
-                           "{} {}", resource[c], max_distance);
-        }
-        model.add_constr_cumulative_optional(active,
-                                             start,
-                                             duration,
-                                             resource,
-                                             max_distance);
-    }
-
-    // Create truck distance relaxation.
-    // sum(c in C) (distance[c,p] * [plant_of_client[c] == p]) <= max_distance * trucks_used_at_plant[p]
-    for (int p = 0; p < P; ++p)
-    {
-        Vector<BoolVar> vars(C);
-        Vector<Int> coeffs(C);
-        for (int c = 0; c < C; ++c)
-        {
-            vars[c] = vars_client_plant_indicator[c][p];
-            coeffs[c] = distance(c, p);
+            size[c] = distance(c, p);
+            release_assert(size[c] <= max_distance,
+                           "{} {}", size[c], max_distance);
         }
-
-        model.add_constr_linear(vars,
-                                coeffs,
-                                Sign::LE,
-                                0,
-                                vars_trucks_used_at_plant[p],
-                                max_distance);
+        model.add_constr_bin_packing(vars_truck_number_of_client,
+                                     size,
+                                     active,
+                                     max_distance,
+                                     vars_trucks_used_at_plant[p]);
     }
 
-    // Calculate number of trucks used.
-    // [plant_of_client[c] == p] -> trucks_used_at_plant[p] >= truck_number_of_client[c] + 1
-    // [plant_of_client[c] == p] -> -1 >= truck_number_of_client[c] - trucks_used_at_plant[p]
-    // [plant_of_client[c] == p] -> truck_number_of_client[c] - trucks_used_at_plant[p] <= -1
-    for (int c = 0; c < C; ++c)
-        for (int p = 0; p < P; ++p)
-        {
-            model.add_constr_reify_subtraction_leq(vars_client_plant_indicator[c][p],
-                                                   vars_truck_number_of_client[c],
-                                                   vars_trucks_used_at_plant[p],
-                                                   -1);
-        }
-
     // Add redundant constraint.
     // trucks_used_at_plant[p] <= sum(c in C) ([plant_of_client[c] == p])
     // sum(c in C) ([plant_of_client[c] == p]) >= trucks_used_at_plant[p]
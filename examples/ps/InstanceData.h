@@ -27,6 +27,13 @@ class InstanceData
     InstanceData(InstanceData&& instance_data) = delete;
     InstanceData operator=(const InstanceData& instance_data) = delete;
     InstanceData operator=(InstanceData&& instance_data) = delete;
+
+    // Members stored in the instance cache
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(T, M, cost, duration, resource, release, deadline, capacity);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -20,18 +20,25 @@ int main(int argc, char** argv)
     const auto& deadline = instance.deadline;
     const auto& capacity = instance.capacity;
 
-    // Create empty model.
+    // Get solving method.
 #if defined(SOLVE_USING_CP)
-    Model model(Method::CP);
+    auto method = Method::CP;
 #elif defined(SOLVE_USING_MIP)
-    Model model(Method::MIP);
+    auto method = Method::MIP;
 #elif defined(SOLVE_USING_LBBD)
-    Model model(Method::LBBD);
+    auto method = Method::LBBD;
 #elif defined(SOLVE_USING_BC)
-    Model model(Method::BC);
+    auto method = Method::BC;
 #else
     err("Unspecified solving method");
 #endif
+    if (argc >= 4)
+    {
+        method = get_method(argv[3]);
+    }
+
+    // Create empty model.
+    Model model(method);
     IntVar vars_cost;
     Matrix<BoolVar> vars_job_machine_assignment;
     Matrix<IntVar> vars_start;
@@ -39,22 +46,21 @@ int main(int argc, char** argv)
     // Calculate which assignments don't exceed the job duration.
     Matrix<bool> is_valid(T, M, false);
     for (int t = 0; t < T; ++t)
+    {
+        const auto duration_row = duration.row(t);
         for (int m = 0; m < M; ++m)
         {
             const auto lb = release[t];
-            const auto ub = deadline[t] - duration(t, m);
+            const auto ub = deadline[t] - duration_row[m];
             is_valid(t, m) = lb <= ub;
         }
+    }
 
     // Create cost variable.
     Int max_cost = 0;
     for (int t = 0; t < T; ++t)
     {
-        Int max_t_cost = 0;
-        for (int m = 0; m < M; ++m)
-            if (is_valid(t, m) && cost(t, m) > max_t_cost)
-                max_t_cost = cost(t, m);
-        max_cost += max_t_cost;
+        max_cost += cost.row_max(t, is_valid, 0);
     }
     vars_cost = model.add_int_var(0, max_cost, true, "cost");
 
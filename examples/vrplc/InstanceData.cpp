@@ -1,172 +1,197 @@
 #include "InstanceData.h"
-#include <fstream>
-#include <sstream>
-
-static String trim(String& s)
+#include "Nutmeg/InstanceCache.h"
+#include "Nutmeg/MappedFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+static inline bool is_space(const char c)
 {
-    s.erase(s.begin(),
-            std::find_if(s.begin(), s.end(), [](const char c)
-            {
-                return !std::isspace(c);
-            }));
-
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](const char c)
-            {
-                return !std::isspace(c);
-            }).base(),
-            s.end());
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    return s;
+static std::string_view trim(std::string_view str)
+{
+    while (!str.empty() && is_space(str.front()))
+        str.remove_prefix(1);
+    while (!str.empty() && is_space(str.back()))
+        str.remove_suffix(1);
+    return str;
 }
 
-static inline String fix_instance_name(const String& str)
+static inline String fix_instance_name(const std::string_view str)
 {
-    String instance_name(str);
-    trim(instance_name);
+    String instance_name(trim(str));
     std::replace(instance_name.begin(), instance_name.end(), ' ', '_');
     return instance_name;
 }
 
-static inline Vector<String> read_file(const String& instance_file_path)
+// Get the next line without its line break, returning false at the end of the file
+static inline bool next_line(const char*& p, const char* const end, std::string_view& line)
 {
-    Vector<String> lines;
-
-    // Open the file.
-    std::ifstream f(instance_file_path);
-    if (!f)
+    if (p == end)
     {
-        err("Cannot open instance file {}", instance_file_path);
+        return false;
     }
+    const auto line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    line = std::string_view(p, (line_end ? line_end : end) - p);
+    p = line_end ? line_end + 1 : end;
+    return true;
+}
+
+// Get the next line containing data, returning false at the end of the file
+static inline bool next_nonblank_line(const char*& p, const char* const end, std::string_view& line)
+{
+    while (next_line(p, end, line))
+        if (!trim(line).empty())
+        {
+            return true;
+        }
+    return false;
+}
+
+// Remove the next whitespace-separated token from a line
+static inline std::string_view next_token(std::string_view& line)
+{
+    size_t begin = 0;
+    while (begin < line.size() && is_space(line[begin]))
+        ++begin;
+    size_t end = begin;
+    while (end < line.size() && !is_space(line[end]))
+        ++end;
+    const auto token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
 
-    // Read the file.
+// Split a line into a fixed number of tokens, returning the number of tokens found
+template<size_t n>
+static inline size_t split_line(std::string_view line, std::string_view (&tokens)[n])
+{
+    size_t nb_tokens = 0;
+    for (; nb_tokens < n; ++nb_tokens)
     {
-        String line;
-        while (std::getline(f, line))
-            lines.push_back(line);
+        tokens[nb_tokens] = next_token(line);
+        if (tokens[nb_tokens].empty())
+        {
+            break;
+        }
     }
+    return nb_tokens;
+}
 
-    // Return.
-    return lines;
+static inline Int parse_int(const std::string_view token, const String& instance_file_path)
+{
+    Int value = 0;
+    const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (ec != std::errc() || ptr != token.data() + token.size())
+    {
+        err("Data file {} has invalid number {}", instance_file_path, token);
+    }
+    return value;
 }
 
-static inline Vector<String> split_string(const String& input, const char delim)
+// Find a column in the heading row of a table
+template<size_t n>
+static inline size_t find_column(const std::string_view (&heading)[n], const char* name)
 {
-    Vector<String> array_of_strings;
+    const auto index = std::find(heading, heading + n, name);
+    if (index == heading + n)
     {
-        std::stringstream ss(input);
-        String token;
-        while (std::getline(ss, token, delim))
-            array_of_strings.push_back(token);
+        err("Cannot find {} column in instance file", name);
     }
-    return array_of_strings;
+    return index - heading;
 }
 
 InstanceData::InstanceData(const String& instance_file_path)
 {
-    // Read the file.
-    Vector<String> lines = read_file(instance_file_path);
-    size_t i = 0;
+    // Load the binary cache of the instance if it is up to date.
+    InstanceCache cache(instance_file_path, "vrplc", 1);
+    if (cache.load(*this))
+    {
+        return;
+    }
+
+    // Map the file.
+    const MappedFile file(instance_file_path);
+    auto p = file.begin();
+    const auto end = file.end();
+    std::string_view line;
 
     // Read parameters.
     Time T = 0;
     {
         // Go to the first line with data.
-        while (i < lines.size() && lines[i].length() == 0)
-            ++i;
-        if (i == lines.size())
+        if (!next_nonblank_line(p, end, line))
         {
             err("Data file {} is empty", instance_file_path);
         }
 
         // Read parameters.
-        for (; i < lines.size() && lines[i].length() > 0; i++)
+        do
         {
             // Split the string into parameter name and value.
-            Vector<String> str = split_string(lines[i], ':');
-            if (str.size() != 2)
+            const auto colon = line.find(':');
+            if (colon == std::string_view::npos || line.find(':', colon + 1) != std::string_view::npos)
             {
                 err("Data file {} has invalid parameters section (multiple colons)", instance_file_path);
             }
+            const auto name = trim(line.substr(0, colon));
+            const auto value = trim(line.substr(colon + 1));
 
             // Read the parameter.
-            if (str[0] == "DataName" || str[0] == "InstanceName")
+            if (name == "DataName" || name == "InstanceName")
             {
-                instance_name = fix_instance_name(str[1]);
+                instance_name = fix_instance_name(value);
             }
-            else if (str[0] == "T")
+            else if (name == "T")
             {
-                T = atoi(str[1].c_str());
+                T = parse_int(value, instance_file_path);
             }
-            else if (str[0] == "C")
+            else if (name == "C")
             {
-                C = atoi(str[1].c_str());
+                C = parse_int(value, instance_file_path);
             }
-            else if (str[0] == "Q")
+            else if (name == "Q")
             {
-                Q = atoi(str[1].c_str());
+                Q = parse_int(value, instance_file_path);
             }
-            else if (str[0] != "R" && str[0] != "ResourceType")
+            else if (name != "R" && name != "ResourceType")
             {
-                err("Data file {} has unknown parameter {}", instance_file_path, str[0]);
+                err("Data file {} has unknown parameter {}", instance_file_path, name);
             }
         }
+        while (next_line(p, end, line) && !trim(line).empty());
     }
 
     // Read locations.
+    HashTable<std::string_view, LocationNumber> loc_index;
     {
-        // Go to the next line with data.
-        while (lines[i].length() == 0)
-            i++;
-
         // Read locations table heading row.
-        size_t l_col = 0;
-        size_t x_col = 0;
-        size_t y_col = 0;
+        if (!next_nonblank_line(p, end, line))
         {
-            std::stringstream ss(lines[i]);
-
-            Vector<String> vals(3);
-            for (size_t j = 0; ss.good() && j < 3; j++)
-                ss >> vals[j];
-
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "L");
-                if (index == vals.cend())
-                {
-                    err("Cannot find L column in instance file");
-                }
-                l_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "X");
-                if (index == vals.cend())
-                {
-                    err("Cannot find X column in instance file");
-                }
-                x_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "Y");
-                if (index == vals.cend())
-                {
-                    err("Cannot find Y column in instance file");
-                }
-                y_col = index - vals.cbegin();
-            }
+            err("Data file {} has no locations", instance_file_path);
         }
+        std::string_view heading[3];
+        split_line(line, heading);
+        const auto l_col = find_column(heading, "L");
+        const auto x_col = find_column(heading, "X");
+        const auto y_col = find_column(heading, "Y");
 
         // Read locations table.
-        for (i++; i < lines.size() && lines[i].length() > 0; i++)
+        while (next_line(p, end, line) && !trim(line).empty())
         {
-            std::stringstream ss(lines[i]);
-
-            Vector<String> vals(3);
-            for (size_t j = 0; ss.good() && j < 3; j++)
-                ss >> vals[j];
-
-            loc_name.push_back(move(vals[l_col]));
-            loc_x.push_back(atoi(vals[x_col].c_str()));
-            loc_y.push_back(atoi(vals[y_col].c_str()));
+            std::string_view vals[3];
+            if (split_line(line, vals) < 3)
+            {
+                err("Data file {} has an incomplete location {}", instance_file_path, trim(line));
+            }
+            loc_index.emplace(vals[l_col], static_cast<LocationNumber>(loc_name.size()));
+            loc_name.emplace_back(vals[l_col]);
+            loc_x.push_back(parse_int(vals[x_col], instance_file_path));
+            loc_y.push_back(parse_int(vals[y_col], instance_file_path));
         }
     }
     L = static_cast<LocationNumber>(loc_name.size());
@@ -181,96 +206,41 @@ InstanceData::InstanceData(const String& instance_file_path)
         q.emplace_back(0);
     }
     {
-        // Find next line with data.
-        while (lines[i].length() == 0)
-            i++;
-
         // Read requests table heading row.
-        size_t r_col = 0;
-        size_t l_col = 0;
-        size_t a_col = 0;
-        size_t b_col = 0;
-        size_t s_col = 0;
-        size_t q_col = 0;
+        if (!next_nonblank_line(p, end, line))
         {
-            std::stringstream ss(lines[i]);
-
-            Vector<String> vals(6);
-            for (long j = 0; ss.good() && j < 6; j++)
-                ss >> vals[j];
-
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "R");
-                if (index == vals.cend())
-                {
-                    err("Cannot find R column in instance file");
-                }
-                r_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "L");
-                if (index == vals.cend())
-                {
-                    err("Cannot find L column in instance file");
-                }
-                l_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "A");
-                if (index == vals.cend())
-                {
-                    err("Cannot find A column in instance file");
-                }
-                a_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "B");
-                if (index == vals.cend())
-                {
-                    err("Cannot find B column in instance file");
-                }
-                b_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "S");
-                if (index == vals.cend())
-                {
-                    err("Cannot find S column in instance file");
-                }
-                s_col = index - vals.cbegin();
-            }
-            {
-                const auto index = find(vals.cbegin(), vals.cend(), "Q");
-                if (index == vals.cend())
-                {
-                    err("Cannot find Q column in instance file");
-                }
-                q_col = index - vals.cbegin();
-            }
+            err("Data file {} has no requests", instance_file_path);
         }
+        std::string_view heading[6];
+        split_line(line, heading);
+        const auto r_col = find_column(heading, "R");
+        const auto l_col = find_column(heading, "L");
+        const auto a_col = find_column(heading, "A");
+        const auto b_col = find_column(heading, "B");
+        const auto s_col = find_column(heading, "S");
+        const auto q_col = find_column(heading, "Q");
 
         // Read requests table.
-        for (i++; i < lines.size() && lines[i].length() > 0; i++)
+        while (next_line(p, end, line) && !trim(line).empty())
         {
-            std::stringstream ss(lines[i]);
-
-            Vector<String> vals(6);
-            for (long j = 0; ss.good() && j < 6; j++)
-                ss >> vals[j];
+            std::string_view vals[6];
+            if (split_line(line, vals) < 6)
+            {
+                err("Data file {} has an incomplete request {}", instance_file_path, trim(line));
+            }
 
-            r.push_back(move(vals[r_col]));
-            a.push_back(atoi(vals[a_col].c_str()));
-            b.push_back(atoi(vals[b_col].c_str()));
-            s.push_back(atoi(vals[s_col].c_str()));
-            q.push_back(atoi(vals[q_col].c_str()));
+            r.emplace_back(vals[r_col]);
+            a.push_back(parse_int(vals[a_col], instance_file_path));
+            b.push_back(parse_int(vals[b_col], instance_file_path));
+            s.push_back(parse_int(vals[s_col], instance_file_path));
+            q.push_back(parse_int(vals[q_col], instance_file_path));
 
-            const auto index = find(loc_name.cbegin(), loc_name.cend(), vals[l_col]);
-            if (index == loc_name.cend())
+            const auto index = loc_index.find(vals[l_col]);
+            if (index == loc_index.end())
             {
                 err("Request {} has invalid location name {}", r.back(), vals[l_col]);
-
             }
-            l.push_back(static_cast<LocationNumber>(index - loc_name.cbegin()));
+            l.push_back(index->second);
         }
     }
 
@@ -288,51 +258,168 @@ InstanceData::InstanceData(const String& instance_file_path)
     N = static_cast<Request>(r.size());
     R = N - 2;
 
-    // Create cost matrix.
-    cost_matrix = Matrix<Cost>(N, N);
-    for (Request i = 0; i < N; i++)
-        for (Request j = 0; j < N; j++)
+    // Compute the distances between locations, which are symmetric and zero on the diagonal.
+    Matrix<Cost> loc_cost(L, L);
+    for (LocationNumber i = 0; i < L; i++)
+        for (LocationNumber j = 0; j < i; j++)
         {
-            const Float d_x = loc_x[l[i]] - loc_x[l[j]];
-            const Float d_y = loc_y[l[i]] - loc_y[l[j]];
-            cost_matrix(i, j) = ceil(sqrt(d_x * d_x + d_y * d_y));
+            const Float d_x = loc_x[i] - loc_x[j];
+            const Float d_y = loc_y[i] - loc_y[j];
+            loc_cost(i, j) = loc_cost(j, i) = std::ceil(std::sqrt(d_x * d_x + d_y * d_y));
         }
 
-    // Create time matrix.
+    // Create the cost, time and service+travel time matrices in one pass. Self-cycles have zero cost
+    // because a request is at the same location as itself.
+    cost_matrix = Matrix<Cost>(N, N);
     time_matrix = Matrix<Time>(N, N);
+    service_plus_travel_time_matrix = Matrix<Time>(N, N);
     for (Request i = 0; i < N; i++)
+    {
+        const auto loc_cost_row = loc_cost.cbegin(l[i]);
+        auto cost_row = cost_matrix.begin(i);
+        auto time_row = time_matrix.begin(i);
+        auto service_plus_travel_time_row = service_plus_travel_time_matrix.begin(i);
         for (Request j = 0; j < N; j++)
         {
-            time_matrix(i, j) = cost_matrix(i, j);
+            const auto cost = loc_cost_row[l[j]];
+            cost_row[j] = cost;
+            time_row[j] = cost;
+            service_plus_travel_time_row[j] = cost + s[i];
         }
+    }
 
-    // Check self-cycles are zero.
-    for (Request i = 0; i < N; i++)
+    // Tighten time windows.
+    for (Request i = 1; i <= R; ++i)
+    {
+        a[i] = std::max(static_cast<Time>(cost_matrix(0, i)), a[i]);
+        b[i] = std::min(b[R + 1] - static_cast<Time>(cost_matrix(i, R + 1)) - s[i], b[i]);
+    }
+
+    // Write the binary cache for later runs.
+    cache.store(*this);
+}
+
+ArcSet InstanceData::preprocess()
+{
+    // Create the arcs that are feasible on their own.
+    std::vector<std::pair<size_t, size_t>> arcs_list;
+    for (Request i = 0; i <= R; ++i)
+    {
+        const auto cost_row = cost_matrix.row(i);
+        const auto earliest_departure = a[i] + s[i];
+        for (Request j = 1; j <= R + 1; ++j)
+            if (!(i == 0 && j == R + 1) &&
+                i != j &&
+                earliest_departure + cost_row[j] <= b[j] &&
+                q[i] + q[j] <= Q)
+            {
+                arcs_list.emplace_back(i, j);
+            }
+    }
+    const auto nb_initial_arcs = arcs_list.size();
+    const auto initial_a = a;
+    const auto initial_b = b;
+
+    // Propagate the earliest and latest start times and the smallest and largest loads along the arcs until
+    // nothing changes. A request starts no earlier than its earliest predecessor allows and no later than
+    // its latest successor allows, and an arc is removed if it cannot be used with these bounds.
+    Vector<Load> min_load(N);
+    Vector<Load> max_load(N, Q);
+    for (Request i = 0; i < N; ++i)
     {
-        if (cost_matrix(i, i) != 0)
+        min_load[i] = std::abs(q[i]);
+    }
+    max_load[0] = 0;
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        const ArcSet arcs(N, arcs_list);
+
+        // Tighten the bounds from the predecessors.
+        for (Request j = 1; j < N; ++j)
         {
-            err("Arc ({},{}) has positive cost {:.2f}", i, i, cost_matrix(i, i));
+            const auto in_tails = arcs.in_tails(j);
+            if (in_tails.empty())
+            {
+                continue;
+            }
+            auto earliest = std::numeric_limits<Time>::max();
+            auto smallest = std::numeric_limits<Load>::max();
+            for (const auto i : in_tails)
+            {
+                earliest = std::min(earliest, a[i] + s[i] + cost_matrix(i, j));
+                smallest = std::min(smallest, min_load[i] + std::abs(q[j]));
+            }
+            if (earliest > a[j])
+            {
+                a[j] = earliest;
+                changed = true;
+            }
+            if (smallest > min_load[j])
+            {
+                min_load[j] = smallest;
+                changed = true;
+            }
         }
-        if (time_matrix(i, i) != 0)
+
+        // Tighten the bounds from the successors.
+        for (Request i = 0; i <= R; ++i)
         {
-            err("Arc ({},{}) has positive cost {:.2f}", i, i, cost_matrix(i, i));
+            const auto out_heads = arcs.out_heads(i);
+            if (out_heads.empty())
+            {
+                continue;
+            }
+            auto latest = std::numeric_limits<Time>::min();
+            auto largest = std::numeric_limits<Load>::min();
+            for (const auto j : out_heads)
+            {
+                latest = std::max(latest, b[j] - s[i] - cost_matrix(i, j));
+                largest = std::max(largest, max_load[j] - std::abs(q[j]));
+            }
+            if (latest < b[i])
+            {
+                b[i] = latest;
+                changed = true;
+            }
+            if (largest < max_load[i])
+            {
+                max_load[i] = largest;
+                changed = true;
+            }
         }
-    }
 
-    // Create service+travel time matrix.
-    service_plus_travel_time_matrix = time_matrix;
-    for (Request i = 0; i < N; i++)
-        for (Request j = 0; j < N; j++)
+        // Check.
+        for (Request i = 0; i < N; ++i)
         {
-            service_plus_travel_time_matrix(i, j) += s[i];
+            release_assert(a[i] <= b[i] && min_load[i] <= max_load[i],
+                           "Request {} cannot be visited on any feasible route", r[i]);
         }
 
-    // Tighten time windows.
-    for (Request i = 1; i <= R; ++i)
+        // Remove the arcs that cannot be used.
+        const auto nb_arcs = arcs_list.size();
+        arcs_list.erase(std::remove_if(arcs_list.begin(), arcs_list.end(),
+                                       [&](const std::pair<size_t, size_t>& arc)
+                                       {
+                                           const auto [i, j] = arc;
+                                           return a[i] + s[i] + cost_matrix(i, j) > b[j] ||
+                                                  min_load[i] + std::abs(q[j]) > max_load[j];
+                                       }),
+                        arcs_list.end());
+        changed |= arcs_list.size() < nb_arcs;
+    }
+
+    // Print.
+    Request nb_tightened = 0;
+    for (Request i = 0; i < N; ++i)
     {
-        a[i] = std::max(static_cast<Time>(cost_matrix(0, i)), a[i]);
-        b[i] = std::min(b[R + 1] - static_cast<Time>(cost_matrix(i, R + 1)) - s[i], b[i]);
+        nb_tightened += a[i] != initial_a[i] || b[i] != initial_b[i];
     }
+    println("Preprocessing removed {} of {} arcs and tightened {} time windows",
+            nb_initial_arcs - arcs_list.size(), nb_initial_arcs, nb_tightened);
+
+    // Done.
+    return ArcSet(N, std::move(arcs_list));
 }
 
 void InstanceData::print() const
@@ -3,6 +3,7 @@
 
 #include "Nutmeg/Includes.h"
 #include "Nutmeg/Matrix.h"
+#include "Nutmeg/ArcMatrix.h"
 
 using namespace Nutmeg;
 
@@ -46,6 +47,18 @@ class InstanceData
     InstanceData operator=(const InstanceData& instance_data) = delete;
     InstanceData operator=(InstanceData&& instance_data) = delete;
 
+    // Members stored in the instance cache
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(instance_name, Q, L, C, loc_name, loc_x, loc_y, N, R, cost_matrix, time_matrix,
+                service_plus_travel_time_matrix, r, l, a, b, s, q);
+    }
+
+    // Remove the arcs that cannot be in a feasible route and tighten the time windows, returning the
+    // remaining arcs
+    ArcSet preprocess();
+
     // Print
     void print() const;
 };
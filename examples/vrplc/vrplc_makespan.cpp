@@ -5,7 +5,7 @@ int main(int argc, char** argv)
 {
     // Read instance.
     release_assert(argc >= 2, "Path to instance must be second argument");
-    const InstanceData instance(argv[1]);
+    InstanceData instance(argv[1]);
 
     // Get time limit.
     const auto time_limit = argc >= 3 ? std::atof(argv[2]) : Infinity;
@@ -17,43 +17,34 @@ int main(int argc, char** argv)
     const auto Q = instance.Q;
     const auto& cost = instance.cost_matrix;
 
-    // Create empty model.
+    // Get solving method.
 #if defined(SOLVE_USING_CP)
-    Model model(Method::CP);
+    auto method = Method::CP;
 #elif defined(SOLVE_USING_MIP)
-    Model model(Method::MIP);
+    auto method = Method::MIP;
 #elif defined(SOLVE_USING_LBBD)
-    Model model(Method::LBBD);
+    auto method = Method::LBBD;
 #elif defined(SOLVE_USING_BC)
-    Model model(Method::BC);
+    auto method = Method::BC;
 #else
     err("Unspecified solving method");
 #endif
-    Matrix<BoolVar> vars_x;
+    if (argc >= 4)
+    {
+        method = get_method(argv[3]);
+    }
+
+    // Create empty model.
+    Model model(method);
+    ArcMatrix<BoolVar> vars_x;
     Vector<IntVar> vars_start;
     Vector<IntVar> vars_capacity;
 
-    // Calculate which edges are valid.
-    Matrix<bool> is_valid(N, N, false);
-    for (int i = 0; i <= R; ++i)
-        for (int j = 1; j <= R + 1; ++j)
-        {
-            is_valid(i, j) =
-                !(i == 0 && j == R + 1) &&
-                i != j &&
-                instance.a[i] + instance.s[i] + cost(i, j) <= instance.b[j] &&
-                instance.q[i] + instance.q[j] <= Q;
-        }
+    // Calculate which edges are valid and tighten the time windows.
+    const auto arcs = instance.preprocess();
 
     // Create edge variables.
-    vars_x.clear_and_resize(N, N);
-    for (int i = 0; i <= R; ++i)
-        for (int j = 1; j <= R + 1; ++j)
-            if (is_valid(i, j))
-            {
-                const auto name = fmt::format("x[{},{}]", i, j);
-                vars_x(i, j) = model.add_bool_var(name);
-            }
+    vars_x = model.add_arc_vars(arcs, "x");
 
     // Create start time variables.
     vars_start.resize(N);
@@ -80,55 +71,44 @@ int main(int argc, char** argv)
     }
 
     // Create connectivity constraints.
-    for (int i = 1; i <= R; ++i)
-    {
-        Vector<BoolVar> vars;
-        for (int j = 1; j <= R + 1; ++j)
-            if (is_valid(i, j))
-                vars.push_back(vars_x(i, j));
-        if (!vars.empty())
-        {
-            model.add_constr_set_partition(vars);
-        }
-    }
-    for (int i = 1; i <= R; ++i)
-    {
-        Vector<BoolVar> vars;
-        for (int h = 0; h <= R; ++h)
-            if (is_valid(h, i))
-                vars.push_back(vars_x(h, i));
-        if (!vars.empty())
-        {
-            model.add_constr_set_partition(vars);
-        }
-    }
+    model.add_constr_paths(vars_x, 0, R + 1);
 
     // Create time successor constraints.
     // x[i,j] -> start[i] + s[i] + cost[i,j] <= start[j]
     // x[i,j] -> start[i] - start[j] <= -s[i] - cost[i,j])
-    for (int i = 0; i <= R; ++i)
-        for (int j = 1; j <= R + 1; ++j)
-            if (is_valid(i, j))
-            {
-                model.add_constr_reify_subtraction_leq(vars_x(i, j),
-                                                       vars_start[i],
-                                                       vars_start[j],
-                                                       -instance.s[i] - cost(i, j));
-            }
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        const auto i = arcs.tail(a);
+        const auto j = arcs.head(a);
+        model.add_constr_reify_subtraction_leq(vars_x[a],
+                                               vars_start[i],
+                                               vars_start[j],
+                                               -instance.s[i] - cost(i, j));
+    }
 
     // Create vehicle capacity successor constraints.
     // x[i,j] -> capacity[i] + q[j] <= capacity[j]
     // x[i,j] -> capacity[i] - capacity[j] <= -q[j]
-    for (int i = 0; i <= R; ++i)
-        for (int j = 1; j <= R + 1; ++j)
-            if (is_valid(i, j))
-            {
-                const auto q = std::abs(instance.q[j]);
-                model.add_constr_reify_subtraction_leq(vars_x(i, j),
-                                                       vars_capacity[i],
-                                                       vars_capacity[j],
-                                                       -q);
-            }
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        const auto i = arcs.tail(a);
+        const auto j = arcs.head(a);
+        const auto q = std::abs(instance.q[j]);
+        model.add_constr_reify_subtraction_leq(vars_x[a],
+                                               vars_capacity[i],
+                                               vars_capacity[j],
+                                               -q);
+    }
+
+    // Separate subtour elimination and rounded capacity cuts in the MIP.
+    {
+        Vector<Int> demand(N);
+        for (int i = 0; i < N; ++i)
+        {
+            demand[i] = std::abs(instance.q[i]);
+        }
+        model.add_routing_cuts(vars_x, demand, Q, 0, R + 1);
+    }
 
     // Create scheduling constraints in CP.
     for (int l = 1; l <= L; ++l)
@@ -162,12 +142,11 @@ int main(int argc, char** argv)
         println("LB: {}", model.get_dual_bound());
         println("UB: {}", model.get_primal_bound());
 
-        for (int i = 0; i <= R; ++i)
-            for (int j = 1; j <= R + 1; ++j)
-                if (is_valid(i, j) && model.get_sol(vars_x(i, j)))
-                {
-                    println("{} -> {}", i, j);
-                }
+        for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+            if (model.get_sol(vars_x[a]))
+            {
+                println("{} -> {}", arcs.tail(a), arcs.head(a));
+            }
 
         for (int i = 1; i <= R; ++i)
         {
@@ -0,0 +1,81 @@
+#include "Nutmeg/Nutmeg.h"
+#include "Nutmeg/FlatZinc.h"
+
+using namespace Nutmeg;
+
+int main(int argc, char** argv)
+{
+    // Read options.
+    bool all_solutions = false;
+    bool statistics = false;
+    bool verbose = false;
+    Float time_limit = Infinity;
+    auto method = Method::BC;
+    String path;
+    for (int idx = 1; idx < argc; ++idx)
+    {
+        const String arg(argv[idx]);
+        if (arg == "-a")
+        {
+            all_solutions = true;
+        }
+        else if (arg == "-s")
+        {
+            statistics = true;
+        }
+        else if (arg == "-v")
+        {
+            verbose = true;
+        }
+        else if (arg == "-t" && idx + 1 < argc)
+        {
+            time_limit = std::atof(argv[++idx]) / 1000.0;
+        }
+        else if (arg == "--method" && idx + 1 < argc)
+        {
+            method = get_method(argv[++idx]);
+        }
+        else if (path.empty() && !arg.empty() && arg[0] != '-')
+        {
+            path = arg;
+        }
+        else
+        {
+            err("Invalid argument {}", arg);
+        }
+    }
+    release_assert(!path.empty(), "Usage: fzn [-a] [-s] [-v] [-t milliseconds] [--method name] model.fzn");
+
+    // Read model.
+    Model model(method);
+    FlatZincModel fzn(model);
+    fzn.read(path);
+
+    // Print intermediate solutions.
+    if (all_solutions)
+    {
+        model.add_print_new_solution_function([&fzn]() { fzn.print_solution(); });
+    }
+
+    // Solve.
+    const auto start_time = clock();
+    fzn.solve(time_limit, verbose);
+    const auto solve_time = get_elapsed_time(start_time);
+
+    // Print the final solution and status.
+    const auto status = model.get_status();
+    if (!all_solutions && (status == Status::Optimal || status == Status::Feasible))
+    {
+        fzn.print_solution();
+    }
+    fzn.print_status();
+
+    // Print statistics.
+    if (statistics)
+    {
+        fzn.print_statistics(solve_time);
+    }
+
+    // Done.
+    return 0;
+}
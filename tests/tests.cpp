@@ -0,0 +1,397 @@
+// Tests of the data structures, the loaders of instance files and the transfer of nogoods between solves
+//
+// Each test is selected by its name on the command line and aborts with a message on the first failed check.
+// Files are created in the working directory and removed after the test.
+
+#include "Nutmeg/Nutmeg.h"
+#include "Nutmeg/DznReader.h"
+#include "Nutmeg/InstanceCache.h"
+#include "Nutmeg/FlatZinc.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+using namespace Nutmeg;
+
+#define SCHEDULING_OPTIMAL_MAKESPAN                     10
+
+// Write a file
+static
+void write_file(const String& path, const String& text)
+{
+    std::ofstream file(path, std::ios::trunc);
+    file << text;
+    release_assert(file, "Cannot write test file {}", path);
+}
+
+// Bit matrix
+static
+void test_matrix_bool()
+{
+    // Use more columns than one word holds.
+    Matrix<bool> matrix(3, 70);
+    release_assert(matrix.rows() == 3 && matrix.cols() == 70 && matrix.words_per_row() == 2, "Wrong dimensions");
+    release_assert(matrix.count() == 0, "New matrix is not empty");
+
+    // Set bits on both sides of the word boundary.
+    matrix(0, 1) = true;
+    matrix(0, 63) = true;
+    matrix(0, 64) = true;
+    matrix(2, 69) = true;
+    release_assert(matrix(0, 63) && matrix(0, 64) && !matrix(0, 62), "Bits are not set");
+    release_assert(matrix.count() == 4 && matrix.row_count(0) == 3, "Wrong count of set bits");
+    release_assert(matrix.row_any(0) && !matrix.row_any(1) && matrix.row_any(2), "Wrong rows with set bits");
+    Vector<size_t> cols;
+    for (const auto j : matrix.row_bits(0))
+    {
+        cols.push_back(j);
+    }
+    release_assert(cols == Vector<size_t>({1, 63, 64}), "Set bits are not iterated in order");
+    matrix(0, 63) = false;
+    release_assert(!matrix(0, 63) && matrix.row_count(0) == 2, "Bit is not cleared");
+
+    // Fill without setting the bits past the last column.
+    Matrix<bool> full(2, 70, true);
+    release_assert(full.count() == 140, "Filled matrix sets bits past the last column");
+    full = false;
+    release_assert(full.count() == 0, "Matrix is not cleared");
+
+    // Combine rows and matrices.
+    Matrix<bool> other(3, 70);
+    other(0, 1) = true;
+    other(1, 5) = true;
+    auto combined = matrix;
+    combined.row_and(0, other, 0);
+    release_assert(combined.row_count(0) == 1 && combined(0, 1), "Wrong intersection of rows");
+    combined.row_or(1, other, 1);
+    release_assert(combined(1, 5), "Wrong union of rows");
+    combined.row_and_not(1, other, 1);
+    release_assert(!combined.row_any(1), "Wrong difference of rows");
+    combined = matrix;
+    combined |= other;
+    release_assert(combined.count() == 4 && combined(1, 5), "Wrong union of matrices");
+    combined &= other;
+    release_assert(combined == other, "Wrong intersection of matrices");
+
+    // Transpose.
+    const auto transpose = matrix.transpose();
+    release_assert(transpose.rows() == 70 && transpose.cols() == 3, "Wrong dimensions of transpose");
+    release_assert(transpose(1, 0) && transpose(64, 0) && transpose(69, 2) && transpose.count() == matrix.count(),
+                   "Wrong transpose");
+}
+
+// Arc set and values on arcs
+static
+void test_arc_matrix()
+{
+    static_assert(!std::is_constructible_v<ArcMatrix<Int>, ArcSet&&>,
+                  "ArcMatrix must not keep a pointer to a temporary arc set");
+
+    // Create arcs with a duplicate and out of order.
+    const ArcSet arcs(4, {{2, 0}, {0, 1}, {0, 3}, {1, 2}, {0, 1}, {3, 2}});
+    release_assert(arcs.nb_nodes() == 4 && arcs.nb_arcs() == 5, "Wrong number of arcs");
+    release_assert(arcs.out_degree(0) == 2 && arcs.out_degree(1) == 1 && arcs.in_degree(2) == 2,
+                   "Wrong degrees");
+    release_assert(arcs.out_heads(0)[0] == 1 && arcs.out_heads(0)[1] == 3, "Outgoing arcs are not sorted");
+    release_assert(arcs.in_tails(2)[0] == 1 && arcs.in_tails(2)[1] == 3, "Wrong incoming arcs");
+    for (size_t a = 0; a < arcs.nb_arcs(); ++a)
+    {
+        release_assert(arcs.find(arcs.tail(a), arcs.head(a)) == a, "Arc {} is not found", a);
+    }
+    release_assert(arcs.contains(3, 2) && !arcs.contains(2, 3) && arcs.find(1, 1) == ArcSet::npos,
+                   "Wrong arcs found");
+
+    // Create the same arcs from an adjacency matrix.
+    Matrix<bool> is_arc(4, 4);
+    is_arc(0, 1) = true;
+    is_arc(0, 3) = true;
+    is_arc(1, 2) = true;
+    is_arc(2, 0) = true;
+    is_arc(3, 2) = true;
+    release_assert(ArcSet(is_arc) == arcs, "Arcs from an adjacency matrix are different");
+
+    // Store values on the arcs.
+    ArcMatrix<Int> values(arcs, -1);
+    release_assert(values.size() == arcs.nb_arcs() && &values.arcs() == &arcs, "Wrong size of values");
+    values(0, 3) = 7;
+    values(3, 2) = 9;
+    release_assert(values[arcs.find(0, 3)] == 7 && values(3, 2) == 9 && values(1, 2) == -1, "Wrong values");
+    const auto out = values.out(0);
+    release_assert(out.size() == 2 && out[0] == -1 && out[1] == 7, "Wrong values of outgoing arcs");
+
+    // Reset.
+    const ArcSet other_arcs(2, {{0, 1}});
+    values.clear_and_resize(other_arcs, 3);
+    release_assert(values.size() == 1 && values(0, 1) == 3, "Values are not reset");
+}
+
+// Reader of MiniZinc data files
+static
+void test_dzn_reader()
+{
+    const String path = "nutmeg_test.dzn";
+    write_file(path,
+               "% Instance\n"
+               "n = 3;\n"
+               "weights = [4, -2, +7]; % Trailing comment\n"
+               "ratio = 2.5;\n"
+               "flag = true;\n"
+               "flags = array1d(1..2, [false, true]);\n"
+               "name = \"a;b\";\n"
+               "cost = [| 1, 2, 3\n"
+               "        | 4, 5, 6 |];\n"
+               "grid = array2d(1..2, 0..1, [7, 8, 9, 10]);\n"
+               "empty = [];\n");
+    {
+        const DznReader dzn(path);
+        release_assert(dzn.contains("n") && dzn.contains("name") && !dzn.contains("m"), "Wrong parameters");
+        release_assert(dzn.read_scalar<Int>("n") == 3, "Wrong integer");
+        release_assert(dzn.read_scalar<Float>("ratio") == 2.5, "Wrong float");
+        release_assert(dzn.read_scalar<bool>("flag"), "Wrong Boolean");
+        release_assert(dzn.read_array<Int>("weights") == Vector<Int>({4, -2, 7}), "Wrong array");
+        release_assert(dzn.read_array<Int>("weights", 3) == Vector<Int>({4, -2, 7}), "Wrong array of given size");
+        release_assert(dzn.read_array<bool>("flags") == Vector<bool>({false, true}), "Wrong array1d");
+        release_assert(dzn.read_array<Int>("empty").empty(), "Wrong empty array");
+
+        Matrix<Int> cost(2, 3);
+        cost(0, 0) = 1;
+        cost(0, 1) = 2;
+        cost(0, 2) = 3;
+        cost(1, 0) = 4;
+        cost(1, 1) = 5;
+        cost(1, 2) = 6;
+        release_assert(dzn.read_matrix<Int>("cost") == cost, "Wrong matrix");
+        release_assert(dzn.read_matrix<Int>("cost", 2, 3) == cost, "Wrong matrix of given dimensions");
+
+        const auto grid = dzn.read_matrix<Int>("grid");
+        release_assert(grid.rows() == 2 && grid.cols() == 2, "Wrong dimensions of array2d");
+        release_assert(grid(0, 0) == 7 && grid(0, 1) == 8 && grid(1, 0) == 9 && grid(1, 1) == 10, "Wrong array2d");
+    }
+    std::remove(path.c_str());
+}
+
+// Data of an instance stored in the instance cache
+struct CacheData
+{
+    Int n{0};
+    Float ratio{0};
+    String name;
+    Vector<Int> weights;
+    Vector<String> labels;
+    Matrix<Int> cost;
+
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(n, ratio, name, weights, labels, cost);
+    }
+};
+
+// Binary cache of instances
+static
+void test_instance_cache()
+{
+    const String path = "nutmeg_test_instance.txt";
+    const String cache_path = path + ".cache";
+    ::unsetenv("NUTMEG_INSTANCE_CACHE");
+    write_file(path, "instance\n");
+    std::remove(cache_path.c_str());
+
+    // Fill with a matrix whose rows are padded.
+    CacheData data;
+    data.n = 5;
+    data.ratio = 0.25;
+    data.name = "instance";
+    data.weights = {3, -1, 4, 1, 5};
+    data.labels = {"a", "", "bc"};
+    data.cost.clear_and_resize(3, 5);
+    for (size_t i = 0; i < data.cost.rows(); ++i)
+        for (size_t j = 0; j < data.cost.cols(); ++j)
+        {
+            data.cost(i, j) = static_cast<Int>(10 * i + j);
+        }
+
+    // Round-trip.
+    {
+        InstanceCache cache(path, "test", 1);
+        CacheData loaded;
+        release_assert(!cache.load(loaded), "Cache is loaded before it is stored");
+        cache.store(data);
+    }
+    {
+        InstanceCache cache(path, "test", 1);
+        CacheData loaded;
+        release_assert(cache.load(loaded), "Cache is not loaded");
+        release_assert(loaded.n == data.n && loaded.ratio == data.ratio && loaded.name == data.name &&
+                       loaded.weights == data.weights && loaded.labels == data.labels && loaded.cost == data.cost,
+                       "Cache has different data");
+    }
+
+    // Reject caches of other tags and versions.
+    {
+        CacheData loaded;
+        release_assert(!InstanceCache(path, "other", 1).load(loaded), "Cache of another tag is loaded");
+        release_assert(!InstanceCache(path, "test", 2).load(loaded), "Cache of another version is loaded");
+    }
+
+    // Reject the cache of a changed instance.
+    write_file(path, "changed instance\n");
+    {
+        CacheData loaded;
+        release_assert(!InstanceCache(path, "test", 1).load(loaded), "Cache of a changed instance is loaded");
+    }
+
+    // Disable the cache.
+    std::remove(cache_path.c_str());
+    ::setenv("NUTMEG_INSTANCE_CACHE", "0", 1);
+    {
+        InstanceCache cache(path, "test", 1);
+        cache.store(data);
+        CacheData loaded;
+        release_assert(!cache.load(loaded), "Disabled cache is loaded");
+    }
+    ::unsetenv("NUTMEG_INSTANCE_CACHE");
+    std::remove(path.c_str());
+}
+
+// FlatZinc front end
+static
+void test_flatzinc()
+{
+    const String path = "nutmeg_test.fzn";
+
+    // Read and solve a model with a sparse domain, an unbounded variable and global constraints.
+    write_file(path,
+               "array [1..2] of int: coeffs = [1, 1];\n"
+               "var {1, 3, 5, 6}: x :: output_var;\n"
+               "var 0..3: y :: output_var;\n"
+               "var int: z :: output_var;\n"
+               "array [1..2] of var int: xy :: output_array([1..2]) = [x, y];\n"
+               "constraint int_lin_eq(coeffs, xy, 7);\n"
+               "constraint int_le(y, z);\n"
+               "constraint fzn_all_different_int([x, y, z]);\n"
+               "solve minimize z;\n");
+    {
+        Model model(Method::BC);
+        FlatZincModel fzn(model);
+        fzn.read(path);
+        release_assert(fzn.nb_constraints() == 3, "Read {} constraints instead of 3", fzn.nb_constraints());
+        fzn.solve(Infinity, false);
+        release_assert(model.get_status() == Status::Optimal, "Model is not solved to optimality");
+        release_assert(model.get_primal_bound() == 2, "Objective value is {} instead of 2", model.get_primal_bound());
+    }
+
+    // Exclude the only feasible value through a hole in the domain.
+    write_file(path,
+               "var {1, 3}: x :: output_var;\n"
+               "constraint int_eq(x, 2);\n"
+               "solve satisfy;\n");
+    {
+        Model model(Method::BC);
+        FlatZincModel fzn(model);
+        fzn.read(path);
+        fzn.solve(Infinity, false);
+        release_assert(model.get_status() == Status::Infeasible, "Value outside of the domain is feasible");
+    }
+    std::remove(path.c_str());
+}
+
+// Scheduling model whose disjunctive constraint is only checked in CP so that the search learns nogoods
+static
+IntVar create_scheduling_model(Model& model)
+{
+    const Vector<Int> duration{3, 2, 4, 1};
+    const auto makespan = model.add_int_var(0, 30, true, "makespan");
+    model.set_var_key(makespan, "makespan");
+    Vector<IntVar> start;
+    for (size_t i = 0; i < duration.size(); ++i)
+    {
+        start.push_back(model.add_int_var(0, 20, true, fmt::format("start[{}]", i)));
+        model.set_var_key(start.back(), fmt::format("start[{}]", i));
+        model.add_constr_linear({start.back(), makespan}, {1, -1}, Sign::LE, -duration[i]);
+    }
+    model.add_constr_disjunctive(start, duration);
+    return makespan;
+}
+
+// Checkpoint of a solve resumed by another solve
+static
+void test_checkpoint()
+{
+    const String path = "nutmeg_test.checkpoint";
+    {
+        Model model(Method::BC);
+        const auto makespan = create_scheduling_model(model);
+        model.set_checkpoint(path, Infinity, true);
+        model.minimize(makespan, Infinity, false);
+        release_assert(model.get_status() == Status::Optimal, "Model is not solved to optimality");
+        release_assert(model.get_primal_bound() == SCHEDULING_OPTIMAL_MAKESPAN, "Wrong makespan");
+    }
+    {
+        Model model(Method::BC);
+        const auto makespan = create_scheduling_model(model);
+        model.load_checkpoint(path);
+        model.minimize(makespan, Infinity, false);
+        release_assert(model.get_status() == Status::Optimal, "Resumed model is not solved to optimality");
+        release_assert(model.get_primal_bound() == SCHEDULING_OPTIMAL_MAKESPAN, "Wrong makespan after resuming");
+        release_assert(model.get_dual_bound() == SCHEDULING_OPTIMAL_MAKESPAN, "Wrong dual bound after resuming");
+    }
+    std::remove(path.c_str());
+}
+
+// Cuts exported by a solve and imported by another solve
+static
+void test_cut_transfer()
+{
+    const String path = "nutmeg_test.cuts";
+    Int nb_exported;
+    {
+        Model model(Method::BC);
+        const auto makespan = create_scheduling_model(model);
+        model.set_cuts_export(path);
+        model.minimize(makespan, Infinity, false);
+        release_assert(model.get_status() == Status::Optimal, "Model is not solved to optimality");
+        nb_exported = model.export_cuts(path);
+        release_assert(nb_exported > 0, "No cuts are exported");
+    }
+    {
+        Model model(Method::BC);
+        const auto makespan = create_scheduling_model(model);
+        const auto nb_imported = model.import_cuts(path);
+        release_assert(0 < nb_imported && nb_imported <= nb_exported,
+                       "Imported {} of {} exported cuts", nb_imported, nb_exported);
+        model.minimize(makespan, Infinity, false);
+        release_assert(model.get_status() == Status::Optimal, "Model with imported cuts is not solved to optimality");
+        release_assert(model.get_primal_bound() == SCHEDULING_OPTIMAL_MAKESPAN, "Wrong makespan with imported cuts");
+    }
+    std::remove(path.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    // Get test.
+    release_assert(argc == 2, "Usage: tests name");
+    const String name(argv[1]);
+
+    // Run test.
+    if (name == "matrix_bool")
+        test_matrix_bool();
+    else if (name == "arc_matrix")
+        test_arc_matrix();
+    else if (name == "dzn_reader")
+        test_dzn_reader();
+    else if (name == "instance_cache")
+        test_instance_cache();
+    else if (name == "flatzinc")
+        test_flatzinc();
+    else if (name == "checkpoint")
+        test_checkpoint();
+    else if (name == "cut_transfer")
+        test_cut_transfer();
+    else
+        err("Unknown test {}", name);
+
+    // Done.
+    println("Passed {}", name);
+    return 0;
+}